@@ -3,6 +3,7 @@
 #include <vector>
 #include <queue>
 #include <memory>
+#include <functional>
 
 #include <opencv2/opencv.hpp>
 
@@ -30,11 +31,30 @@ class VideoReader
 
         std::shared_ptr<cv::Mat> GetNextPicture(unsigned streamId);
 
+        /** \brief Seek to the frame frameId (0 is the first frame of the video): the next pictures start at this frame.
+         *  The demuxer seeks to the previous key frame and the frames before frameId are decoded and dropped.
+         *  Return false (and the reader is not moved) if the video does not have the frame rate or the timestamps needed to seek.
+         */
+        bool Seek(unsigned frameId);
+
         unsigned GetNbStream(void) const {return m_videoStreamIds.size();}
 
+        /** \brief Number of threads of the decoders opened after this call (0: libav default) */
+        static void SetNbCodecThreads(int nbThreads) {s_nbCodecThreads = nbThreads;}
+
+        /** Return a matrix of the given size and type, its content is overwritten by the decoder */
+        typedef std::function<cv::Mat(int rows, int cols, int type)> MatAllocator;
+        /** \brief Allocator of the decoded pictures of all the readers (by default a new cv::Mat is allocated for each picture) */
+        static void SetMatAllocator(MatAllocator allocator) {s_matAllocator = std::move(allocator);}
+
+        /** \brief Time (in second) spent by this reader to convert the decoded frames to BGR */
+        double GetConversionTime(void) const {return m_conversionDurationNs*1e-9;}
+
     protected:
 
     private:
+        static int s_nbCodecThreads;
+        static MatAllocator s_matAllocator;
         std::string m_inputPath;
         AVFormatContext* m_fmt_ctx;
         std::vector<unsigned int> m_videoStreamIds;
@@ -44,8 +64,12 @@ class VideoReader
         unsigned m_nbFrames;
         std::vector<bool> m_doneVect;
         std::vector<bool> m_gotOne;
+        //decoded frames with a smaller timestamp are dropped (set by Seek)
+        std::vector<int64_t> m_firstPts;
+        unsigned long long m_conversionDurationNs;
 
         void DecodeNextStep(void);
+        bool IsBeforeSeekTarget(unsigned streamVectId, const AVFrame* frame_ptr) const;
 };
 }
 }
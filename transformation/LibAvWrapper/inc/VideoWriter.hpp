@@ -27,7 +27,9 @@ extern "C"
 #include <exception>
 #include <memory>
 #include <array>
+#include <vector>
 #include <queue>
+#include <stdexcept>
 #include <opencv2/opencv.hpp>
 
 namespace IMT
@@ -49,6 +51,17 @@ namespace LibAv
             template<int nbStreams>
             void Init(std::string codecName, std::array<unsigned, nbStreams>  widthVect, std::array<unsigned, nbStreams> heightVect, unsigned fps, unsigned gop_size, std::array<int, nbStreams> bit_rateVect)
             {
+                Init(codecName, std::vector<unsigned>(widthVect.begin(), widthVect.end()), std::vector<unsigned>(heightVect.begin(), heightVect.end()), fps, gop_size, std::vector<int>(bit_rateVect.begin(), bit_rateVect.end()));
+            }
+
+            /** \brief Same as the templated Init but with a number of streams known only at runtime (the size of the vectors) */
+            void Init(std::string codecName, const std::vector<unsigned>& widthVect, const std::vector<unsigned>& heightVect, unsigned fps, unsigned gop_size, const std::vector<int>& bit_rateVect)
+            {
+                if (heightVect.size() != widthVect.size() || bit_rateVect.size() != widthVect.size())
+                {
+                    throw std::invalid_argument("VideoWriter: the number of widths, heights and bit rates should be the same");
+                }
+                const unsigned nbStreams = widthVect.size();
                 m_codecName = codecName;
                 //av_log_set_level(AV_LOG_DEBUG);
                 PRINT_DEBUG_VideoWrite("Start init video writer")
@@ -132,6 +145,10 @@ namespace LibAv
                     }
                     m_codec_ctx[id]->max_b_frames = 2;
                     m_codec_ctx[id]->refcounted_frames = 1;
+                    if (s_nbCodecThreads > 0)
+                    {
+                        m_codec_ctx[id]->thread_count = s_nbCodecThreads;
+                    }
                     m_vstream[id]->time_base.num = 1;
                     m_vstream[id]->time_base.den = fps;
 
@@ -190,7 +207,22 @@ namespace LibAv
             unsigned GetWidth(int streamId) {return m_codec_ctx[streamId]->width;}
             unsigned GetHeight(int streamId) {return m_codec_ctx[streamId]->height;}
 
+            /** \brief Number of threads of the encoders opened after this call (0: libav default) */
+            static void SetNbCodecThreads(int nbThreads) {s_nbCodecThreads = nbThreads;}
+
+            /** \brief Time (in second) spent by this writer to convert the BGR pictures to the pixel format of the encoders */
+            double GetConversionTime(void) const {return m_conversionDurationNs*1e-9;}
+            /** \brief Size (in bytes) of the packets written by this writer */
+            unsigned long long GetEncodedBytes(void) const {return m_nbEncodedBytes;}
+
+            /** \brief Write the packets of the input videos one after the other in the output video, without decoding them.
+             *  The input videos should have the same streams (same codecs and resolutions) and each one should start with a key frame
+             *  (e.g. videos written by VideoWriters with the same settings). The timestamps of each input are shifted after the end of the previous one.
+             */
+            static void Concatenate(const std::vector<std::string>& inputPaths, const std::string& outputPath);
+
         private:
+            static int s_nbCodecThreads;
             std::string m_outputFileName;
             AVFormatContext* m_fmt_ctx;
             std::vector<AVCodecContext*> m_codec_ctx;
@@ -198,6 +230,8 @@ namespace LibAv
             std::vector<std::queue<AVFrame*>> m_lastFramesQueue;
             unsigned m_pts;
             std::string m_codecName;
+            unsigned long long m_conversionDurationNs;
+            unsigned long long m_nbEncodedBytes;
 
             bool m_isInit;
 
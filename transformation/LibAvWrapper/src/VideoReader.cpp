@@ -1,6 +1,7 @@
 #include "VideoReader.hpp"
 
 #include <iostream>
+#include <chrono>
 #include <Packet.hpp>
 
 #define DEBUG_VideoReader 0
@@ -19,8 +20,11 @@ extern "C"
 
 using namespace IMT::LibAv;
 
+int VideoReader::s_nbCodecThreads = 0;
+VideoReader::MatAllocator VideoReader::s_matAllocator = nullptr;
+
 VideoReader::VideoReader(std::string inputPath): m_inputPath(inputPath), m_fmt_ctx(nullptr), m_videoStreamIds(),
-    m_outputFrames(), m_streamIdToVecId(), m_nbFrames(0), m_doneVect(), m_gotOne()
+    m_outputFrames(), m_streamIdToVecId(), m_nbFrames(0), m_doneVect(), m_gotOne(), m_firstPts(), m_conversionDurationNs(0)
 {
     //ctor
 }
@@ -107,6 +111,10 @@ void VideoReader::Init(unsigned nbFrames)
         if(m_fmt_ctx->streams[i]->codec->codec_type == AVMEDIA_TYPE_VIDEO)
         {
             m_fmt_ctx->streams[i]->codec->refcounted_frames = 1;
+            if (s_nbCodecThreads > 0)
+            {
+                m_fmt_ctx->streams[i]->codec->thread_count = s_nbCodecThreads;
+            }
             m_outputFrames.emplace_back();
             m_streamIdToVecId[i] = m_videoStreamIds.size();
             m_videoStreamIds.push_back(i);
@@ -124,6 +132,49 @@ void VideoReader::Init(unsigned nbFrames)
     }
     m_doneVect = std::vector<bool>(m_outputFrames.size(), false);
     m_gotOne = std::vector<bool>(m_outputFrames.size(), false);
+    m_firstPts = std::vector<int64_t>(m_outputFrames.size(), AV_NOPTS_VALUE);
+}
+
+bool VideoReader::Seek(unsigned frameId)
+{
+    if (m_fmt_ctx == nullptr || m_videoStreamIds.empty())
+    {
+        return false;
+    }
+    std::vector<int64_t> firstPts;
+    for (auto streamId: m_videoStreamIds)
+    {
+        const AVStream* stream = m_fmt_ctx->streams[streamId];
+        AVRational frameRate = stream->avg_frame_rate.num != 0 ? stream->avg_frame_rate : stream->r_frame_rate;
+        if (frameRate.num == 0 || frameRate.den == 0)
+        {
+            std::cout << "Cannot seek in " << m_inputPath << ": unknown frame rate for stream id " << streamId << std::endl;
+            return false;
+        }
+        int64_t startTime = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        firstPts.push_back(startTime + av_rescale_q(frameId, av_inv_q(frameRate), stream->time_base));
+    }
+    //all the video streams are read by the same demuxer: seek with the first one, the other ones drop their frames before the target
+    if (av_seek_frame(m_fmt_ctx, m_videoStreamIds[0], firstPts[0], AVSEEK_FLAG_BACKWARD) < 0)
+    {
+        std::cout << "Cannot seek to the frame " << frameId << " in " << m_inputPath << std::endl;
+        return false;
+    }
+    for (unsigned i = 0; i < m_videoStreamIds.size(); ++i)
+    {
+        avcodec_flush_buffers(m_fmt_ctx->streams[m_videoStreamIds[i]]->codec);
+        m_outputFrames[i] = std::queue<std::shared_ptr<cv::Mat>>();
+    }
+    m_firstPts = std::move(firstPts);
+    m_doneVect = std::vector<bool>(m_outputFrames.size(), false);
+    m_gotOne = std::vector<bool>(m_outputFrames.size(), false);
+    return true;
+}
+
+bool VideoReader::IsBeforeSeekTarget(unsigned streamVectId, const AVFrame* frame_ptr) const
+{
+    return m_firstPts[streamVectId] != AV_NOPTS_VALUE && frame_ptr->best_effort_timestamp != AV_NOPTS_VALUE
+        && frame_ptr->best_effort_timestamp < m_firstPts[streamVectId];
 }
 
 static bool AllDone(const std::vector<bool>& vect)
@@ -136,8 +187,9 @@ static bool AllDone(const std::vector<bool>& vect)
     return r;
 }
 
-static std::shared_ptr<cv::Mat> ToMat(AVCodecContext* codecCtx, AVFrame* frame_ptr)
+static std::shared_ptr<cv::Mat> ToMat(AVCodecContext* codecCtx, AVFrame* frame_ptr, const VideoReader::MatAllocator& matAllocator, unsigned long long& conversionDurationNs)
 {
+    auto conversionStart = std::chrono::steady_clock::now();
     int w = codecCtx->width;
     int h = codecCtx->height;
     struct SwsContext* convert_ctx;
@@ -147,17 +199,13 @@ static std::shared_ptr<cv::Mat> ToMat(AVCodecContext* codecCtx, AVFrame* frame_p
     {
         std::cout << "Cannot initialize the conversion context!" << std::endl;
     }
-    AVFrame* frame_ptr2 = av_frame_alloc();
-    av_image_alloc(frame_ptr2->data, frame_ptr2->linesize, w, h, AV_PIX_FMT_BGR24, 1);
-    sws_scale(convert_ctx, frame_ptr->data, frame_ptr->linesize, 0, h, frame_ptr2->data, frame_ptr2->linesize);
-    cv::Mat mat(codecCtx->height, codecCtx->width, CV_8UC3, frame_ptr2->data[0], frame_ptr2->linesize[0]);
-
-    auto returnMat = std::make_shared<cv::Mat>(mat.clone());
-    av_freep(&frame_ptr2->data[0]);
-    av_frame_unref(frame_ptr2);
-    av_frame_free(&frame_ptr2);
-    mat.release();
+    //the conversion is written directly in the returned matrix
+    auto returnMat = std::make_shared<cv::Mat>(matAllocator ? matAllocator(h, w, CV_8UC3) : cv::Mat(h, w, CV_8UC3));
+    uint8_t* dstData[4] = {returnMat->data, nullptr, nullptr, nullptr};
+    int dstLinesize[4] = {int(returnMat->step), 0, 0, 0};
+    sws_scale(convert_ctx, frame_ptr->data, frame_ptr->linesize, 0, h, dstData, dstLinesize);
     sws_freeContext(convert_ctx);
+    conversionDurationNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-conversionStart).count();
     return returnMat;
 }
 
@@ -189,7 +237,10 @@ void VideoReader::DecodeNextStep(void)
                   {
                       PRINT_DEBUG_VideoReader("Got a frame for streamId " <<streamId)
                       m_gotOne[m_streamIdToVecId[streamId]] = true;
-                      m_outputFrames[m_streamIdToVecId[streamId]].push(ToMat(codecCtx, frame_ptr));
+                      if (!IsBeforeSeekTarget(m_streamIdToVecId[streamId], frame_ptr))
+                      {
+                          m_outputFrames[m_streamIdToVecId[streamId]].push(ToMat(codecCtx, frame_ptr, s_matAllocator, m_conversionDurationNs));
+                      }
                       av_frame_unref(frame_ptr);
                   }
                   else
@@ -229,7 +280,10 @@ void VideoReader::DecodeNextStep(void)
                 if (got_a_frame)
                 {
                     PRINT_DEBUG_VideoReader("Got a frame for streamVectId "<<streamVectId)
-                    m_outputFrames[streamVectId].push(ToMat(codecCtx, frame_ptr));
+                    if (!IsBeforeSeekTarget(streamVectId, frame_ptr))
+                    {
+                        m_outputFrames[streamVectId].push(ToMat(codecCtx, frame_ptr, s_matAllocator, m_conversionDurationNs));
+                    }
                     av_frame_unref(frame_ptr);
                     //m_outputFrames[streamVectId].emplace();
                 }
@@ -1,14 +1,151 @@
 #include "VideoWriter.hpp"
 #include <stdexcept>
+#include <chrono>
+#include <algorithm>
 
 
 using namespace IMT::LibAv;
 
+int VideoWriter::s_nbCodecThreads = 0;
+
+void VideoWriter::Concatenate(const std::vector<std::string>& inputPaths, const std::string& outputPath)
+{
+    if (inputPaths.empty())
+    {
+        throw std::invalid_argument("Concatenate: no input video for "+outputPath);
+    }
+    av_register_all();
+    AVFormatContext* out_ctx = nullptr;
+    avformat_alloc_output_context2(&out_ctx, NULL, NULL, outputPath.c_str());
+    if (!out_ctx)
+    {
+        throw std::runtime_error("Coulnt allocate output video "+outputPath);
+    }
+    //timestamp (in the output time base) of the first frame of the next input, for each stream
+    std::vector<int64_t> nextStart;
+    std::vector<int64_t> lastDts;
+    //start time of the first input: the timestamps of the next inputs are relative to it (e.g. negative dts of the B-frames)
+    std::vector<int64_t> firstStartTime;
+    for (unsigned inputId = 0; inputId < inputPaths.size(); ++inputId)
+    {
+        const std::string& inputPath = inputPaths[inputId];
+        AVFormatContext* in_ctx = nullptr;
+        if (avformat_open_input(&in_ctx, inputPath.c_str(), nullptr, nullptr) < 0 || avformat_find_stream_info(in_ctx, nullptr) < 0)
+        {
+            avformat_close_input(&in_ctx);
+            avformat_free_context(out_ctx);
+            throw std::runtime_error("Could not open input video "+inputPath);
+        }
+        if (inputId == 0)
+        {
+            for (unsigned i = 0; i < in_ctx->nb_streams; ++i)
+            {
+                AVStream* stream = avformat_new_stream(out_ctx, nullptr);
+                avcodec_parameters_copy(stream->codecpar, in_ctx->streams[i]->codecpar);
+                stream->codecpar->codec_tag = 0;
+                stream->time_base = in_ctx->streams[i]->time_base;
+            }
+            if (!(out_ctx->oformat->flags & AVFMT_NOFILE) && avio_open(&out_ctx->pb, outputPath.c_str(), AVIO_FLAG_WRITE) < 0)
+            {
+                avformat_close_input(&in_ctx);
+                avformat_free_context(out_ctx);
+                throw std::runtime_error("Could not open output file "+outputPath);
+            }
+            if (avformat_write_header(out_ctx, NULL) < 0)
+            {
+                avformat_close_input(&in_ctx);
+                avio_closep(&out_ctx->pb);
+                avformat_free_context(out_ctx);
+                throw std::runtime_error("Error occurred when opening output file "+outputPath);
+            }
+            nextStart = std::vector<int64_t>(out_ctx->nb_streams, 0);
+            lastDts = std::vector<int64_t>(out_ctx->nb_streams, AV_NOPTS_VALUE);
+            for (unsigned i = 0; i < in_ctx->nb_streams; ++i)
+            {
+                const auto* stream = in_ctx->streams[i];
+                firstStartTime.push_back(stream->start_time != AV_NOPTS_VALUE ? av_rescale_q(stream->start_time, stream->time_base, out_ctx->streams[i]->time_base) : 0);
+                nextStart[i] = firstStartTime[i];
+            }
+        }
+        bool isCompatible = in_ctx->nb_streams == out_ctx->nb_streams;
+        for (unsigned i = 0; isCompatible && i < in_ctx->nb_streams; ++i)
+        {
+            const auto* inPar = in_ctx->streams[i]->codecpar;
+            const auto* outPar = out_ctx->streams[i]->codecpar;
+            isCompatible = inPar->codec_id == outPar->codec_id && inPar->width == outPar->width && inPar->height == outPar->height;
+        }
+        if (!isCompatible)
+        {
+            avformat_close_input(&in_ctx);
+            av_write_trailer(out_ctx);
+            avio_closep(&out_ctx->pb);
+            avformat_free_context(out_ctx);
+            throw std::runtime_error("Cannot concatenate "+inputPath+": the streams are not the same as the ones of "+inputPaths[0]);
+        }
+        //shift of the timestamps of this input and end of this input, in the output time base
+        std::vector<int64_t> shift;
+        std::vector<int64_t> end(nextStart);
+        //duration of the packets without duration
+        std::vector<int64_t> frameDuration;
+        for (unsigned i = 0; i < in_ctx->nb_streams; ++i)
+        {
+            const auto* stream = in_ctx->streams[i];
+            int64_t startTime = stream->start_time != AV_NOPTS_VALUE ? av_rescale_q(stream->start_time, stream->time_base, out_ctx->streams[i]->time_base) : 0;
+            shift.push_back(nextStart[i]-startTime);
+            frameDuration.push_back(stream->avg_frame_rate.num != 0 ? std::max(int64_t(1), av_rescale_q(1, av_inv_q(stream->avg_frame_rate), out_ctx->streams[i]->time_base)) : 1);
+        }
+        AVPacket pkt;
+        while (av_read_frame(in_ctx, &pkt) >= 0)
+        {
+            const unsigned i = pkt.stream_index;
+            av_packet_rescale_ts(&pkt, in_ctx->streams[i]->time_base, out_ctx->streams[i]->time_base);
+            if (pkt.pts != AV_NOPTS_VALUE)
+            {
+                pkt.pts += shift[i];
+                end[i] = std::max(end[i], pkt.pts+(pkt.duration > 0 ? int64_t(pkt.duration) : frameDuration[i]));
+            }
+            if (pkt.dts != AV_NOPTS_VALUE)
+            {
+                pkt.dts += shift[i];
+                //the muxer needs strictly increasing dts
+                if (lastDts[i] != AV_NOPTS_VALUE && pkt.dts <= lastDts[i])
+                {
+                    pkt.dts = lastDts[i]+1;
+                }
+                if (pkt.pts != AV_NOPTS_VALUE && pkt.pts < pkt.dts)
+                {
+                    pkt.pts = pkt.dts;
+                }
+                lastDts[i] = pkt.dts;
+            }
+            pkt.pos = -1;
+            if (av_interleaved_write_frame(out_ctx, &pkt) < 0)
+            {
+                av_packet_unref(&pkt);
+                avformat_close_input(&in_ctx);
+                av_write_trailer(out_ctx);
+                avio_closep(&out_ctx->pb);
+                avformat_free_context(out_ctx);
+                throw std::runtime_error("Error while writing pkt in "+outputPath);
+            }
+            av_packet_unref(&pkt);
+        }
+        nextStart = end;
+        avformat_close_input(&in_ctx);
+    }
+    av_write_trailer(out_ctx);
+    if (!(out_ctx->oformat->flags & AVFMT_NOFILE))
+    {
+        avio_closep(&out_ctx->pb);
+    }
+    avformat_free_context(out_ctx);
+}
+
 VideoWriter::VideoWriter(const std::string& outputFileName): m_outputFileName(outputFileName),  m_fmt_ctx(NULL),
- m_codec_ctx(), m_vstream(), m_isInit(false), m_lastFramesQueue(), m_pts(0)
+ m_codec_ctx(), m_vstream(), m_isInit(false), m_lastFramesQueue(), m_pts(0), m_conversionDurationNs(0), m_nbEncodedBytes(0)
 {}
 
-VideoWriter::VideoWriter(VideoWriter&& vw): m_outputFileName(), m_fmt_ctx(NULL), m_isInit(false)
+VideoWriter::VideoWriter(VideoWriter&& vw): m_outputFileName(), m_fmt_ctx(NULL), m_conversionDurationNs(0), m_nbEncodedBytes(0), m_isInit(false)
 {
     std::swap(*this, vw);
 }
@@ -134,10 +271,12 @@ void VideoWriter::EncodeAndWrite(const cv::Mat& pict, int streamId)
     frame->pts = m_pts++;
 
     enum AVPixelFormat src_pix_fmt = AV_PIX_FMT_BGR24;
+    auto conversionStart = std::chrono::steady_clock::now();
     auto* convert_ctx = sws_getContext(frame->width, frame->height, (enum AVPixelFormat)src_pix_fmt, frame->width, frame->height, (enum AVPixelFormat)frame->format, SWS_FAST_BILINEAR, NULL, NULL, NULL);
     sws_scale(convert_ctx, src.data, src.linesize, 0, frame->height, frame->data, frame->linesize);
 
     sws_freeContext(convert_ctx);
+    m_conversionDurationNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-conversionStart).count();
     PRINT_DEBUG_VideoWrite("Encode: frame generated")
     EncodeAndWrite(frame, streamId);
 }
@@ -176,6 +315,7 @@ void VideoWriter::EncodeAndWrite(AVFrame* frame, int streamId)
                   pkt.dts = av_rescale_q(pkt.dts, m_codec_ctx[streamId]->time_base, m_vstream[streamId]->time_base);
               }
               pkt.stream_index = m_vstream[streamId]->index;
+              m_nbEncodedBytes += pkt.size;
               PRINT_DEBUG_VideoWrite("Start writing packet")
               if (av_interleaved_write_frame(m_fmt_ctx, &pkt) < 0)
               {
@@ -0,0 +1,107 @@
+#include "benchmark/benchmark.h"
+#include "LayoutEquirectangular.hpp"
+#include "LayoutCubeMap.hpp"
+#include "LayoutCubeMap2.hpp"
+#include "LayoutPyramidal2.hpp"
+#include "LayoutRhombicdodeca.hpp"
+#include "LayoutEquirectangularTiles.hpp"
+#include "LayoutFlatFixed.hpp"
+#include "LayoutViewport.hpp"
+#include "SpherePointSet.hpp"
+#include "Common.hpp"
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+
+using namespace IMT;
+
+//the layouts are generated for a 4K equirectangular input, as ConfigParser does with the infer option
+static const unsigned int w = 3840;
+static const unsigned int h = 1920;
+static const std::string facesPosition = "{\"face1\":\"right\", \"face1Rotation\":0, \"face2\":\"back\", \"face2Rotation\":0, \"face3\":\"left\", \"face3Rotation\":0, \"face4\":\"top\", \"face4Rotation\":-90, \"face5\":\"front\", \"face5Rotation\":-90, \"face6\":\"bottom\", \"face6Rotation\":-90}";
+
+static std::shared_ptr<Layout> GetCubeMap(bool useEqualArea)
+{
+  std::array<std::array<unsigned int, 2>,6> edges;
+  edges.fill({{w/3, h/2}});
+  return LayoutCubeMap::GenerateLayout(Quaternion(1), false, std::make_shared<VectorialTrans>(), facesPosition, edges, useEqualArea);
+}
+
+static const std::vector<std::pair<std::string, std::function<std::shared_ptr<Layout>(void)>>> layouts = {
+  {"equirectangular", [](){return std::make_shared<LayoutEquirectangular>(w, h, Quaternion(1), std::make_shared<VectorialTrans>());}},
+  {"cubeMap", [](){return GetCubeMap(false);}},
+  {"EAC", [](){return GetCubeMap(true);}},
+  {"cubeMap2", [](){std::array<std::array<unsigned int, 2>,6> edges; edges.fill({{w/4, w/4}});
+                    return LayoutCubeMap2::GenerateLayout(Quaternion(1), false, std::make_shared<VectorialTrans>(), edges);}},
+  {"pyramid2", [](){return LayoutPyramidal2::GenerateLayout(2.5, Quaternion(1), false, std::make_shared<VectorialTrans>(), {{w/4, w/4, w/4, w/4, w/4}});}},
+  {"rhombicDodeca", [](){std::array<unsigned int,12> edges; edges.fill(w/8);
+                         return LayoutRhombicdodeca::GenerateLayout(Quaternion(1), std::make_shared<VectorialTrans>(), false, edges);}},
+  {"equirectangularTiles", [](){return std::make_shared<LayoutEquirectangularTiles>(2, 2, LayoutEquirectangularTiles::ScaleTilesMap({{1, 0.5}, {1, 0.5}}),
+                                  std::make_tuple(std::vector<double>({0.5, 0.5}), std::vector<double>({0.5, 0.5})), Quaternion(1), std::make_tuple(w, h), false, false, std::make_shared<VectorialTrans>());}},
+  {"flatFixed", [](){return std::make_shared<LayoutFlatFixed>(DynamicPosition(Quaternion(1)), 1920, 1080, 110*PI()/180, 90*PI()/180);}},
+  {"viewport", [](){return std::make_shared<LayoutViewport>(DynamicPosition(Quaternion(1)), 1920, 1080, 110*PI()/180, 90*PI()/180);}}
+};
+
+static std::shared_ptr<Layout> GetLayout(benchmark::State& state)
+{
+  const auto& layout = layouts[state.range(0)];
+  state.SetLabel(layout.first);
+  auto l = layout.second();
+  l->Init();
+  return l;
+}
+
+static void BM_From2dTo3d(benchmark::State& state)
+{
+  auto layout = GetLayout(state);
+  //a grid of 64x64 pixels covering the whole layout
+  std::vector<CoordI> pixels;
+  for (unsigned int j = 0; j < 64; ++j)
+  {
+    for (unsigned int i = 0; i < 64; ++i)
+    {
+      pixels.push_back(CoordI(i*layout->GetWidth()/64, j*layout->GetHeight()/64));
+    }
+  }
+  for (auto _: state)
+  {
+    for (const auto& pixel: pixels)
+    {
+      benchmark::DoNotOptimize(layout->From2dTo3d(pixel));
+    }
+  }
+  state.SetItemsProcessed(state.iterations()*pixels.size());
+}
+BENCHMARK(BM_From2dTo3d)->DenseRange(0, layouts.size()-1);
+
+static void BM_FromSphereTo2d(benchmark::State& state)
+{
+  auto layout = GetLayout(state);
+  auto pointSet = SpherePointSet::Get(4096);
+  const VectorBatch& points = pointSet->GetCartesianPoints();
+  for (auto _: state)
+  {
+    for (size_t k = 0; k < points.Size(); ++k)
+    {
+      benchmark::DoNotOptimize(layout->FromSphereTo2d(points.Get(k)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations()*points.Size());
+}
+BENCHMARK(BM_FromSphereTo2d)->DenseRange(0, layouts.size()-1);
+
+static void BM_FromSphereTo2dBatch(benchmark::State& state)
+{
+  auto layout = GetLayout(state);
+  auto pointSet = SpherePointSet::Get(4096);
+  const VectorBatch& points = pointSet->GetCartesianPoints();
+  std::vector<CoordF> coords(points.Size());
+  for (auto _: state)
+  {
+    layout->FromSphereTo2dBatch(points, 0, points.Size(), coords.data());
+    benchmark::DoNotOptimize(coords.data());
+  }
+  state.SetItemsProcessed(state.iterations()*points.Size());
+}
+BENCHMARK(BM_FromSphereTo2dBatch)->DenseRange(0, layouts.size()-1);
@@ -0,0 +1,78 @@
+#include "benchmark/benchmark.h"
+#include "Picture.hpp"
+#include "LayoutEquirectangular.hpp"
+#include "Common.hpp"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <vector>
+#include <random>
+
+using namespace IMT;
+
+static const std::vector<std::pair<int, int>> resolutions = {{1920, 1080}, {3840, 2160}, {7680, 4320}};
+
+/** Picture with a random content: the metrics do not take the same path on a constant picture */
+static std::shared_ptr<Picture> GetRandomPicture(int width, int height, int seed)
+{
+  cv::Mat mat(height, width, CV_8UC3);
+  cv::theRNG().state = seed;
+  cv::randu(mat, cv::Scalar::all(0), cv::Scalar::all(256));
+  return std::make_shared<Picture>(std::move(mat));
+}
+
+static void BM_GetInterPixel(benchmark::State& state)
+{
+  const auto it = Picture::InterpolationTech(state.range(0));
+  const char* names[] = {"nearestNeighbor", "bilinear", "bicubic"};
+  state.SetLabel(names[state.range(0)]);
+  auto pict = GetRandomPicture(3840, 1920, 1);
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> distX(0, pict->GetWidth()-1);
+  std::uniform_real_distribution<double> distY(0, pict->GetHeight()-1);
+  std::vector<CoordF> coords(4096);
+  for (auto& coord: coords)
+  {
+    coord = CoordF(distX(gen), distY(gen));
+  }
+  for (auto _: state)
+  {
+    for (const auto& coord: coords)
+    {
+      benchmark::DoNotOptimize(pict->GetInterPixel(coord, it));
+    }
+  }
+  state.SetItemsProcessed(state.iterations()*coords.size());
+}
+BENCHMARK(BM_GetInterPixel)->DenseRange(int(Picture::InterpolationTech::NEAREST_NEIGHTBOOR), int(Picture::InterpolationTech::BICUBIC));
+
+enum class Metric {PSNR, SSIM, MSSSIM, SPSNR_NN, SPSNR_I, WSPSNR};
+
+template<Metric metric>
+static void BM_Metric(benchmark::State& state)
+{
+  const auto& res = resolutions[state.range(0)];
+  state.SetLabel(std::to_string(res.second)+"p");
+  auto ref = GetRandomPicture(res.first, res.second, 1);
+  auto pict = GetRandomPicture(res.first, res.second, 2);
+  LayoutEquirectangular layout(res.first, res.second, Quaternion(1), std::make_shared<VectorialTrans>());
+  layout.Init();
+  for (auto _: state)
+  {
+    switch (metric)
+    {
+      case Metric::PSNR: benchmark::DoNotOptimize(ref->GetPSNR(*pict)); break;
+      case Metric::SSIM: benchmark::DoNotOptimize(ref->GetSSIM(*pict)); break;
+      case Metric::MSSSIM: benchmark::DoNotOptimize(ref->GetMSSSIM(*pict)); break;
+      case Metric::SPSNR_NN: benchmark::DoNotOptimize(ref->GetSPSNR(*pict, layout, layout, Picture::InterpolationTech::NEAREST_NEIGHTBOOR)); break;
+      case Metric::SPSNR_I: benchmark::DoNotOptimize(ref->GetSPSNR(*pict, layout, layout, Picture::InterpolationTech::BICUBIC)); break;
+      case Metric::WSPSNR: benchmark::DoNotOptimize(ref->GetWSPSNR(*pict, layout, layout)); break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations()*res.first*res.second);
+}
+BENCHMARK_TEMPLATE(BM_Metric, Metric::PSNR)->DenseRange(0, resolutions.size()-1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Metric, Metric::SSIM)->DenseRange(0, resolutions.size()-1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Metric, Metric::MSSSIM)->DenseRange(0, resolutions.size()-1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Metric, Metric::SPSNR_NN)->DenseRange(0, resolutions.size()-1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Metric, Metric::SPSNR_I)->DenseRange(0, resolutions.size()-1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Metric, Metric::WSPSNR)->DenseRange(0, resolutions.size()-1)->Unit(benchmark::kMillisecond);
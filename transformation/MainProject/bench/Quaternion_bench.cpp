@@ -0,0 +1,46 @@
+#include "benchmark/benchmark.h"
+#include "Quaternion.hpp"
+#include "RotMat.hpp"
+#include "Common.hpp"
+
+using namespace IMT;
+
+static void BM_QuaternionRotation(benchmark::State& state)
+{
+  auto q = Quaternion::QuaternionFromAngleAxis(PI()/3, VectorCartesian(1, 2, 3));
+  VectorCartesian v(1, -2, 0.5);
+  for (auto _: state)
+  {
+    v = q.Rotation(v);
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QuaternionRotation);
+
+//same rotation with the matrix of the quaternion (used by the layouts to rotate many points)
+static void BM_RotMatRotation(benchmark::State& state)
+{
+  auto r = RotMat::FromQuaternion(Quaternion::QuaternionFromAngleAxis(PI()/3, VectorCartesian(1, 2, 3)));
+  VectorCartesian v(1, -2, 0.5);
+  for (auto _: state)
+  {
+    v = r*v;
+    benchmark::DoNotOptimize(v);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RotMatRotation);
+
+static void BM_QuaternionProduct(benchmark::State& state)
+{
+  auto q1 = Quaternion::QuaternionFromAngleAxis(PI()/3, VectorCartesian(1, 2, 3));
+  auto q2 = Quaternion::QuaternionFromAngleAxis(PI()/7, VectorCartesian(0, 1, 1));
+  for (auto _: state)
+  {
+    q1 = q1*q2;
+    benchmark::DoNotOptimize(q1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QuaternionProduct);
@@ -0,0 +1,87 @@
+/**
+ * Blocking FIFO queue with a maximum size, used between the stages of the frame pipeline
+ */
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+namespace IMT {
+
+template<class T>
+class BoundedQueue
+{
+public:
+  /** \brief Constructor
+   *
+   * \param maxSize size_t Maximum number of elements in the queue (must be > 0): Push blocks while the queue is full
+   *
+   */
+  explicit BoundedQueue(size_t maxSize): m_maxSize(maxSize), m_queue(), m_isClosed(false), m_mutex(), m_notEmpty(), m_notFull()
+  {
+    if (m_maxSize == 0)
+    {
+      throw std::invalid_argument("Bounded queue size must be strictly positive");
+    }
+  }
+
+  /** \brief Add an element at the end of the queue. Block while the queue is full.
+   *
+   * \return bool false if the queue was closed (the element is dropped)
+   */
+  bool Push(T value)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this]{return m_isClosed || m_queue.size() < m_maxSize;});
+    if (m_isClosed)
+    {
+      return false;
+    }
+    m_queue.push_back(std::move(value));
+    m_notEmpty.notify_one();
+    return true;
+  }
+
+  /** \brief Remove the first element of the queue. Block while the queue is empty and not closed.
+   *
+   * \return bool false if the queue is closed and empty (value is unchanged)
+   */
+  bool Pop(T& value)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmpty.wait(lock, [this]{return m_isClosed || !m_queue.empty();});
+    if (m_queue.empty())
+    {
+      return false;
+    }
+    value = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_notFull.notify_one();
+    return true;
+  }
+
+  /** \brief No more element can be pushed: the blocked Push return false and Pop return the remaining elements then false.
+   */
+  void Close(void)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isClosed = true;
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+  }
+
+  size_t GetMaxSize(void) const {return m_maxSize;}
+  size_t GetSize(void) const {std::lock_guard<std::mutex> lock(m_mutex); return m_queue.size();}
+  bool IsClosed(void) const {std::lock_guard<std::mutex> lock(m_mutex); return m_isClosed;}
+
+private:
+  const size_t m_maxSize;
+  std::deque<T> m_queue;
+  bool m_isClosed;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_notEmpty;
+  std::condition_variable m_notFull;
+};
+}
@@ -6,6 +6,7 @@
 #include <functional>
 #include <iostream>
 #include "Quaternion.hpp"
+#include "RotMat.hpp"
 #include <opencv2/opencv.hpp>
 
 namespace IMT {
@@ -45,6 +46,9 @@ typedef cv::Point2i CoordI;
 // typedef SpacePoint<1> Coord3dSpherical;
 typedef VectorCartesian Coord3dCart;
 typedef VectorSpherical Coord3dSpherical;
+//float32 geometry mode (see Layout::GeometryPrecision)
+typedef VectorCartesianF32 Coord3dCartF32;
+typedef VectorSphericalF32 Coord3dSphericalF32;
 typedef cv::Vec4d Plan;// (a,b,c,d) a.x+b.y+c.z+d=0
 // template <int i> constexpr double norm(const SpacePoint<i>& sp) {return cv::norm(sp.d);}
 // template <> constexpr double norm(const Coord3dSpherical& sp) {return sp.x;}
@@ -91,15 +95,24 @@ constexpr bool inInterval(double x, double a, double b)
 //     return ConvertCoord(*this);
 // }
 
+//The rotations work on Cartesian coordinates: a spherical coordinate has to be converted explicitly (the conversion costs some trigonometry)
+Coord3dCart Rotation(const Coord3dSpherical& coordBefRot, const Quaternion& rotationQuaternion) = delete;
+Coord3dCart Rotation(const Coord3dSpherical& coordBefRot, const RotMat& rotationMat) = delete;
+
 inline Coord3dCart Rotation(const Coord3dCart& coordBefRot, const Quaternion& rotationQuaternion)
 {//hypothesis rotationMat is a 3x3 rotation matrix
     return rotationQuaternion.Rotation(coordBefRot);
 }
 
-// inline Coord3dCart Rotation(Coord3dCart&& coordBefRot, const RotMat& rotationMat)
-// {//hypothesis rotationMat is a 3x3 rotation matrix
-//     return coordBefRot*=rotationMat;
-// }
+inline Coord3dCart Rotation(const Coord3dCart& coordBefRot, const RotMat& rotationMat)
+{//hypothesis rotationMat is a 3x3 rotation matrix
+    return rotationMat*coordBefRot;
+}
+
+inline Coord3dCartF32 Rotation(const Coord3dCartF32& coordBefRot, const RotMatF32& rotationMat)
+{//hypothesis rotationMat is a 3x3 rotation matrix
+    return rotationMat*coordBefRot;
+}
 
 // #define cosY (std::cos(yaw))
 // #define sinY (std::sin(yaw))
@@ -293,10 +306,9 @@ std::tuple<Coord3dSpherical, FaceType> IntersectionSphe(FaceToPlanFct<FaceType>
 }
 
 template <class FaceType>
-std::tuple<Coord3dCart, FaceType> IntersectionCart(FaceToPlanFct<FaceType> FaceToPlan, const Coord3dSpherical& secondPoint)
-{
-    double theta(secondPoint.GetTheta()), phi(secondPoint.GetPhi());
-    double cosT(std::cos(theta)), sinT(std::sin(theta)), cosP(std::cos(phi)), sinP(std::sin(phi));
+std::tuple<Coord3dCart, FaceType> IntersectionCart(FaceToPlanFct<FaceType> FaceToPlan, const Coord3dCart& direction)
+{//direction does not need to be normalized
+    const Coord3dCart unitDirection = direction/direction.Norm();
     FaceType interFace;
     double minR = std::numeric_limits<double>::max();
     for (auto testF: get_range<FaceType>())
@@ -306,7 +318,7 @@ std::tuple<Coord3dCart, FaceType> IntersectionCart(FaceToPlanFct<FaceType> FaceT
         const double& b = p[1];
         const double& c = p[2];
         const double& d = p[3];
-        double u = a*cosT*sinP + b*sinT*sinP + c*cosP;
+        double u = a*unitDirection.GetX() + b*unitDirection.GetY() + c*unitDirection.GetZ();
         if (u != 0)
         {
             double r = -d / u;
@@ -317,7 +329,7 @@ std::tuple<Coord3dCart, FaceType> IntersectionCart(FaceToPlanFct<FaceType> FaceT
             }
         }
     }
-    return std::make_tuple( Coord3dCart(minR*cosT*sinP, minR*sinT*sinP, minR*cosP),  interFace);
+    return std::make_tuple( minR*unitDirection,  interFace);
 }
 
 template<typename Stream, typename T>                                        
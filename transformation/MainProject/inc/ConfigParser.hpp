@@ -3,9 +3,9 @@
 #include <sstream>
 #include <vector>
 #include <memory>
+#include <stdexcept>
 
 #include <boost/property_tree/ptree.hpp>
-#include <boost/preprocessor.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
 #include "Layout.hpp"
@@ -24,98 +24,6 @@
 
 namespace IMT {
 
-#define RANGE_NB_H_TILES ((1) (2) (3) (4) (5) (8) (16))
-#define RANGE_NB_V_TILES ((1) (2) (3) (4) (5) (8) (16))
-//#define RANGE_NB_H_TILES ((3))
-//#define RANGE_NB_V_TILES ((3))
-
-#define GENERATE_EQUI_TILED_LAYOUT(nbHTiles,nbVTiles) \
-  LayoutEquirectangularTiles<nbHTiles,nbVTiles>::ScaleTilesMap scaleRes;\
-  for (unsigned int i = 0; i < nbHTiles; ++i)\
-  {\
-      for (unsigned int j = 0; j < nbVTiles; ++j)\
-      {\
-          auto scale = ptree.get<double>(layoutSection+".equirectangularTile_"+std::to_string(i)+"_"+std::to_string(j));\
-          scaleRes[i][j] = scale;\
-      }\
-  }\
-  if (isInput)\
-  {\
-      if (!infer)\
-      {\
-          throw std::invalid_argument("Input with static resolution not supported yet");\
-      }\
-      if (refRes == CoordI(0,0))\
-      {\
-          refRes = LayoutEquirectangularTiles<nbHTiles,nbVTiles>::GetReferenceResolution(inputWidth, inputHeight, scaleRes);\
-      }\
-      inputWidth = refRes.x;\
-      inputHeight = refRes.y;\
-  }\
-  /*LayoutEquirectangularTiles<nbHTiles,nbVTiles>::TilesMap tileRes;\
-  for (unsigned int i = 0; i < nbHTiles; ++i)\
-  {\
-      for (unsigned int j = 0; j < nbVTiles; ++j)\
-      {\
-          tileRes[i][j] = std::make_tuple(unsigned(scaleRes[i][j]*inputWidth/nbHTiles),unsigned(scaleRes[i][j]*inputHeight/nbVTiles));\
-      }\
-  }*/\
-  std::array<double, nbHTiles> hRatios;\
-  std::array<double, nbVTiles> vRatios;\
-  double sumH = 0;\
-  double sumV = 0;\
-  for (unsigned i = 0; i < nbHTiles; ++i)\
-  {\
-    hRatios[i] =  ptree.get<double>(layoutSection+".hTileRation_"+std::to_string(i));\
-    sumH += hRatios[i];\
-  }\
-  for (unsigned j = 0; j < nbVTiles; ++j)\
-  {\
-    vRatios[j] =  ptree.get<double>(layoutSection+".vTileRation_"+std::to_string(j));\
-    sumV += vRatios[j];\
-  }\
-  for(auto& hr: hRatios) {hr /= sumH;}\
-  for(auto& vr: vRatios) {vr /= sumV;}\
-  auto tilesRatios = std::make_tuple(std::move(hRatios),std::move(vRatios));\
-  auto orignalRes = std::make_tuple(inputWidth, inputHeight);\
-  return std::make_shared<LayoutEquirectangularTiles<nbHTiles,nbVTiles>>(std::move(scaleRes), std::move(tilesRatios), rotationQuaternion, orignalRes, useTile, upscale, vectorialTrans);
-///END MACRO GENERATE_EQUI_TILED_LAYOUT
-
-#define TEST_AND_GENERATE_EQUI_TILED_LAYOUT(r, p)\
-  if (nbHTiles == BOOST_PP_SEQ_ELEM(0,p) && nbVTiles == BOOST_PP_SEQ_ELEM(1,p))\
-  {\
-    GENERATE_EQUI_TILED_LAYOUT(BOOST_PP_SEQ_ELEM(0,p),BOOST_PP_SEQ_ELEM(1,p))\
-  }
-///END MACRO TEST_AND_GENERATE_EQUI_TILED_LAYOUT
-
-#define GET_BITRATE_VECT(nbHTiles, nbVTiles) \
-  std::array<std::array<double, nbVTiles>, nbHTiles> faceBitrate;\
-  double sum = 0;\
-  for (unsigned i = 0; i < nbHTiles; ++i)\
-  {\
-      for (unsigned j = 0; j < nbVTiles; ++j)\
-      {\
-          faceBitrate[i][j] = ptree.get<double>(layoutSection+".equirectangularTileBitrate_"+std::to_string(i)+"_"+std::to_string(j));\
-          sum += faceBitrate[i][j];\
-      }\
-  }\
-  for (unsigned i = 0; i < nbHTiles; ++i)\
-  {\
-      for (unsigned j = 0; j < nbVTiles; ++j)\
-      {\
-          bitrateVect.push_back(bitrateGoal*faceBitrate[i][j]/sum);\
-      }\
-  }
-///END MACRO GET_BITRATE_VECT
-
-#define TEST_AND_GET_BITRATE_VECT(r,p)\
-  if (nbHTiles == BOOST_PP_SEQ_ELEM(0,p) && nbVTiles == BOOST_PP_SEQ_ELEM(1,p))\
-  {\
-    GET_BITRATE_VECT(BOOST_PP_SEQ_ELEM(0,p),BOOST_PP_SEQ_ELEM(1,p))\
-  }
-///END MACRO TEST_AND_GET_BITRATE_VECT
-
-
 namespace pt = boost::property_tree;
 std::vector<int> GetBitrateVector(std::string layoutSection, pt::ptree& ptree, int bitrateGoal)
 {
@@ -222,8 +130,17 @@ std::vector<int> GetBitrateVector(std::string layoutSection, pt::ptree& ptree, i
             unsigned int nbHTiles = ptree.get<unsigned int>(layoutSection+".nbHTiles");
             unsigned int nbVTiles = ptree.get<unsigned int>(layoutSection+".nbVTiles");
 
-            BOOST_PP_SEQ_FOR_EACH_PRODUCT(TEST_AND_GET_BITRATE_VECT, RANGE_NB_H_TILES RANGE_NB_V_TILES)
-
+            std::vector<double> faceBitrate(nbHTiles*nbVTiles);
+            double sum = 0;
+            for (unsigned i = 0; i < nbHTiles; ++i)
+            {
+                for (unsigned j = 0; j < nbVTiles; ++j)
+                {
+                    faceBitrate[i*nbVTiles+j] = ptree.get<double>(layoutSection+".equirectangularTileBitrate_"+std::to_string(i)+"_"+std::to_string(j));
+                    sum += faceBitrate[i*nbVTiles+j];
+                }
+            }
+            for (auto b: faceBitrate) { bitrateVect.push_back(bitrateGoal*b/sum); }
             return bitrateVect;
           }
           else
@@ -236,8 +153,7 @@ std::vector<int> GetBitrateVector(std::string layoutSection, pt::ptree& ptree, i
     }
     catch (std::exception &e)
     {
-        std::cout << "Error while parsing in configuration file the "<<layoutSection<<" layout: " << e.what() << std::endl;
-        throw e;
+        throw std::invalid_argument("Error while parsing in configuration file the "+layoutSection+" layout: "+e.what());
     }
     throw std::invalid_argument("Not supported type: "+layoutType);
 }
@@ -377,7 +293,6 @@ std::shared_ptr<VectorialTrans> GetVectorialTransformation(std::string transSect
             {
                 b = layoutRotation.Rotation(Coord3dCart(1, 0, 0));
             }
-            std::cout << "offsetTrans -> alpha = " << offsetRatio << "; b = " << b << std::endl;
             return std::make_shared<OffsetTrans>(offsetRatio, std::move(b));
         }
         if (transType == "horizontalOffsetTrans")
@@ -393,15 +308,13 @@ std::shared_ptr<VectorialTrans> GetVectorialTransformation(std::string transSect
             {
                 q = layoutRotation;
             }
-            std::cout << "horizontalOffsetTrans -> alpha = " << offsetRatio << "; q = " << q << std::endl;
             return std::make_shared<HorizontalOffsetTrans>(offsetRatio, std::move(q));
         }
 
     }
     catch (std::exception &e)                                                    
     {                                                                            
-        std::cout << "Error while parsing in configuration file the "<<transSection<<" Vectorial Transformation: " << e.what() << std::endl;
-        throw e;                                                                 
+        throw std::invalid_argument("Error while parsing in configuration file the "+transSection+" Vectorial Transformation: "+e.what());
     }                                                                            
     throw std::invalid_argument("Not supported type: "+transType);
 }
@@ -433,9 +346,7 @@ std::shared_ptr<Layout> InitialiseLayout(std::string layoutSection, pt::ptree& p
             }
             catch(std::exception &e)
             {
-                std::cout << "Could not find " << layoutSection+".refWidth" << " or " << layoutSection+".refHeight" <<
-                    "for layoutSection=" << layoutSection << std::endl;
-                throw e;
+                throw std::invalid_argument("Could not find "+layoutSection+".refWidth or "+layoutSection+".refHeight: "+e.what());
             }
         }
         else
@@ -584,7 +495,6 @@ std::shared_ptr<Layout> InitialiseLayout(std::string layoutSection, pt::ptree& p
             }
             else
             {
-              std::cout << "DEBUG dynamic position set" << std::endl;
               pathToPositionTrace = ptree.get<std::string>(layoutSection+".positionTrace");
             }
             DynamicPosition dynamicPosition = dynamicPositions ? DynamicPosition(pathToPositionTrace)  :DynamicPosition(rotationQuaternion);
@@ -615,7 +525,6 @@ std::shared_ptr<Layout> InitialiseLayout(std::string layoutSection, pt::ptree& p
             }
             else
             {
-              std::cout << "DEBUG dynamic position set" << std::endl;
               pathToPositionTrace = ptree.get<std::string>(layoutSection+".positionTrace");
             }
             DynamicPosition dynamicPosition = dynamicPositions ? DynamicPosition(pathToPositionTrace)  :DynamicPosition(rotationQuaternion);
@@ -771,18 +680,92 @@ std::shared_ptr<Layout> InitialiseLayout(std::string layoutSection, pt::ptree& p
 
             unsigned int nbHTiles = ptree.get<unsigned int>(layoutSection+".nbHTiles");
             unsigned int nbVTiles = ptree.get<unsigned int>(layoutSection+".nbVTiles");
+            if (nbHTiles == 0 || nbVTiles == 0)
+            {
+                throw std::invalid_argument("Not supported type: equirectangularTiled with nbHTiles = "+std::to_string(nbHTiles)+" and nbVTiles = "+std::to_string(nbVTiles));
+            }
 
-            BOOST_PP_SEQ_FOR_EACH_PRODUCT(TEST_AND_GENERATE_EQUI_TILED_LAYOUT, RANGE_NB_H_TILES RANGE_NB_V_TILES)
-
-            throw std::invalid_argument("Not supported type: equirectangularTiled with nbHTiles = "+std::to_string(nbHTiles)+" and nbVTiles = "+std::to_string(nbVTiles));
+            LayoutEquirectangularTiles::ScaleTilesMap scaleRes(nbHTiles, std::vector<double>(nbVTiles));
+            for (unsigned int i = 0; i < nbHTiles; ++i)
+            {
+                for (unsigned int j = 0; j < nbVTiles; ++j)
+                {
+                    scaleRes[i][j] = ptree.get<double>(layoutSection+".equirectangularTile_"+std::to_string(i)+"_"+std::to_string(j));
+                }
+            }
+            if (isInput)
+            {
+                if (!infer)
+                {
+                    throw std::invalid_argument("Input with static resolution not supported yet");
+                }
+                if (refRes == CoordI(0,0))
+                {
+                    refRes = LayoutEquirectangularTiles::GetReferenceResolution(inputWidth, inputHeight, scaleRes);
+                }
+                inputWidth = refRes.x;
+                inputHeight = refRes.y;
+            }
+            std::vector<double> hRatios(nbHTiles);
+            std::vector<double> vRatios(nbVTiles);
+            double sumH = 0;
+            double sumV = 0;
+            for (unsigned i = 0; i < nbHTiles; ++i)
+            {
+              hRatios[i] =  ptree.get<double>(layoutSection+".hTileRation_"+std::to_string(i));
+              sumH += hRatios[i];
+            }
+            for (unsigned j = 0; j < nbVTiles; ++j)
+            {
+              vRatios[j] =  ptree.get<double>(layoutSection+".vTileRation_"+std::to_string(j));
+              sumV += vRatios[j];
+            }
+            for(auto& hr: hRatios) {hr /= sumH;}
+            for(auto& vr: vRatios) {vr /= sumV;}
+            auto tilesRatios = std::make_tuple(std::move(hRatios),std::move(vRatios));
+            auto orignalRes = std::make_tuple(inputWidth, inputHeight);
+            return std::make_shared<LayoutEquirectangularTiles>(nbHTiles, nbVTiles, std::move(scaleRes), std::move(tilesRatios), rotationQuaternion, orignalRes, useTile, upscale, vectorialTrans);
         }
     }
     catch (std::exception &e)
     {
-        std::cout << "Error while parsing in configuration file the "<<layoutSection<<" layout: " << e.what() << std::endl;
-        throw e;
+        throw std::invalid_argument("Error while parsing in configuration file the "+layoutSection+" layout: "+e.what());
     }
     throw std::invalid_argument("Not supported type: "+layoutType);
 }
 
+/** \brief Initialise the viewport geometry (flatFixed or viewport layout) described in the layoutSection with a static identity position.
+ *  The dynamicPositions, positionTrace and rotation parameters of the section are ignored.
+ */
+std::shared_ptr<Layout> InitialiseViewportGeometry(std::string layoutSection, pt::ptree& ptree)
+{
+    std::string layoutType;
+    try {
+        layoutType = ptree.get<std::string>(layoutSection+".type");
+        unsigned int width = ptree.get<unsigned int>(layoutSection+".width");
+        unsigned int height = ptree.get<unsigned int>(layoutSection+".height");
+        double horizontalAngleVision = ptree.get<double>(layoutSection+".horizontalAngleOfVision")*PI()/180;
+        double verticalAngleOfVision = ptree.get<double>(layoutSection+".verticalAngleOfVision")*PI()/180;
+        std::shared_ptr<Layout> layout(nullptr);
+        if (layoutType == "flatFixed")
+        {
+            layout = std::make_shared<LayoutFlatFixed>(DynamicPosition(Quaternion::FromEuler(0, 0, 0)), width, height, horizontalAngleVision, verticalAngleOfVision);
+        }
+        else if (layoutType == "viewport")
+        {
+            layout = std::make_shared<LayoutViewport>(DynamicPosition(Quaternion::FromEuler(0, 0, 0)), width, height, horizontalAngleVision, verticalAngleOfVision);
+        }
+        if (layout != nullptr)
+        {
+            layout->Init();
+            return layout;
+        }
+    }
+    catch (std::exception &e)
+    {
+        throw std::invalid_argument("Error while parsing in configuration file the "+layoutSection+" viewport geometry: "+e.what());
+    }
+    throw std::invalid_argument("Not supported viewport type: "+layoutType);
+}
+
 }
@@ -0,0 +1,47 @@
+/**
+ * Compute the quality of each face (or tile) of a layout
+ */
+#pragma once
+
+#include <vector>
+#include <tuple>
+
+#include "Common.hpp"
+#include "Layout.hpp"
+#include "Picture.hpp"
+
+namespace IMT {
+
+class FaceQualityMap
+{
+public:
+  /** \brief Constructor. Compute once the face id and the surface on the sphere of each pixel.
+   *  Throw std::invalid_argument if the two layouts do not have the same size (the layouts with different sizes are not supported).
+   *
+   * \param layoutRef Layout& Layout of the reference pictures
+   * \param layoutFaces Layout& Layout of the tested pictures: its faces (or tiles) define the regions
+   *
+   */
+  FaceQualityMap(Layout& layoutRef, Layout& layoutFaces);
+  ~FaceQualityMap(void) = default;
+
+  /** \brief Compute in one pass the PSNR and the WS-PSNR of each face of the tested picture (on the luma, like Picture::GetPSNR).
+   *
+   * \param pictRef const Picture& The reference picture
+   * \param pict const Picture& The tested picture
+   * \return std::tuple<std::vector<double>, std::vector<double>> The PSNR and the WS-PSNR of each face (100 if a face is perfect or empty)
+   *
+   */
+  std::tuple<std::vector<double>, std::vector<double>> ComputeQuality(const Picture& pictRef, const Picture& pict) const;
+
+  unsigned int GetNbFaces(void) const {return m_nbFaces;}
+private:
+  unsigned int m_width;
+  unsigned int m_height;
+  unsigned int m_nbFaces;
+  /**< face id of each pixel (row by row); -1 if the pixel is not in a face */
+  std::vector<int> m_faceIds;
+  /**< surface on the sphere of each pixel (row by row) */
+  std::vector<double> m_surfaces;
+};
+}
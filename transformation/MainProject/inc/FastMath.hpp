@@ -0,0 +1,148 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+
+namespace IMT {
+
+/**< Selects the trigonometry used by the projection math: the standard library (Exact) or the polynomial approximations of FastMath (Fast) */
+enum class MathMode {Exact, Fast};
+
+/** \brief Polynomial approximations of the trigonometric functions used by the projections (Cephes single precision polynomials).
+ *
+ *  The functions are branch free (the range reductions are done with selects) so that the loops calling them, and the array versions below,
+ *  are vectorized by the compiler (8 floats / 4 doubles per AVX register, 16 floats with AVX-512).
+ *
+ *  Maximum absolute error (checked by FastMath_test), in double / in float:
+ *   - Atan, Atan2: 1e-8 / 3e-7 rad
+ *   - Acos: 1e-8 / 1e-6 rad (in float the error comes from sqrt(1-x*x) close to +-1)
+ *   - Sin, Cos: 1e-8 / 1e-7 for |x| < 1e4 rad
+ *   - Tan: 1e-8 / 2e-7 relative error on [-pi/4, pi/4] (EAC range)
+ *  In output pixels: an angle error e moves an equirectangular pixel by e*width/(2*pi) and an EAC pixel by 2*e*faceWidth/pi,
+ *  i.e. less than 5e-4 pixel in float for a 8K equirectangular picture or 2K EAC faces. Those errors are far below the interpolation errors.
+ */
+namespace FastMath {
+
+template<class T> constexpr T Pi(void) {return T(3.141592653589793238462643383279502884L);}
+
+/** \brief atan(a) for a in [0, 1] */
+template<class T>
+inline T AtanUnit(T a)
+{
+  //atan(a) = pi/4 + atan((a-1)/(a+1)) above tan(pi/8). Both branches are computed so that the select is vectorized
+  const bool reduce = a > T(0.4142135623730950488);
+  const T reduced = (a-T(1))/(a+T(1));
+  const T x = reduce ? reduced : a;
+  const T z = x*x;
+  const T p = (((T(8.05374449538e-2)*z - T(1.38776856032e-1))*z + T(1.99777106478e-1))*z - T(3.33329491539e-1))*z*x + x;
+  return reduce ? p + Pi<T>()/4 : p;
+}
+
+template<class T>
+inline T Atan2(T y, T x)
+{
+  const T ax = std::abs(x);
+  const T ay = std::abs(y);
+  const T mx = std::max(ax, ay);
+  const T mn = std::min(ax, ay);
+  T r = AtanUnit(mn/std::max(mx, std::numeric_limits<T>::min())); //0 for (0, 0)
+  r = ay > ax ? Pi<T>()/2 - r : r;
+  r = x < T(0) ? Pi<T>() - r : r;
+  return y < T(0) ? -r : r;
+}
+
+template<class T>
+inline T Atan(T x)
+{
+  return Atan2(x, T(1));
+}
+
+template<class T>
+inline T Acos(T x)
+{
+  return Atan2(std::sqrt(std::max(T(0), T(1)-x*x)), x);
+}
+
+/** \brief Compute sin(x) and cos(x) with one range reduction */
+template<class T>
+inline void SinCos(T x, T& s, T& c)
+{
+  //x = k*pi/2 + r with r in [-pi/4, pi/4] (three constants Cody-Waite reduction, exact products in float)
+  const T k = std::floor(x*T(0.6366197723675813430755) + T(0.5));
+  const T r = ((x - k*T(1.5703125)) - k*T(4.837512969970703125e-4)) - k*T(7.54978995489188216e-8);
+  const T z = r*r;
+  const T sinR = ((T(-1.9515295891e-4)*z + T(8.3321608736e-3))*z - T(1.6666654611e-1))*z*r + r;
+  const T cosR = ((T(2.443315711809948e-5)*z - T(1.388731625493765e-3))*z + T(4.166664568298827e-2))*z*z - T(0.5)*z + T(1);
+  //quadrant k mod 4, computed in floating point to stay in the vector registers
+  const T q = k - T(4)*std::floor(k*T(0.25));
+  const bool odd = q == T(1) || q == T(3);
+  s = odd ? cosR : sinR;
+  c = odd ? sinR : cosR;
+  s = q >= T(2) ? -s : s;
+  c = q == T(1) || q == T(2) ? -c : c;
+}
+
+template<class T> inline T Sin(T x) {T s, c; SinCos(x, s, c); return s;}
+template<class T> inline T Cos(T x) {T s, c; SinCos(x, s, c); return c;}
+template<class T> inline T Tan(T x) {T s, c; SinCos(x, s, c); return s/c;}
+
+/** Array versions: out[i] = f(in[i]) for i in [0, n) */
+template<class T>
+inline void Atan2(const T* y, const T* x, T* out, size_t n)
+{
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i)
+  {
+    out[i] = Atan2(y[i], x[i]);
+  }
+}
+
+template<class T>
+inline void Atan(const T* x, T* out, size_t n)
+{
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i)
+  {
+    out[i] = Atan(x[i]);
+  }
+}
+
+template<class T>
+inline void SinCos(const T* x, T* s, T* c, size_t n)
+{
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i)
+  {
+    SinCos(x[i], s[i], c[i]);
+  }
+}
+
+template<class T>
+inline void Tan(const T* x, T* out, size_t n)
+{
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i)
+  {
+    out[i] = Tan(x[i]);
+  }
+}
+}
+
+/** Trigonometry of the projections with the selected MathMode */
+template<class T> inline T Atan2(T y, T x, MathMode mode) {return mode == MathMode::Fast ? FastMath::Atan2(y, x) : std::atan2(y, x);}
+template<class T> inline T Atan(T x, MathMode mode) {return mode == MathMode::Fast ? FastMath::Atan(x) : std::atan(x);}
+template<class T> inline T Tan(T x, MathMode mode) {return mode == MathMode::Fast ? FastMath::Tan(x) : std::tan(x);}
+template<class T> inline void SinCos(T x, T& s, T& c, MathMode mode)
+{
+  if (mode == MathMode::Fast)
+  {
+    FastMath::SinCos(x, s, c);
+  }
+  else
+  {
+    s = std::sin(x);
+    c = std::cos(x);
+  }
+}
+}
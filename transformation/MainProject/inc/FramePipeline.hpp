@@ -0,0 +1,85 @@
+/**
+ * Frame level pipeline: decode, projection (one stage per flow), quality measure and encode stages connected by bounded queues
+ */
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include "Picture.hpp"
+#include "BoundedQueue.hpp"
+#include "Profiler.hpp"
+
+namespace IMT {
+
+class FramePipeline
+{
+public:
+  typedef std::vector<std::shared_ptr<Picture>> FramePictures; //one picture per flow
+  /** Read the frame frameId of each flow. Called for every frame in order; return an empty vector for a frame that is read but not processed */
+  typedef std::function<FramePictures(int frameId)> DecodeFunction;
+  /** Project the input picture of the flow flowId and return the output picture. Called in frame order for each flow */
+  typedef std::function<std::shared_ptr<Picture>(unsigned int flowId, int frameId, std::shared_ptr<Picture> pict)> ProjectFunction;
+  /** Measure or encode the output pictures of all the flows. Called in frame order */
+  typedef std::function<void(int frameId, const FramePictures& outputPicts)> FrameFunction;
+
+  /** \brief Constructor
+   *
+   * \param nbFlows unsigned int Number of flows (one projection stage per flow)
+   * \param queueSize size_t Maximum number of frames waiting between two stages. If 0 the stages are run sequentially in the calling thread.
+   * \param lockstepMeasure bool If true the projection of a frame starts only once the previous frames are measured
+   *        (required when the measure use the state of a layout that is updated by the projection, i.e. a dynamic layout)
+   * \param profiler Profiler& Profiler of the measures done by the stages
+   *
+   */
+  FramePipeline(unsigned int nbFlows, size_t queueSize, bool lockstepMeasure, Profiler& profiler = Profiler::GetDefault()):
+    m_nbFlows(nbFlows), m_queueSize(queueSize), m_lockstepMeasure(lockstepMeasure), m_profiler(profiler), m_mutex(), m_measured(), m_nbMeasuredFrames(0),
+    m_isAborted(false), m_error(nullptr) {}
+  ~FramePipeline(void) = default;
+
+  /** \brief Run the stages on the frames [0, nbFrames). Each stage has its own thread(s), the frames are processed in order by each stage.
+   *  If a stage throws an exception the pipeline is stopped and the first exception is rethrown.
+   */
+  void Run(int nbFrames, DecodeFunction decode, ProjectFunction project, FrameFunction measure, FrameFunction encode);
+
+  size_t GetQueueSize(void) const {return m_queueSize;}
+
+private:
+  struct FrameJob
+  {
+    FrameJob(void): m_frameId(-1), m_picts() {}
+    FrameJob(int frameId, FramePictures picts): m_frameId(frameId), m_picts(std::move(picts)) {}
+    int m_frameId;
+    FramePictures m_picts;
+  };
+  struct FlowJob
+  {
+    FlowJob(void): m_frameId(-1), m_pict(nullptr) {}
+    FlowJob(int frameId, std::shared_ptr<Picture> pict): m_frameId(frameId), m_pict(std::move(pict)) {}
+    int m_frameId;
+    std::shared_ptr<Picture> m_pict;
+  };
+
+  const unsigned int m_nbFlows;
+  const size_t m_queueSize;
+  const bool m_lockstepMeasure;
+  Profiler& m_profiler;
+
+  std::mutex m_mutex;
+  std::condition_variable m_measured;
+  unsigned long m_nbMeasuredFrames;
+  bool m_isAborted;
+  std::exception_ptr m_error;
+
+  void RunSequential(int nbFrames, DecodeFunction& decode, ProjectFunction& project, FrameFunction& measure, FrameFunction& encode);
+  /** Wait until nbFrames frames are measured. Return false if the pipeline was aborted */
+  bool WaitMeasured(unsigned long nbFrames);
+  void SetMeasured(unsigned long nbFrames);
+  /** Store the first error and unblock all the stages */
+  void Abort(std::exception_ptr error, const std::function<void(void)>& closeQueues);
+};
+}
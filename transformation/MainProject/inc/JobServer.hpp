@@ -0,0 +1,79 @@
+/**
+ * Long running server: receive job configurations on a local socket and run them in the same process (no start up cost per job)
+ */
+#pragma once
+
+#include <string>
+#include <set>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <ostream>
+
+#include "TransJob.hpp"
+
+namespace IMT {
+
+/** Protocol: one JSON message per line in both directions.
+ *  The client sends the configuration of a job as a JSON object with one member per section of the ini file (e.g. {"Global": {...}, "Equirectangular": {...}}).
+ *  The values are the ones of the ini file; the JSON lists (layoutFlow, qualityToComputeList, ...) can be given as strings or as JSON arrays.
+ *  For each job the server answers {"job": id, "event": "accepted"}, then one "quality" message per measured frame and flow, one "frame" message
+ *  per processed frame, and at the end a "done" message (or an "error" message with the error description).
+ *  The jobs of a connection are run one after the other; the jobs of different connections run concurrently and share the task pool,
+ *  the picture pool and the loaded sphere point sets. The process wide settings (TransJob::ConfigureProcess) are set once before the server
+ *  starts: the jobs that set them are rejected.
+ */
+class JobServer
+{
+public:
+  /** \brief Constructor: open the listening socket. Throw std::invalid_argument if the address is not valid or cannot be bound
+   *
+   * \param address const std::string& "unix:<path>" for a Unix socket or "tcp:<port>" for a TCP socket on the loopback interface
+   * \param maxRunningJobs unsigned int Maximum number of jobs run at the same time (at least 1)
+   * \param log std::ostream* Stream for the connection and job messages. nullptr: nothing is printed
+   *
+   */
+  JobServer(const std::string& address, unsigned int maxRunningJobs, std::ostream* log = nullptr);
+  ~JobServer(void);
+  JobServer(const JobServer&) = delete;
+  JobServer& operator=(const JobServer&) = delete;
+
+  /** \brief Accept the connections until Stop is called */
+  void Serve(void);
+  /** \brief Stop accepting connections and close the open ones. Can be called from another thread */
+  void Stop(void);
+
+  /** \brief Parse the JSON configuration of a job. The JSON arrays and objects inside a section are written back as JSON strings, as in the ini file.
+   *  Throw std::invalid_argument if the JSON is not valid or if it sets a process wide setting (TransJob::GetProcessSettingKeys)
+   */
+  static TransJob::Config ParseJobConfig(const std::string& json);
+
+private:
+  std::string m_address;
+  int m_listenFd;
+  const unsigned int m_maxRunningJobs;
+  std::ostream m_nullLog; //no stream buffer: discards everything
+  std::ostream& m_log;
+  std::mutex m_logMutex;
+
+  std::atomic<bool> m_isStopped;
+  std::atomic<int> m_nbJobs;
+  std::mutex m_mutex;
+  std::condition_variable m_jobFinished;
+  unsigned int m_nbRunningJobs;
+  std::set<int> m_connectionFds;
+  std::map<std::thread::id, std::thread> m_connectionThreads;
+  std::vector<std::thread::id> m_finishedThreadIds; //connection threads that can be joined
+
+  void HandleConnection(int fd);
+  /** Join the connection threads that are finished. m_mutex has to be locked */
+  void JoinFinishedThreads(void);
+  /** Run the job described by the json line and send its messages to the connection fd */
+  void RunJob(int fd, std::mutex& sendMutex, const std::string& json);
+  /** Send one line to the connection. Return false if the connection is closed */
+  static bool Send(int fd, std::mutex& sendMutex, const std::string& message);
+};
+}
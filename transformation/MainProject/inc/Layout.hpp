@@ -7,6 +7,9 @@
 #include "VideoReader.hpp"
 #include "VideoWriter.hpp"
 #include "VectorialTrans.hpp"
+#include "VectorBatch.hpp"
+#include "TaskPool.hpp"
+#include "PicturePool.hpp"
 
 #include "Common.hpp"
 
@@ -23,16 +26,27 @@ class Layout
             CoordF m_normalizedFaceCoordinate;
             int m_faceId;
         };
-        Layout(void): m_outWidth(0), m_outHeight(0), m_interpol(Picture::InterpolationTech::BILINEAR), m_isInit(false), m_inputVideoPtr(nullptr), m_outputVideoPtr(nullptr), m_vectorialTrans(nullptr) {};
-        explicit Layout(std::shared_ptr<VectorialTrans> vectorialTrans): m_outWidth(0), m_outHeight(0), m_interpol(Picture::InterpolationTech::BILINEAR), m_isInit(false), m_inputVideoPtr(nullptr), m_outputVideoPtr(nullptr), m_vectorialTrans(vectorialTrans) {};
-        Layout(unsigned int outWidth, unsigned int outHeight, std::shared_ptr<VectorialTrans> vectorialTrans = std::make_shared<VectorialTrans>()): m_outWidth(outWidth), m_outHeight(outHeight), m_interpol(Picture::InterpolationTech::BILINEAR), m_isInit(false), m_inputVideoPtr(nullptr), m_outputVideoPtr(nullptr), m_vectorialTrans(vectorialTrans) {};
+        /**< Scalar type used by ToLayout for the 3d geometry: Double is the reference, Float32 trades some accuracy for speed (see GetGeometryPrecisionError) */
+        enum class GeometryPrecision {Double, Float32};
+        Layout(void): m_outWidth(0), m_outHeight(0), m_interpol(Picture::InterpolationTech::BILINEAR), m_geometryPrecision(GeometryPrecision::Double), m_mathMode(MathMode::Exact), m_maxThreads(0), m_isInit(false), m_inputVideoPtr(nullptr), m_outputVideoPtr(nullptr), m_vectorialTrans(nullptr) {};
+        explicit Layout(std::shared_ptr<VectorialTrans> vectorialTrans): m_outWidth(0), m_outHeight(0), m_interpol(Picture::InterpolationTech::BILINEAR), m_geometryPrecision(GeometryPrecision::Double), m_mathMode(MathMode::Exact), m_maxThreads(0), m_isInit(false), m_inputVideoPtr(nullptr), m_outputVideoPtr(nullptr), m_vectorialTrans(vectorialTrans) {};
+        Layout(unsigned int outWidth, unsigned int outHeight, std::shared_ptr<VectorialTrans> vectorialTrans = std::make_shared<VectorialTrans>()): m_outWidth(outWidth), m_outHeight(outHeight), m_interpol(Picture::InterpolationTech::BILINEAR), m_geometryPrecision(GeometryPrecision::Double), m_mathMode(MathMode::Exact), m_maxThreads(0), m_isInit(false), m_inputVideoPtr(nullptr), m_outputVideoPtr(nullptr), m_vectorialTrans(vectorialTrans) {};
         virtual ~Layout(void) = default;
 
         /*Return the 3D coordinate cartesian of the point corresponding to the pixel with coordinate pixelCoord on the 2d layout*/
         Coord3dCart From2dTo3d(const CoordI& pixelCoord) const;
 
-        /*Return the coordinate of the 2d layout that correspond to the point on the sphere in shperical coordinate sphericalCoord*/
-        CoordF FromSphereTo2d(const Coord3dSpherical& sphericalCoord) const;
+        /*Return the coordinate of the 2d layout that correspond to the direction coord (cartesian coordinate, not necessarily normalized)*/
+        CoordF FromSphereTo2d(const Coord3dCart& coord) const;
+
+        /** \brief Batch version of FromSphereTo2d: out[k] = FromSphereTo2d(coords.Get(start+k)) for k in [0, count).
+         *  By default it maps the points one by one: a layout overrides it to map the points with the array functions of FastMath.
+         */
+        virtual void FromSphereTo2dBatch(const VectorBatch& coords, size_t start, size_t count, CoordF* out) const;
+
+        /*Same as From2dTo3d and FromSphereTo2d with the float32 geometry*/
+        Coord3dCartF32 From2dTo3dF32(const CoordI& pixelCoord) const;
+        CoordF FromSphereTo2dF32(const Coord3dCartF32& coord) const;
 
         /** \brief Function called to init the layout object (have to be called before using the layout object). Call the private virtual function InitImpl.
          */
@@ -42,6 +56,10 @@ class Layout
             relatifTimestamp Time since the beginning of the video
          */
         virtual void NextStep(double relatifTimestamp) {}
+        /** Return true if the geometry of the layout changes with NextStep */
+        virtual bool IsDynamic(void) const {return false;}
+        /** Return true if the left and right borders of the layout are the same points of the sphere (x = 0 and x = width) */
+        virtual bool WrapsHorizontally(void) const {return false;}
 
 
         unsigned int GetWidth(void) const {return m_outWidth;}
@@ -54,11 +72,22 @@ class Layout
         /** \brief Return the surface on the sphere of the corresponding pixel. **/
         double GetSurfacePixel(const CoordI& pixelCoord);
 
+        /** \brief Return the number of faces (or tiles) of this layout. By default the layout has only one face. **/
+        virtual unsigned int GetNbFaces(void) const {return 1;}
+        /** \brief Return the name of the face faceId (same name as in the configuration file when possible) **/
+        virtual std::string GetFaceName(unsigned int faceId) const {return "face"+std::to_string(faceId);}
+        /** \brief Return the id of the face (or tile) that contains the pixel. The id is not in [0, GetNbFaces()) if the pixel is not inside a face. **/
+        int GetFaceId(const CoordI& pixelCoord) const {return From2dToNormalizedFaceInfo(pixelCoord).m_faceId;}
+
         //transform the layoutPic that is a picture in the current layout into a picture with the layout destLayout with the dimention (width, height)
         std::shared_ptr<Picture> ToLayout(const Picture& layoutPic, const Layout& destLayout) const;
         std::shared_ptr<Picture> FromLayout(const Picture& picFromOtherLayout, const Layout& originalLayout) const
         {return originalLayout.ToLayout(picFromOtherLayout, *this);}
 
+        /** \brief Return the largest distance (in pixels of this layout) between the positions computed by ToLayout with the float32 and with the double geometry, for the pixels of destLayout that are on the sphere
+         */
+        double GetGeometryPrecisionError(const Layout& destLayout) const;
+
         void InitInputVideo(std::string pathToInputVideo, unsigned nbFrame)
         {
             if (m_inputVideoPtr == nullptr)
@@ -66,6 +95,11 @@ class Layout
                 m_inputVideoPtr = InitInputVideoImpl(pathToInputVideo, nbFrame);
             }
         }
+        /** \brief Next picture read from the input video is the frame frameId. Return false if the input video cannot seek */
+        bool SeekInputVideo(unsigned frameId)
+        {
+            return m_inputVideoPtr != nullptr && m_inputVideoPtr->Seek(frameId);
+        }
         void InitOutputVideo(std::string pathToOutputVideo, std::string codecId, unsigned fps, unsigned gop_size, std::vector<int> bit_rateVect)
         {
             if (m_outputVideoPtr == nullptr)
@@ -91,12 +125,26 @@ class Layout
                 WritePictureToVideoImpl(pic);
             }
         }
+        /** Input (resp. output) video of the layout, nullptr if it was not initialized */
+        std::shared_ptr<const IMT::LibAv::VideoReader> GetInputVideo(void) const {return m_inputVideoPtr;}
+        std::shared_ptr<const IMT::LibAv::VideoWriter> GetOutputVideo(void) const {return m_outputVideoPtr;}
 
         void SetInterpolationTech(Picture::InterpolationTech interpol) {m_interpol=interpol;}
+        /** \brief Select the scalar type of the geometry used by ToLayout when this layout is the source layout */
+        void SetGeometryPrecision(GeometryPrecision precision) {m_geometryPrecision=precision;}
+        GeometryPrecision GetGeometryPrecision(void) const {return m_geometryPrecision;}
+        /** \brief Select the trigonometry used by the projection of this layout: standard library or polynomial approximations (see FastMath.hpp) */
+        void SetMathMode(MathMode mathMode) {m_mathMode=mathMode;}
+        /** \brief Maximum number of threads of the task pool used by ToLayout when this layout is the source layout (0: no limit) */
+        void SetMaxThreads(unsigned int maxThreads) {m_maxThreads=maxThreads;}
+        unsigned int GetMaxThreads(void) const {return m_maxThreads;}
     protected:
         unsigned int m_outWidth;
         unsigned int m_outHeight;
         Picture::InterpolationTech m_interpol;
+        GeometryPrecision m_geometryPrecision;
+        MathMode m_mathMode;
+        unsigned int m_maxThreads;
         bool m_isInit;
         std::shared_ptr<IMT::LibAv::VideoReader> m_inputVideoPtr;
         std::shared_ptr<IMT::LibAv::VideoWriter> m_outputVideoPtr;
@@ -120,13 +168,13 @@ class Layout
          */
         virtual NormalizedFaceInfo From2dToNormalizedFaceInfo(const CoordI& pixel) const = 0;
 
-        /** \brief Compute the normalized face info corresponding to a given point on the unit sphere
+        /** \brief Compute the normalized face info corresponding to a given direction. The spherical angles should be computed only by the layouts that need them.
          *
-         * \param sphericalCoord Coord3dSpherical& the coordinate of the point in the spherical space
+         * \param coord Coord3dCart& the direction in the cartesian space (not null but not necessarily normalized)
          * \return virtual NormalizedFaceInfo The normalized face info
          *
          */
-        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const = 0;
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dCart& coord) const = 0;
         /** \brief Get the coordinate on the 2d layout from the normalized face info
          *
          * \param ni const NormalizedFaceInfo& The normalized info from which we want to find the pixel on the 2d layout
@@ -141,7 +189,25 @@ class Layout
          *
          */
         virtual Coord3dCart FromNormalizedInfoTo3d(const NormalizedFaceInfo& ni) const = 0;
+
+        /** \brief float32 versions of From3dToNormalizedFaceInfo and FromNormalizedInfoTo3d. By default they go through the double precision functions:
+         *  a layout overrides them to get a native float32 path.
+         */
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfoF32(const Coord3dCartF32& coord) const
+        {
+            return From3dToNormalizedFaceInfo(Coord3dCart(coord));
+        }
+        virtual Coord3dCartF32 FromNormalizedInfoTo3dF32(const NormalizedFaceInfo& ni) const
+        {
+            return Coord3dCartF32(FromNormalizedInfoTo3d(ni));
+        }
     private:
+        /** \brief Compute the position in this layout of the pixel of destLayout with the given geometry precision. Return false if the pixel has no position on the sphere (black pixel). */
+        bool MapPixel(const Layout& destLayout, const CoordI& pixel, GeometryPrecision precision, CoordF& coord) const;
+        /** \brief Same as MapPixel with the double geometry for the whole row of destLayout, mapped with FromSphereTo2dBatch.
+         *  points, coords and onSphere have one element per column of destLayout: onSphere[i] is false for the black pixels.
+         */
+        void MapRow(const Layout& destLayout, unsigned int row, VectorBatch& points, CoordF* coords, char* onSphere) const;
 };
 
 
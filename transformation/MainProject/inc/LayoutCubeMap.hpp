@@ -71,7 +71,7 @@ class LayoutCubeMap: public LayoutCubeMapBased
                            {{pixelEdge, pixelEdge, pixelEdge, pixelEdge, pixelEdge, pixelEdge}}),
                m_maxOffsetCols({{pixelEdge,pixelEdge,pixelEdge}}), m_maxOffsetRows({{pixelEdge,pixelEdge}}),
                m_fp({{Faces::Right, Faces::Back, Faces::Left, Faces::Top, Faces::Front, Faces::Bottom}}, {{0, 0, 0, -90, -90, -90}})
-               {}
+               {InitFaceTable(ComputeFaceRectangles(), ClassificationOrder());}
         virtual ~LayoutCubeMap(void) = default;
 
 
@@ -87,6 +87,9 @@ class LayoutCubeMap: public LayoutCubeMapBased
              return CoordI(4*w, 2*w);
         }
 
+        /** \brief Face of the pixel (i,j) found by testing the offsets of each face, without the face raster (slow: used to check the raster) */
+        Faces From2dToFaceByOffsets(unsigned int i, unsigned int j) const;
+
     protected:
         Faces From2dToFace(unsigned int i, unsigned int j) const;
 
@@ -124,52 +127,50 @@ class LayoutCubeMap: public LayoutCubeMapBased
                 maxOffsetRows[0] = MAX(fr.GetResV(m_face[0]), MAX(fr.GetResV(m_face[1]), fr.GetResV(m_face[2])));
                 maxOffsetRows[1] = MAX(fr.GetResV(m_face[3]), MAX(fr.GetResV(m_face[4]), fr.GetResV(m_face[5])));
             }
-            std::tuple<double, double> GetIJ2dToNorm(double u, double v, Faces f) const
+            static std::tuple<double, double> GetIJ2dToNorm(double u, double v, int rotation)
             {
-                int faceId = m_faceToId.at(f);
-                if (m_rotationFace[faceId] == 0)
+                if (rotation == 0)
                 {
                     return std::make_tuple(u, v);
                 }
-                else if (m_rotationFace[faceId] == -90)
+                else if (rotation == -90)
                 {
                     return std::make_tuple(1-v, u);
                 }
-                else if (m_rotationFace[faceId] == 90)
+                else if (rotation == 90)
                 {
                     return std::make_tuple(v, 1-u);
                 }
-                else if (m_rotationFace[faceId] == 180 || m_rotationFace[faceId] == -180)
+                else if (rotation == 180 || rotation == -180)
                 {
                     return std::make_tuple(1-u, 1-v);
                 }
                 else
                 {
-                    throw std::invalid_argument("GetIJ2dToNorm: Not supported rotation: "+std::to_string(m_rotationFace[faceId]));
+                    throw std::invalid_argument("GetIJ2dToNorm: Not supported rotation: "+std::to_string(rotation));
                 }
             }
-            std::tuple<double, double> GetIJNormTo2d(double u, double v, Faces f) const
+            static std::tuple<double, double> GetIJNormTo2d(double u, double v, int rotation, Faces f)
             {
-                int faceId = m_faceToId.at(f);
-                if (m_rotationFace[faceId] == 0)
+                if (rotation == 0)
                 {
                     return std::make_tuple(u, v);
                 }
-                else if (m_rotationFace[faceId] == -90)
+                else if (rotation == -90)
                 {
                     return std::make_tuple(v, 1-u);
                 }
-                else if (m_rotationFace[faceId] == 90)
+                else if (rotation == 90)
                 {
                     return std::make_tuple(1-v, u);
                 }
-                else if (m_rotationFace[faceId] == 180 || m_rotationFace[faceId] == -180)
+                else if (rotation == 180 || rotation == -180)
                 {
                     return std::make_tuple(1-u, 1-v);
                 }
                 else
                 {
-                    throw std::invalid_argument("GetIJNormTo2d: Not supported rotation: "+std::to_string(m_rotationFace[faceId])+" for facePosition "+std::to_string(faceId) + " for faceId " +std::to_string(static_cast<int>(f)));
+                    throw std::invalid_argument("GetIJNormTo2d: Not supported rotation: "+std::to_string(rotation)+" for faceId " +std::to_string(static_cast<int>(f)));
                 }
             }
         };
@@ -178,7 +179,8 @@ class LayoutCubeMap: public LayoutCubeMapBased
         FacePosition m_fp;
 
         LayoutCubeMap(Quaternion rotationQuaternion, bool useTile, std::shared_ptr<VectorialTrans> vectorialTrans, unsigned int width, unsigned int height, const FaceResolutions& fr, const std::tuple<ColsOffsetArray, RowsOffsetArray>& t, FacePosition fp, bool useEqualArea):
-            LayoutCubeMapBased(width, height, rotationQuaternion, useTile, vectorialTrans, fr, useEqualArea), m_maxOffsetCols(std::get<0>(t)), m_maxOffsetRows(std::get<1>(t)), m_fp(std::move(fp)) {}
+            LayoutCubeMapBased(width, height, rotationQuaternion, useTile, vectorialTrans, fr, useEqualArea), m_maxOffsetCols(std::get<0>(t)), m_maxOffsetRows(std::get<1>(t)), m_fp(std::move(fp))
+            {InitFaceTable(ComputeFaceRectangles(), ClassificationOrder());}
 
         static std::tuple<ColsOffsetArray, RowsOffsetArray> Init(const FaceResolutions& fr, const FacePosition& fp)
         {
@@ -194,10 +196,9 @@ class LayoutCubeMap: public LayoutCubeMapBased
         unsigned int JStartOffset(LayoutCubeMapBased::Faces f) const;
         unsigned int JEndOffset(LayoutCubeMapBased::Faces f) const;
 
-        inline bool InFace(unsigned i, unsigned j, LayoutCubeMapBased::Faces f) const
-        {
-            return inInterval(i, IStartOffset(f), IEndOffset(f)) && inInterval(j, JStartOffset(f), JEndOffset(f));
-        }
+        /** \brief Compute the rectangle and the rotation of each face from the face positions (faces absent from the layout are never matched) */
+        std::array<FaceRectangle,6> ComputeFaceRectangles(void) const;
+        static std::array<Faces,6> ClassificationOrder(void) {return {{Faces::Front, Faces::Back, Faces::Right, Faces::Left, Faces::Top, Faces::Bottom}};}
 
 };
 
@@ -33,7 +33,8 @@ class LayoutCubeMap2: public LayoutCubeMapBased
 		LayoutCubeMap2(unsigned int pixelEdge, bool useTile, std::shared_ptr<VectorialTrans> vectorialTrans):
 		            LayoutCubeMapBased(4*pixelEdge, 3*pixelEdge, Quaternion(1), useTile, vectorialTrans,
                                  {{pixelEdge, pixelEdge, pixelEdge, pixelEdge, pixelEdge, pixelEdge}})
-                    , m_maxOffsetTFB(pixelEdge), m_maxOffsetLFRB(pixelEdge) {}
+                    , m_maxOffsetTFB(pixelEdge), m_maxOffsetLFRB(pixelEdge)
+                    {InitFaceTable(ComputeFaceRectangles(), ClassificationOrder());}
 
         virtual ~LayoutCubeMap2(void) = default;
 
@@ -48,6 +49,9 @@ class LayoutCubeMap2: public LayoutCubeMapBased
              return CoordI(4*w, 2*w);
         }
 
+        /** \brief Face of the pixel (i,j) found by testing the offsets of each face, without the face raster (slow: used to check the raster) */
+        Faces From2dToFaceByOffsets(unsigned int i, unsigned int j) const;
+
     protected:
         Faces From2dToFace(unsigned int i, unsigned int j) const;
 
@@ -63,17 +67,17 @@ class LayoutCubeMap2: public LayoutCubeMapBased
         unsigned int m_maxOffsetLFRB;
 
         LayoutCubeMap2(Quaternion rotationQuaternion, double useTile, std::shared_ptr<VectorialTrans> vectorialTrans, unsigned int width, unsigned int height, const FaceResolutions& fr,unsigned int maxOffsetTFB, unsigned int maxOffsetLFRB):
-            LayoutCubeMapBased(width, height, rotationQuaternion, useTile, vectorialTrans, fr), m_maxOffsetTFB(maxOffsetTFB), m_maxOffsetLFRB(maxOffsetLFRB) {}
+            LayoutCubeMapBased(width, height, rotationQuaternion, useTile, vectorialTrans, fr), m_maxOffsetTFB(maxOffsetTFB), m_maxOffsetLFRB(maxOffsetLFRB)
+            {InitFaceTable(ComputeFaceRectangles(), ClassificationOrder());}
 
         unsigned int IStartOffset(LayoutCubeMapBased::Faces f) const;
         unsigned int IEndOffset(LayoutCubeMapBased::Faces f) const;
         unsigned int JStartOffset(LayoutCubeMapBased::Faces f) const;
         unsigned int JEndOffset(LayoutCubeMapBased::Faces f) const;
 
-        inline bool InFace(unsigned i, unsigned j, LayoutCubeMapBased::Faces f) const
-        {
-            return inInterval(i, IStartOffset(f), IEndOffset(f)) && inInterval(j, JStartOffset(f), JEndOffset(f));
-        }
+        /** \brief Compute the rectangle of each face (the faces are not rotated in this layout) */
+        std::array<FaceRectangle,6> ComputeFaceRectangles(void) const;
+        static std::array<Faces,6> ClassificationOrder(void) {return {{Faces::Left, Faces::Top, Faces::Front, Faces::Bottom, Faces::Right, Faces::Back}};}
 };
 
 }
@@ -2,6 +2,9 @@
 #include "Layout.hpp"
 #include <stdexcept>
 #include <array>
+#include <vector>
+#include <string>
+#include <utility>
 
 namespace IMT {
 
@@ -15,11 +18,20 @@ class LayoutCubeMapBased : public Layout
                            std::shared_ptr<VectorialTrans> vectorialTrans,
                            FaceResolutions fr, bool useEqualArea = false):
             Layout(outWidth, outHeight, vectorialTrans), m_fr(std::move(fr)), m_rotQuaternion(rotationQuaternion),
-            m_faceRotations(), m_useTile(useTile), m_equalArea(useEqualArea)
-            {InitFaceRotations();};
+            m_rotMat(RotMat::FromQuaternion(rotationQuaternion)), m_invRotMat(m_rotMat.Transpose()),
+            m_rotMatF32(m_rotMat), m_invRotMatF32(m_invRotMat), m_useTile(useTile), m_equalArea(useEqualArea),
+            m_faceRectangles(), m_classificationOrder(), m_faceRaster(), m_faceRasterWidth(0), m_faceRasterHeight(0)
+            {}
         virtual ~LayoutCubeMapBased(void) = default;
 
         const bool& UseTile(void) const {return m_useTile;}
+
+        virtual unsigned int GetNbFaces(void) const override {return 6;}
+        virtual std::string GetFaceName(unsigned int faceId) const override
+        {
+            static const std::array<std::string, 6> names = {{"Front", "Back", "Right", "Left", "Top", "Bottom"}};
+            return faceId < names.size() ? names[faceId] : Layout::GetFaceName(faceId);
+        }
     protected:
         struct FaceResolutions
         {
@@ -27,91 +39,117 @@ class LayoutCubeMapBased : public Layout
                 FaceResolutions(void) = delete;
                 FaceResolutions(unsigned int front, unsigned int back, unsigned int right,
                                 unsigned int left, unsigned int top, unsigned int bottom):
-                         m_faces{{std::array<unsigned int,2>{front, front}, std::array<unsigned int,2>{back,back}, std::array<unsigned int,2>{right, right}, std::array<unsigned int,2>{left,left}, std::array<unsigned int,2>{top,top}, std::array<unsigned int,2>{bottom, bottom}}}   {}
+                         m_faces(ToFaceOrder({{std::array<unsigned int,2>{{front, front}}, std::array<unsigned int,2>{{back,back}}, std::array<unsigned int,2>{{right, right}}, std::array<unsigned int,2>{{left,left}}, std::array<unsigned int,2>{{top,top}}, std::array<unsigned int,2>{{bottom, bottom}}}}))   {}
                 FaceResolutions(std::array<std::array<unsigned int,2>, 6> faceResVect)://front, back, left, right, top, bottom
-                    m_faces(std::move(faceResVect))
+                    m_faces(ToFaceOrder(std::move(faceResVect)))
                     {}
-                unsigned int GetResH(const Faces& f) const
+                unsigned int GetResH(const Faces& f) const {return GetFaceRes(f)[0];}
+                unsigned int GetResV(const Faces& f) const {return GetFaceRes(f)[1];}
+            private:
+                std::array<std::array<unsigned int,2>, 6> m_faces; //indexed by the Faces value
+
+                //The input arrays give the Left face before the Right face
+                static std::array<std::array<unsigned int,2>, 6> ToFaceOrder(std::array<std::array<unsigned int,2>, 6> faceResVect)
                 {
-                    switch(f)
-                    {
-                        case Faces::Front:
-                            return m_faces[0][0];
-                        case Faces::Back:
-                            return m_faces[1][0];
-                        case Faces::Top:
-                            return m_faces[4][0];
-                        case Faces::Bottom:
-                            return m_faces[5][0];
-                        case Faces::Right:
-                            return m_faces[3][0];
-                        case Faces::Left:
-                            return m_faces[2][0];
-                        case Faces::Black:
-                            throw std::invalid_argument("GetRes: Black is not a valid face");
-                        case Faces::Last:
-                            throw std::invalid_argument("GetRes: Last is not a valid face");
-                    }
+                    std::swap(faceResVect[static_cast<unsigned>(Faces::Right)], faceResVect[static_cast<unsigned>(Faces::Left)]);
+                    return faceResVect;
                 }
-                unsigned int GetResV(const Faces& f) const
+                const std::array<unsigned int,2>& GetFaceRes(const Faces& f) const
                 {
-                    switch(f)
+                    if (static_cast<unsigned>(f) >= m_faces.size())
                     {
-                        case Faces::Front:
-                            return m_faces[0][1];
-                        case Faces::Back:
-                            return m_faces[1][1];
-                        case Faces::Top:
-                            return m_faces[4][1];
-                        case Faces::Bottom:
-                            return m_faces[5][1];
-                        case Faces::Right:
-                            return m_faces[3][1];
-                        case Faces::Left:
-                            return m_faces[2][1];
-                        case Faces::Black:
-                            throw std::invalid_argument("GetRes: Black is not a valid face");
-                        case Faces::Last:
-                            throw std::invalid_argument("GetRes: Last is not a valid face");
+                        throw std::invalid_argument("GetRes: "+std::string(f == Faces::Black ? "Black" : "Last")+" is not a valid face");
                     }
+                    return m_faces[static_cast<unsigned>(f)];
                 }
-            private:
-                std::array<std::array<unsigned int,2>, 6> m_faces;
         };
 
+        /**< Position of a face in the 2D layout (the ends are inclusive, as in inInterval) and rotation of the face in the layout (in degree) */
+        struct FaceRectangle
+        {
+            FaceRectangle(void): m_iStart(0), m_iEnd(0), m_jStart(0), m_jEnd(0), m_rotation(0), m_inLayout(false) {}
+            FaceRectangle(unsigned int iStart, unsigned int iEnd, unsigned int jStart, unsigned int jEnd, int rotation = 0):
+                m_iStart(iStart), m_iEnd(iEnd), m_jStart(jStart), m_jEnd(jEnd), m_rotation(rotation), m_inLayout(true) {}
+            bool Contains(unsigned int i, unsigned int j) const
+            {
+                return m_inLayout && inInterval(i, m_iStart, m_iEnd) && inInterval(j, m_jStart, m_jEnd);
+            }
+            unsigned int m_iStart;
+            unsigned int m_iEnd;
+            unsigned int m_jStart;
+            unsigned int m_jEnd;
+            int m_rotation;
+            bool m_inLayout;
+        };
+
+        /** \brief Store the rectangle of each face and precompute the face of each pixel of the layout (if the layout is not too large).
+         *  Should be called by the constructor of the child class once the face positions are known.
+         *
+         * \param faceRectangles std::array<FaceRectangle,6> rectangle of each face (indexed by the Faces value)
+         * \param classificationOrder const std::array<Faces,6>& order in which the faces are tested: a pixel on the border of two faces belongs to the first one
+         *
+         */
+        void InitFaceTable(std::array<FaceRectangle,6> faceRectangles, const std::array<Faces,6>& classificationOrder);
+        const FaceRectangle& GetFaceRectangle(Faces f) const {return m_faceRectangles[static_cast<unsigned>(f)];}
+        /** \brief Return the face of the pixel (i,j): one load in the face raster, or a test of each face rectangle outside of the raster */
+        Faces From2dToFaceFromTable(unsigned int i, unsigned int j) const
+        {
+            if (i < m_faceRasterWidth && j < m_faceRasterHeight)
+            {
+                return static_cast<Faces>(m_faceRaster[j*m_faceRasterWidth+i]);
+            }
+            return ClassifyPixel(i, j);
+        }
+
         virtual NormalizedFaceInfo From2dToNormalizedFaceInfo(const CoordI& pixel) const = 0;
 
         virtual CoordF FromNormalizedInfoTo2d(const NormalizedFaceInfo& ni) const = 0;
 
-        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const final;
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dCart& coord) const final;
 
         virtual Coord3dCart FromNormalizedInfoTo3d(const NormalizedFaceInfo& ni) const final;
 
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfoF32(const Coord3dCartF32& coord) const final;
+
+        virtual Coord3dCartF32 FromNormalizedInfoTo3dF32(const NormalizedFaceInfo& ni) const final;
+
         Plan FromFaceToPlan(Faces f) const
         {
-            switch(f)
+            if (f == Faces::Last)
             {
-                case Faces::Front:
-                    return Plan(-1,0,0,1);
-                case Faces::Back:
-                    return Plan(1,0,0,1);
-                case Faces::Top:
-                    return Plan(0,0,-1,1);
-                case Faces::Bottom:
-                    return Plan(0,0,1,1);
-                case Faces::Right:
-                    return Plan(0,-1,0,1);
-                case Faces::Left:
-                    return Plan(0,1,0,1);
-                case Faces::Black:
-                    return Plan(0,0,0,0);
-                case Faces::Last:
-                    throw std::invalid_argument("FaceToPlan: Last is not a valid face");
-
+                throw std::invalid_argument("FaceToPlan: Last is not a valid face");
             }
+            const auto& p = m_facePlans[static_cast<unsigned>(f)];
+            return Plan(p[0], p[1], p[2], p[3]);
         }
 
-        const Quaternion& FaceToRotQuaternion(Faces f) const;
+        /** \brief Return the intersection of the direction with the canonical cube (faces at distance 1 from the center) and the intersected face.
+         *  Same result as intersecting each FromFaceToPlan plan, without trigonometry.
+         *
+         * \param direction const VectorCartesianT<T>& direction in the canonical cube coordinates (double or float32 geometry)
+         * \return std::tuple<VectorCartesianT<T>, Faces> intersection point and intersected face
+         *
+         */
+        template<class T>
+        static std::tuple<VectorCartesianT<T>, Faces> IntersectionCube(const VectorCartesianT<T>& direction);
+
+        /** \brief Rotation matrix that transforms the Front face into the face f (the inverse rotation is its transpose) */
+        static const RotMat& FaceToRotMat(Faces f)
+        {
+            if (f == Faces::Last || f == Faces::Black)
+            {
+                throw std::invalid_argument("FaceToRotMat: Last is not a valid face");
+            }
+            return m_faceRotations[static_cast<unsigned>(f)];
+        }
+        static const RotMatF32& FaceToRotMatF32(Faces f)
+        {
+            if (f == Faces::Last || f == Faces::Black)
+            {
+                throw std::invalid_argument("FaceToRotMatF32: Last is not a valid face");
+            }
+            return m_faceRotationsF32[static_cast<unsigned>(f)];
+        }
 
         unsigned int GetResH(const Faces& f) const {return m_fr.GetResH(f);}
         unsigned int GetResV(const Faces& f) const {return m_fr.GetResV(f);}
@@ -119,11 +157,43 @@ class LayoutCubeMapBased : public Layout
     private:
         FaceResolutions m_fr;
         Quaternion m_rotQuaternion;//GlobalRotation
-        std::array<Quaternion,6> m_faceRotations;
+        RotMat m_rotMat; //m_rotQuaternion as a matrix
+        RotMat m_invRotMat; //inverse of m_rotMat
+        RotMatF32 m_rotMatF32; //m_rotMat for the float32 geometry
+        RotMatF32 m_invRotMatF32;
+        //Compile-time face geometry (indexed by the Faces value): plan (a, b, c, d) of each face (a.x+b.y+c.z+d=0, Black is the null plan) and rotation from the Front face
+        static constexpr SCALAR m_facePlans[7][4] = {
+            {-1, 0, 0, 1}, //Front
+            {1, 0, 0, 1}, //Back
+            {0, -1, 0, 1}, //Right
+            {0, 1, 0, 1}, //Left
+            {0, 0, -1, 1}, //Top
+            {0, 0, 1, 1}, //Bottom
+            {0, 0, 0, 0} //Black
+        };
+        static constexpr RotMat m_faceRotations[6] = {
+            RotMat(1, 0, 0,   0, 1, 0,   0, 0, 1), //Front
+            RotMat(-1, 0, 0,   0, -1, 0,   0, 0, 1), //Back: pi around z
+            RotMat(0, -1, 0,   1, 0, 0,   0, 0, 1), //Right: pi/2 around z
+            RotMat(0, 1, 0,   -1, 0, 0,   0, 0, 1), //Left: -pi/2 around z
+            RotMat(0, 0, -1,   0, 1, 0,   1, 0, 0), //Top: -pi/2 around y
+            RotMat(0, 0, 1,   0, 1, 0,   -1, 0, 0) //Bottom: pi/2 around y
+        };
+        static constexpr RotMatF32 m_faceRotationsF32[6] = {
+            RotMatF32(m_faceRotations[0]), RotMatF32(m_faceRotations[1]), RotMatF32(m_faceRotations[2]),
+            RotMatF32(m_faceRotations[3]), RotMatF32(m_faceRotations[4]), RotMatF32(m_faceRotations[5])
+        };
         bool m_useTile;
         bool m_equalArea;
+        //Face tables computed by InitFaceTable
+        static constexpr unsigned long m_maxFaceRasterSize = 1ul << 26; //above this number of pixels, the faces are found by testing the rectangles
+        std::array<FaceRectangle,6> m_faceRectangles;
+        std::array<Faces,6> m_classificationOrder;
+        std::vector<signed char> m_faceRaster;
+        unsigned int m_faceRasterWidth;
+        unsigned int m_faceRasterHeight;
 
-        void InitFaceRotations(void);
+        Faces ClassifyPixel(unsigned int i, unsigned int j) const;
 };
 
 }
@@ -7,7 +7,9 @@ class LayoutEquirectangular: public Layout
 {
     public:
         LayoutEquirectangular(unsigned int width, unsigned int height, Quaternion rotationQuaternion, std::shared_ptr<VectorialTrans> vectorialTrans):
-            Layout(width, height, vectorialTrans),  m_rotationQuaternion(rotationQuaternion) {}
+            Layout(width, height, vectorialTrans),  m_rotationQuaternion(rotationQuaternion),
+            m_rotMat(RotMat::FromQuaternion(rotationQuaternion)), m_invRotMat(m_rotMat.Transpose()),
+            m_rotMatF32(m_rotMat), m_invRotMatF32(m_invRotMat) {}
         virtual ~LayoutEquirectangular(void) = default;
 
         virtual CoordI GetReferenceResolution(void) override
@@ -15,6 +17,10 @@ class LayoutEquirectangular: public Layout
             return CoordI(GetWidth(), GetHeight());
         }
 
+        virtual bool WrapsHorizontally(void) const override {return true;}
+
+        virtual void FromSphereTo2dBatch(const VectorBatch& coords, size_t start, size_t count, CoordF* out) const override;
+
     protected:
         virtual NormalizedFaceInfo From2dToNormalizedFaceInfo(const CoordI& pixel) const override
         {
@@ -24,10 +30,10 @@ class LayoutEquirectangular: public Layout
         {
             return CoordF(ni.m_normalizedFaceCoordinate.x*GetWidth(), ni.m_normalizedFaceCoordinate.y * GetHeight());
         }
-        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const override
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dCart& coord) const override
         {
           // Coord3dSpherical rotCoord = Rotation(sphericalCoord, m_rotationQuaternion.Inv());
-            Coord3dSpherical rotCoord = Rotation(Coord3dCart(sphericalCoord/sphericalCoord.Norm()), m_rotationQuaternion.Inv());
+            Coord3dCart rotCoord = Rotation(coord, m_invRotMat);
             // if (m_vectorOffsetRatio != 0)
             // {
             //   auto theta = rotCoord.GetTheta();
@@ -38,7 +44,7 @@ class LayoutEquirectangular: public Layout
             // }
             // else
             // {
-              return NormalizedFaceInfo(CoordF(0.5+rotCoord.GetTheta()/ (2.0*PI()), rotCoord.GetPhi() / PI()), 0);
+              return NormalizedFaceInfo(CoordF(0.5+rotCoord.GetTheta(m_mathMode)/ (2.0*PI()), rotCoord.GetPhi(m_mathMode) / PI()), 0);
             // }
         }
         virtual Coord3dCart FromNormalizedInfoTo3d(const NormalizedFaceInfo& ni) const override
@@ -51,17 +57,29 @@ class LayoutEquirectangular: public Layout
             // double phiBis = std::acos(std::cos(phi)/std::sqrt(m_vectorOffsetRatio*m_vectorOffsetRatio + m_vectorOffsetRatio*std::sin(phi)*std::cos(theta)+1));
             // std::cout << Rotation(Coord3dSpherical(1, theta, phi)+m_vectorOffsetRatio*Coord3dCart(1, 0, 0), m_rotationQuaternion) << "; "<< Rotation(Coord3dSpherical(1, thetaBis, phiBis), m_rotationQuaternion) << std::endl;
             // return Rotation(Coord3dSpherical(1, thetaBis, phiBis), m_rotationQuaternion);
-            Coord3dSpherical v0 = Coord3dSpherical(1, theta, phi);
+            Coord3dCart v0 = Coord3dCart::FromSpherical(theta, phi, m_mathMode);
             // + m_vectorOffsetRatio*Coord3dCart(1, 0, 0);
 
-            auto v = Rotation(v0, m_rotationQuaternion);
+            auto v = Rotation(v0, m_rotMat);
             return v;
         }
 
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfoF32(const Coord3dCartF32& coord) const override
+        {
+            Coord3dCartF32 rotCoord = Rotation(coord, m_invRotMatF32);
+            return NormalizedFaceInfo(CoordF(0.5f+rotCoord.GetTheta(m_mathMode)/(2.f*float(PI())), rotCoord.GetPhi(m_mathMode)/float(PI())), 0);
+        }
+        virtual Coord3dCartF32 FromNormalizedInfoTo3dF32(const NormalizedFaceInfo& ni) const override
+        {
+            float theta = 2.f*float(PI())*(float(ni.m_normalizedFaceCoordinate.x)-0.5f);
+            float phi = float(PI())*float(ni.m_normalizedFaceCoordinate.y);
+            return Rotation(Coord3dCartF32::FromSpherical(theta, phi, m_mathMode), m_rotMatF32);
+        }
+
         virtual std::shared_ptr<Picture> ReadNextPictureFromVideoImpl(void) override
         {
             auto matptr = m_inputVideoPtr->GetNextPicture(0);
-            return std::make_shared<Picture>(matptr->clone());
+            return PicturePool::GetDefault()->Adopt(*matptr);
         }
 
         virtual void WritePictureToVideoImpl(std::shared_ptr<Picture> pict) override
@@ -90,5 +108,10 @@ class LayoutEquirectangular: public Layout
         }
     private:
         Quaternion m_rotationQuaternion;
+        RotMat m_rotMat; //m_rotationQuaternion as a matrix
+        RotMat m_invRotMat; //inverse of m_rotMat
+        RotMatF32 m_rotMatF32; //m_rotMat for the float32 geometry
+        RotMatF32 m_invRotMatF32;
+        static constexpr size_t m_batchSize = 256; //number of points mapped together by FromSphereTo2dBatch (the temporary arrays stay in the L1 cache)
 };
 }
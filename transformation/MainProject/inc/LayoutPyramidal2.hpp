@@ -49,7 +49,7 @@ class LayoutPyramidal2 : public LayoutPyramidalBased
 	    }
 
         LayoutPyramidal2(double baseEdge, Quaternion rotationQuaternion, bool useTile, std::shared_ptr<VectorialTrans> vectorialTrans, unsigned int pixelBaseEdge):
-            LayoutPyramidalBased(baseEdge, rotationQuaternion, 3*pixelBaseEdge, 3*pixelBaseEdge, useTile, vectorialTrans, {{pixelBaseEdge,pixelBaseEdge,pixelBaseEdge,pixelBaseEdge,pixelBaseEdge}}) {std::cout << 3*pixelBaseEdge<<std::endl;};
+            LayoutPyramidalBased(baseEdge, rotationQuaternion, 3*pixelBaseEdge, 3*pixelBaseEdge, useTile, vectorialTrans, {{pixelBaseEdge,pixelBaseEdge,pixelBaseEdge,pixelBaseEdge,pixelBaseEdge}}) {};
         virtual ~LayoutPyramidal2(void) = default;
 
         virtual CoordI GetReferenceResolution(void) override
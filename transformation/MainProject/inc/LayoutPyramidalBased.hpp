@@ -18,40 +18,36 @@ class LayoutPyramidalBased : public Layout
              m_interTop((1-std::pow(m_alpha,2))/(1+std::pow(m_alpha,2)),0,2*m_alpha/(1+std::pow(m_alpha,2))),
              m_pyramidHeight((m_top-Coord3dCart(1,0,0)).Norm()),
              m_topHeight((m_top-Coord3dCart(1,0,m_alpha)).Norm()),
-             m_intersectionHeight((m_interTop-Coord3dCart(1,0,m_alpha)).Norm()), m_fr(std::move(fr)),
+             m_intersectionHeight((m_interTop-Coord3dCart(1,0,m_alpha)).Norm()),
+             m_facePlans(ComputeFacePlans(m_canonicTopPlan)), m_useTile(useTile), m_fr(std::move(fr)),
              m_rotQuaternion(rotationQuaternion),
-             m_useTile(useTile)
+             m_rotMat(RotMat::FromQuaternion(rotationQuaternion)), m_invRotMat(m_rotMat.Transpose())
              {}
 
     const bool& UseTile(void) const {return m_useTile;}
 
+    virtual unsigned int GetNbFaces(void) const override {return 5;}
+    virtual std::string GetFaceName(unsigned int faceId) const override
+    {
+        static const std::array<std::string, 5> names = {{"Base", "Left", "Right", "Top", "Bottom"}};
+        return faceId < names.size() ? names[faceId] : Layout::GetFaceName(faceId);
+    }
+
     protected:
         virtual NormalizedFaceInfo From2dToNormalizedFaceInfo(const CoordI& pixel) const = 0;
         virtual CoordF FromNormalizedInfoTo2d(const NormalizedFaceInfo& ni) const = 0;
         //Return coordinate value between [0;1] for each face
-        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const final;
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dCart& coord) const final;
         //Expect coordinate value to be in the [0;1] range for each face
         virtual Coord3dCart FromNormalizedInfoTo3d(const NormalizedFaceInfo& ni) const final;
 
-        Plan FaceToPlan(Faces f) const // return the (a, b, c, d) vector corresponding to the equation of the plan contening the face f: a.x+b.y+c.z+d=0 for the canonical pyramid
+        const Plan& FaceToPlan(Faces f) const // return the (a, b, c, d) vector corresponding to the equation of the plan contening the face f: a.x+b.y+c.z+d=0 for the canonical pyramid
         {
-            switch (f)
+            if (f == Faces::Last)
             {
-            case Faces::Base:
-                return Plan(1,0,0,-1);
-            case Faces::Top:
-                return Plan( m_canonicTopPlan[0], m_canonicTopPlan[1], m_canonicTopPlan[2], m_canonicTopPlan[3]);
-            case Faces::Left:
-                return Plan( m_canonicTopPlan[0], -m_canonicTopPlan[2], m_canonicTopPlan[1], m_canonicTopPlan[3]);
-            case Faces::Bottom:
-                return Plan( m_canonicTopPlan[0], -m_canonicTopPlan[1], -m_canonicTopPlan[2], m_canonicTopPlan[3]);
-            case Faces::Right:
-                return Plan( m_canonicTopPlan[0], m_canonicTopPlan[2], -m_canonicTopPlan[1], m_canonicTopPlan[3]);
-            case Faces::Black:
-                return Plan(0,0,0,0);
-            case Faces::Last:
                 throw std::invalid_argument("FaceToPlan: Last is not a valid face");
             }
+            return m_facePlans[static_cast<unsigned>(f)];
         }
 
         unsigned int GetRes(const Faces& f) const {return m_fr.GetRes(f);}
@@ -68,22 +64,11 @@ class LayoutPyramidalBased : public Layout
                     {}
                 unsigned int GetRes(const Faces& f) const
                 {
-                    switch(f)
+                    if (static_cast<unsigned>(f) >= m_faces.size())
                     {
-                        case Faces::Base:
-                            return m_faces[0];
-                        case Faces::Top:
-                            return m_faces[3];
-                        case Faces::Bottom:
-                            return m_faces[4];
-                        case Faces::Right:
-                            return m_faces[2];
-                        case Faces::Left:
-                            return m_faces[1];
-                        case Faces::Black:
-                        case Faces::Last:
-                            throw std::invalid_argument("GetRes: Last is not a valid face");
+                        throw std::invalid_argument("GetRes: Last is not a valid face");
                     }
+                    return m_faces[static_cast<unsigned>(f)];
                 }
             private:
                 std::array<unsigned int, 5> m_faces;
@@ -101,11 +86,15 @@ class LayoutPyramidalBased : public Layout
       double m_pyramidHeight; //Height of the pyramid (base to top)
       double m_topHeight; //Height of the top face (from (1, 0, m_alpha) to m_top
       double m_intersectionHeight; //Distance between (1, 0, m_alpha) and m_interTop
+      std::array<Plan, 6> m_facePlans; //Plan of each face (indexed by the Faces value, Black is the null plan). They depend on the base edge: computed once by the constructor
       bool m_useTile;
 
       double UsePlanEquation(double x) const; //compute the value of z knowing the value of x (for the top plan in the canonic pyramid)
+      static std::array<Plan, 6> ComputeFacePlans(const Plan& canonicTopPlan); //the other side faces are the top face rotated around the x axis
       FaceResolutions m_fr;
       Quaternion m_rotQuaternion;
+      RotMat m_rotMat; //m_rotQuaternion as a matrix
+      RotMat m_invRotMat; //inverse of m_rotMat
 
 };
 }
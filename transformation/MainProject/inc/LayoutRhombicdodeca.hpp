@@ -2,6 +2,8 @@
 #include "LayoutRhombicdodecaBased.hpp"
 #include <stdexcept>
 #include <algorithm>
+#include <array>
+#include <string>
 
 namespace IMT {
 
@@ -14,7 +16,7 @@ class LayoutRhombicdodeca: public LayoutRhombicdodecaBased
             return std::shared_ptr<LayoutRhombicdodeca>( new LayoutRhombicdodeca(rotationQuaternion, vectorialTrans, useTile, std::move(fr)) );
 	    }
         LayoutRhombicdodeca(unsigned int height, bool useTile, std::shared_ptr<VectorialTrans> vectorialTrans): LayoutRhombicdodecaBased(Quaternion(1), vectorialTrans, useTile,{{height,height,height,height,
-            height,height,height,height,height,height,height,height}}), m_colsMaxOffset(), m_rowsMaxOffset() {}
+            height,height,height,height,height,height,height,height}}), m_colsMaxOffset(), m_rowsMaxOffset(), m_faceOffsets() {}
         virtual ~LayoutRhombicdodeca(void) = default;
 
         virtual CoordI GetReferenceResolution(void) override
@@ -33,7 +35,7 @@ class LayoutRhombicdodeca: public LayoutRhombicdodecaBased
         virtual CoordF FromNormalizedInfoTo2d(const NormalizedFaceInfo& ni) const override;
 
 
-        LayoutRhombicdodeca(Quaternion rotationQuaternion, std::shared_ptr<VectorialTrans> vectorialTrans, bool useTile, FaceResolutions&& fr): LayoutRhombicdodecaBased(rotationQuaternion, vectorialTrans, useTile, fr), m_colsMaxOffset(), m_rowsMaxOffset() {}
+        LayoutRhombicdodeca(Quaternion rotationQuaternion, std::shared_ptr<VectorialTrans> vectorialTrans, bool useTile, FaceResolutions&& fr): LayoutRhombicdodecaBased(rotationQuaternion, vectorialTrans, useTile, fr), m_colsMaxOffset(), m_rowsMaxOffset(), m_faceOffsets() {}
 
         Faces LayoutToFace(unsigned int i, unsigned int j) const;
 
@@ -58,12 +60,13 @@ class LayoutRhombicdodeca: public LayoutRhombicdodecaBased
             for (auto& h: m_rowsMaxOffset) {totalHeight += h;}
             SetWidth(totalWidth);
             SetHeight(totalHeight);
+            InitFaceOffsets();
         }
 
-        unsigned int IStartOffset(Faces f) const;
-        unsigned int IEndOffset(Faces f) const;
-        unsigned int JStartOffset(Faces f) const;
-        unsigned int JEndOffset(Faces f) const;
+        unsigned int IStartOffset(Faces f) const {return GetFaceOffsets(f)[0];}
+        unsigned int IEndOffset(Faces f) const {return GetFaceOffsets(f)[1];}
+        unsigned int JStartOffset(Faces f) const {return GetFaceOffsets(f)[2];}
+        unsigned int JEndOffset(Faces f) const {return GetFaceOffsets(f)[3];}
 
         inline bool InFace(unsigned i, unsigned j, Faces f) const
         {
@@ -79,6 +82,10 @@ class LayoutRhombicdodeca: public LayoutRhombicdodecaBased
 
         ColsOffsetArray m_colsMaxOffset;
         RowsOffsetArray m_rowsMaxOffset;
+        std::array<std::array<unsigned int, 4>, 12> m_faceOffsets; //IStart, IEnd, JStart and JEnd of each face, computed once by InitImpl
+
+        void InitFaceOffsets(void);
+        const std::array<unsigned int, 4>& GetFaceOffsets(Faces f) const;
 };
 
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "Layout.hpp"
 #include <stdexcept>
+#include <array>
+#include <tuple>
+#include <string>
 
 namespace IMT {
 
@@ -12,10 +15,13 @@ class LayoutRhombicdodecaBased: public Layout
         enum class Faces{ Face1, Face2, Face3, Face4, Face5, Face6, Face7, Face8, Face9, Face10, Face11, Face12, Black, Last, First=Face1 };
 
         const bool& UseTile(void) const {return m_useTile;}
+
+        virtual unsigned int GetNbFaces(void) const override {return 12;}
+        virtual std::string GetFaceName(unsigned int faceId) const override {return "Face"+std::to_string(faceId+1);}
     protected:
         virtual NormalizedFaceInfo From2dToNormalizedFaceInfo(const CoordI& pixel) const = 0;
         virtual CoordF FromNormalizedInfoTo2d(const NormalizedFaceInfo& ni) const = 0;
-        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const final;
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dCart& coord) const final;
         virtual Coord3dCart FromNormalizedInfoTo3d(const NormalizedFaceInfo& ni) const final;
 
 
@@ -28,89 +34,92 @@ class LayoutRhombicdodecaBased: public Layout
                     {}
                 unsigned int GetRes(const Faces& f) const
                 {
-                    switch(f)
+                    if (static_cast<unsigned>(f) >= m_faces.size())
                     {
-                        case Faces::Face1:
-                            return m_faces[0];
-                        case Faces::Face2:
-                            return m_faces[1];
-                        case Faces::Face3:
-                            return m_faces[2];
-                        case Faces::Face4:
-                            return m_faces[3];
-                        case Faces::Face5:
-                            return m_faces[4];
-                        case Faces::Face6:
-                            return m_faces[5];
-                        case Faces::Face7:
-                            return m_faces[6];
-                        case Faces::Face8:
-                            return m_faces[7];
-                        case Faces::Face9:
-                            return m_faces[8];
-                        case Faces::Face10:
-                            return m_faces[9];
-                        case Faces::Face11:
-                            return m_faces[10];
-                        case Faces::Face12:
-                            return m_faces[11];
-                        case Faces::Black:
-                            throw std::invalid_argument("GetRes: Black is not a valid face");
-                        case Faces::Last:
-                            throw std::invalid_argument("GetRes: Last is not a valid face");
+                        throw std::invalid_argument("GetRes: "+std::string(f == Faces::Black ? "Black" : "Last")+" is not a valid face");
                     }
+                    return m_faces[static_cast<unsigned>(f)];
                 }
             private:
                 std::array<unsigned int, 12> m_faces;
         };
 
         LayoutRhombicdodecaBased(Quaternion rotationQuaternion, std::shared_ptr<VectorialTrans> vectorialTrans, bool useTile, FaceResolutions fr): Layout(vectorialTrans), m_fr(std::move(fr)),
-          m_rotQuaternion(rotationQuaternion), m_faceRotations(), m_useTile(useTile) {InitFaceRotations();}
+          m_rotQuaternion(rotationQuaternion),
+          m_rotMat(RotMat::FromQuaternion(rotationQuaternion)), m_invRotMat(m_rotMat.Transpose()), m_useTile(useTile) {}
         Plan FaceToPlan(Faces f) const
         {
-            switch(f)
+            if (f == Faces::Last)
             {
-                case Faces::Face1:
-                    return Plan(-1,0,0,1);
-                case Faces::Face2:
-                    return Plan(-1,-std::sqrt(2),-1,2);
-                case Faces::Face3:
-                    return Plan(-1,-std::sqrt(2),1,2);
-                case Faces::Face4:
-                    return Plan(-1,std::sqrt(2),-1,2);
-                case Faces::Face5:
-                    return Plan(-1,std::sqrt(2),1,2);
-                case Faces::Face6:
-                    return Plan(0,0,1,1);
-                case Faces::Face7:
-                    return Plan(1,std::sqrt(2),1,2);
-                case Faces::Face8:
-                    return Plan(1,-std::sqrt(2),1,2);
-                case Faces::Face9:
-                    return Plan(1,-std::sqrt(2),-1,2);
-                case Faces::Face10:
-                    return Plan(1,std::sqrt(2),-1,2);
-                case Faces::Face11:
-                    return Plan(0,0,-1,1);
-                case Faces::Face12:
-                    return Plan(1,0,0,1);
-                case Faces::Black:
-                    return Plan(0,0,0,0);
-                case Faces::Last:
-                    throw std::invalid_argument("FaceToPlan: Last is not a valid face");
+                throw std::invalid_argument("FaceToPlan: Last is not a valid face");
             }
+            const auto& p = m_facePlans[static_cast<unsigned>(f)];
+            return Plan(p[0], p[1], p[2], p[3]);
         }
 
-        const Quaternion& FaceToRotQuaternion(Faces f) const; //Rot matrix to transform Face1 into f
+        /** \brief Return the intersection of the direction with the canonical rhombic dodecahedron and the intersected face.
+         *  Same result as intersecting each FaceToPlan plan, with one dot product per face and without trigonometry.
+         *
+         * \param direction const Coord3dCart& unit vector in the canonical rhombic dodecahedron coordinates
+         * \return std::tuple<Coord3dCart, Faces> intersection point and intersected face
+         *
+         */
+        static std::tuple<Coord3dCart, Faces> IntersectionRhombicdodeca(const Coord3dCart& direction);
+
+        static const RotMat& FaceToRotMat(Faces f) //Rot matrix to transform Face1 into f
+        {
+            if (f == Faces::Black || f == Faces::Last)
+            {
+                throw std::invalid_argument("FaceToRotMat: "+std::string(f == Faces::Black ? "Black" : "Last")+" is not a valid face");
+            }
+            return m_faceRotations[static_cast<unsigned>(f)];
+        }
 
         unsigned int GetRes(Faces f) const {return m_fr.GetRes(f);}
     private:
         FaceResolutions m_fr;
         Quaternion m_rotQuaternion;
-        std::array<Quaternion,12> m_faceRotations;
+        RotMat m_rotMat; //m_rotQuaternion as a matrix
+        RotMat m_invRotMat; //inverse of m_rotMat
         bool m_useTile;
 
-        void InitFaceRotations(void);
+        //Compile-time face geometry (indexed by the Faces value)
+        static constexpr SCALAR m_sqrt2 = 1.41421356237309504880;
+        static constexpr SCALAR m_s = m_sqrt2/2;
+        //plan (a, b, c, d) of each face: a.x+b.y+c.z+d=0 (Black is the null plan)
+        static constexpr SCALAR m_facePlans[13][4] = {
+            {-1, 0, 0, 1},
+            {-1, -m_sqrt2, -1, 2}, {-1, -m_sqrt2, 1, 2}, {-1, m_sqrt2, -1, 2}, {-1, m_sqrt2, 1, 2},
+            {0, 0, 1, 1},
+            {1, m_sqrt2, 1, 2}, {1, -m_sqrt2, 1, 2}, {1, -m_sqrt2, -1, 2}, {1, m_sqrt2, -1, 2},
+            {0, 0, -1, 1},
+            {1, 0, 0, 1},
+            {0, 0, 0, 0}
+        };
+        //-(a,b,c)/d for each face plan: the closest face in a direction maximizes the dot product with this normal
+        static constexpr Coord3dCart m_faceNormals[12] = {
+            Coord3dCart(1, 0, 0),
+            Coord3dCart(0.5, m_s, 0.5), Coord3dCart(0.5, m_s, -0.5), Coord3dCart(0.5, -m_s, 0.5), Coord3dCart(0.5, -m_s, -0.5),
+            Coord3dCart(0, 0, -1),
+            Coord3dCart(-0.5, -m_s, -0.5), Coord3dCart(-0.5, m_s, -0.5), Coord3dCart(-0.5, m_s, 0.5), Coord3dCart(-0.5, -m_s, 0.5),
+            Coord3dCart(0, 0, 1),
+            Coord3dCart(-1, 0, 0)
+        };
+        //Rotation that transforms Face1 into each face (matrices of the unit quaternions previously used for the face rotations)
+        static constexpr RotMat m_faceRotations[12] = {
+            RotMat(1, 0, 0,   0, 1, 0,   0, 0, 1),
+            RotMat(0.5, m_s, 0.5,   m_s, 0, -m_s,   -0.5, m_s, -0.5),
+            RotMat(0.5, -m_s, 0.5,   m_s, 0, -m_s,   0.5, m_s, 0.5),
+            RotMat(1.0/3, -4*m_s/9, 8.0/9,   4*m_s/3, 1.0/9, -4*m_s/9,   0, 4*m_s/3, 1.0/3),
+            RotMat(0.5, -m_s, -0.5,   -m_s, 0, -m_s,   0.5, m_s, -0.5),
+            RotMat(0, 0, -1,   0, 1, 0,   1, 0, 0),
+            RotMat(-0.5, -m_s, -0.5,   m_s, 0, -m_s,   0.5, -m_s, 0.5),
+            RotMat(-0.5, m_s, -0.5,   -m_s, 0, m_s,   0.5, m_s, 0.5),
+            RotMat(-0.5, m_s, 0.5,   -m_s, 0, -m_s,   -0.5, -m_s, 0.5),
+            RotMat(-0.5, -m_s, 0.5,   m_s, 0, m_s,   -0.5, m_s, 0.5),
+            RotMat(0, 0, 1,   0, 1, 0,   -1, 0, 0),
+            RotMat(-1, 0, 0,   0, -1, 0,   0, 0, 1)
+        };
 };
 
 }
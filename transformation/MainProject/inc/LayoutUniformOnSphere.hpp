@@ -1,14 +1,16 @@
 #pragma once
 
 #include "Layout.hpp"
-#include "sphere_655362.hpp"
+#include "SpherePointSet.hpp"
 
 namespace IMT {
 class LayoutUniformOnSphere: public Layout
 {
     public:
-        LayoutUniformOnSphere(Quaternion rotationQuaternion, std::shared_ptr<VectorialTrans> vectorialTrans):
-            Layout(1584, 414, vectorialTrans),  m_rotationQuaternion(rotationQuaternion) {}
+        /** \brief Each pixel of the layout is one of the nbPoints points of the uniform sampling of the sphere (row by row). The pixels after the last point stay black. **/
+        LayoutUniformOnSphere(Quaternion rotationQuaternion, std::shared_ptr<VectorialTrans> vectorialTrans, unsigned long nbPoints = SpherePointSet::DefaultNbPoints, unsigned int width = 1584):
+            Layout(width, (nbPoints+width-1)/width, vectorialTrans),  m_rotationQuaternion(rotationQuaternion),
+            m_rotMat(RotMat::FromQuaternion(rotationQuaternion)), m_pointSet(SpherePointSet::Get(nbPoints)) {}
         virtual ~LayoutUniformOnSphere(void) = default;
 
         virtual CoordI GetReferenceResolution(void) override
@@ -25,7 +27,7 @@ class LayoutUniformOnSphere: public Layout
         {
             return CoordF(ni.m_normalizedFaceCoordinate.x*GetWidth(), ni.m_normalizedFaceCoordinate.y * GetHeight());
         }
-        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const override
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dCart& coord) const override
         {
             return NormalizedFaceInfo(CoordF(0.5, 0.5), 0);
         }
@@ -33,18 +35,22 @@ class LayoutUniformOnSphere: public Layout
         {
             int i = ni.m_normalizedFaceCoordinate.x * (GetWidth()-1);
             int j = ni.m_normalizedFaceCoordinate.y * GetHeight();
-            int p = i + j*GetWidth();
+            unsigned long p = i + j*GetWidth();
             //int p = i*GetHeight()+j;
-            Coord3dSpherical v0(1, uniformPointOneSphere[2*p+1]*PI()/180.f, uniformPointOneSphere[2*p]*PI()/180.f+PI()/2.f);
+            if (p >= m_pointSet->GetNbPoints())
+            {
+                return Coord3dCart(0, 0, 0);
+            }
+            Coord3dCart v0 = m_pointSet->GetCartesianPoints().Get(p);
 
-            auto v = Rotation(v0, m_rotationQuaternion);
+            auto v = Rotation(v0, m_rotMat);
             return v;
         }
 
         virtual std::shared_ptr<Picture> ReadNextPictureFromVideoImpl(void) override
         {
             auto matptr = m_inputVideoPtr->GetNextPicture(0);
-            return std::make_shared<Picture>(matptr->clone());
+            return PicturePool::GetDefault()->Adopt(*matptr);
         }
 
         virtual void WritePictureToVideoImpl(std::shared_ptr<Picture> pict) override
@@ -73,5 +79,7 @@ class LayoutUniformOnSphere: public Layout
         }
     private:
         Quaternion m_rotationQuaternion;
+        RotMat m_rotMat; //m_rotationQuaternion as a matrix
+        std::shared_ptr<const SpherePointSet> m_pointSet;
 };
 }
@@ -22,10 +22,11 @@ class LayoutViewport: public Layout
         {
           m_dynamicPosition.SetNextPosition(relatifTimestamp);
         }
+        virtual bool IsDynamic(void) const override {return true;}
     protected:
         virtual NormalizedFaceInfo From2dToNormalizedFaceInfo(const CoordI& pixel) const override;
         virtual CoordF FromNormalizedInfoTo2d(const NormalizedFaceInfo& ni) const override;
-        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const override;
+        virtual NormalizedFaceInfo From3dToNormalizedFaceInfo(const Coord3dCart& coord) const override;
         virtual Coord3dCart FromNormalizedInfoTo3d(const NormalizedFaceInfo& ni) const override;
 
         virtual std::shared_ptr<Picture> ReadNextPictureFromVideoImpl(void) override;
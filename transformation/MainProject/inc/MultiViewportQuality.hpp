@@ -0,0 +1,57 @@
+/**
+ * Compute in one pass the quality inside the viewports of a set of users (head position traces)
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+
+#include "Common.hpp"
+#include "Layout.hpp"
+#include "Picture.hpp"
+#include "dynamicPosition.hpp"
+
+namespace IMT {
+
+class MultiViewportQuality
+{
+public:
+  /** \brief Constructor
+   *
+   * \param pathToTraces const std::vector<std::string>& Path to the head position traces (one trace per user, same format as the DynamicPosition traces)
+   * \param viewportGeometry std::shared_ptr<Layout> Initialized flatFixed or viewport layout with a static identity position. It gives the viewport geometry shared by all users.
+   * \param pathToOutput std::string Path to the output table (one line per frame, user and tested flow)
+   * \param interpol Picture::InterpolationTech Interpolation used to extract the viewports
+   *
+   */
+  MultiViewportQuality(const std::vector<std::string>& pathToTraces, std::shared_ptr<Layout> viewportGeometry, std::string pathToOutput, Picture::InterpolationTech interpol);
+  ~MultiViewportQuality(void) = default;
+
+  /** \brief Move the head position of each user to the relatifTimestamp
+   */
+  void NextStep(double relatifTimestamp);
+
+  /** \brief Extract the viewport of each user from each final picture and write the PSNR and SSIM of each tested viewport compared to the reference viewport.
+   *
+   * \param frameId unsigned int Id of the frame written in the output table
+   * \param finalPicts const std::vector<std::shared_ptr<Picture>>& Final picture of each flow. The first one is the reference.
+   * \param finalLayouts const std::vector<std::shared_ptr<Layout>>& Layout of each final picture
+   *
+   */
+  void ComputeQuality(unsigned int frameId, const std::vector<std::shared_ptr<Picture>>& finalPicts, const std::vector<std::shared_ptr<Layout>>& finalLayouts);
+
+  unsigned int GetNbUsers(void) const {return m_userPositions.size();}
+private:
+  std::vector<DynamicPosition> m_userPositions;
+  std::shared_ptr<Layout> m_viewportGeometry;
+  /**< Direction of each pixel of the viewport before the rotation of the user head (shared by all users) */
+  std::vector<Coord3dCart> m_localDirections;
+  std::ofstream m_output;
+  Picture::InterpolationTech m_interpol;
+  bool m_headerWritten;
+
+  cv::Mat ExtractViewport(const std::vector<Coord3dCart>& directions, const Picture& pict, const Layout& layout) const;
+};
+}
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <tuple>
+#include <vector>
 #include <opencv2/opencv.hpp>
 #include "Common.hpp"
+#include "SpherePointSet.hpp"
 
 namespace IMT {
 class Layout;
+class ReferencePicture;
+class ScratchArena;
 class Picture {
     public:
         enum class InterpolationTech {
@@ -59,8 +63,10 @@ class Picture {
         *   The two picture should have the same size
         **/
         double GetWSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic) const;
-        /** \brief compute the PSNR from a uniform sampling in the spherical domain. The two input pictures do not need to have the same size **/
-        double GetSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic, InterpolationTech it) const;
+        /** \brief compute the PSNR from a uniform sampling of nbPoints points in the spherical domain. The two input pictures do not need to have the same size.
+         *  A lower nbPoints gives a cheaper but less accurate measure.
+        **/
+        double GetSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic, InterpolationTech it, unsigned long nbPoints = SpherePointSet::DefaultNbPoints) const;
 
         const int& GetWidth(void) const {return m_pictMat.cols;}
         const int& GetHeight(void) const {return m_pictMat.rows;}
@@ -73,7 +79,36 @@ class Picture {
         static constexpr double m_ssim_c2 = 58.5225;
 
         void ApplyGaussianBlur(const cv::Mat& src, cv::Mat& dst, int ksize, double sigma) const;
-        std::tuple<double,double> ComputeSSIM(const cv::Mat& img1, const cv::Mat& img2) const;
+
+        /**< Reference independent part of the SSIM computation (YUV float planes, Gaussian mean, Gaussian variance) */
+        struct SSIMMoments
+        {
+          cv::Mat I;
+          cv::Mat mu;
+          cv::Mat mu_2;
+          cv::Mat sigma_2;
+        };
+        /** \brief Compute the moments of img. The matrices of moments are reused if they already have the right size and type */
+        static void ComputeSSIMMoments(const cv::Mat& img, SSIMMoments& moments);
+        /** \brief Return the moments of img. If arena is not null, the returned matrices are taken from it (valid until the end of its current scope) */
+        static SSIMMoments ComputeSSIMMoments(const cv::Mat& img, ScratchArena* arena = nullptr);
+        static SSIMMoments GetMomentsFromArena(ScratchArena& arena, int rows, int cols, int type);
+        /** \brief Return the mean SSIM and the mean contrast-structure of two pictures from their moments */
+        static std::tuple<double,double> ComputeSSIM(const SSIMMoments& moments1, const SSIMMoments& moments2);
+        static std::tuple<double,double> ComputeSSIM(const cv::Mat& img1, const cv::Mat& img2);
+        /** \brief Return the moments of each level of the MS-SSIM pyramid of this picture (taken from arena if it is not null) */
+        std::vector<SSIMMoments> ComputeMSSSIMPyramid(ScratchArena* arena = nullptr) const;
+        static double ComputeMSSSIM(const std::vector<SSIMMoments>& pyramid1, const std::vector<SSIMMoments>& pyramid2);
+
+        /** \brief Return the Y channel of the picture as a float plane (taken from arena if it is not null) */
+        static cv::Mat GetLumaPlane(const cv::Mat& img, ScratchArena* arena = nullptr);
+        static double GetMSE(const cv::Mat& lumaRef, const cv::Mat& lumaArg);
+
+        /** \brief Return the YCrCb values of the picture sampled on the nbPoints points of the sphere point set (taken from arena if it is not null) */
+        cv::Mat SampleOnSphere(Layout& layoutThisPict, InterpolationTech it, unsigned long nbPoints, ScratchArena* arena = nullptr) const;
+        static double GetSPSNR(const cv::Mat& samplesRef, const cv::Mat& samplesArg);
+
+        friend class ReferencePicture;
 
 };
 }
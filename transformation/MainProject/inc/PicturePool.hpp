@@ -0,0 +1,62 @@
+/**
+ * Pool of recycled picture buffers: the frames of a video all have the same few sizes, their buffers are reused from one frame to the next
+ */
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "Picture.hpp"
+
+namespace IMT {
+
+class PicturePool: public std::enable_shared_from_this<PicturePool>
+{
+public:
+  /** \brief Constructor. The pool has to be owned by a std::shared_ptr (the pictures keep a weak reference to it)
+   *
+   * \param maxFreeBuffers size_t Maximum number of unused buffers kept for each (size, type). 0 disables the recycling
+   *
+   */
+  explicit PicturePool(size_t maxFreeBuffers);
+  PicturePool(const PicturePool&) = delete;
+  PicturePool& operator=(const PicturePool&) = delete;
+
+  /** \brief Return a picture whose content is undefined. Its buffer goes back to the pool when the last shared_ptr to the picture is released */
+  std::shared_ptr<Picture> Get(int rows, int cols, int type) {return Adopt(GetMat(rows, cols, type));}
+  /** \brief Return a picture with a copy of mat */
+  std::shared_ptr<Picture> GetCopy(const cv::Mat& mat);
+  /** \brief Return a picture wrapping mat (no copy). The buffer of mat is given to the pool when the picture is released */
+  std::shared_ptr<Picture> Adopt(cv::Mat mat);
+  /** \brief Return a matrix whose content is undefined. The buffer is only recycled if it is given back with Adopt */
+  cv::Mat GetMat(int rows, int cols, int type);
+
+  /** Number of buffers allocated by the pool since its creation: constant once the pipeline reached its steady state */
+  size_t GetNbAllocations(void) const {return m_nbAllocations;}
+  size_t GetNbFreeBuffers(void) const;
+
+  /** \brief Pool used by the layouts and the decoders. Created at the first call with the limit given to SetDefaultMaxFreeBuffers */
+  static std::shared_ptr<PicturePool> GetDefault(void);
+  /** \brief Maximum number of unused buffers per (size, type) of the default pool (default 16): has to be called before the first GetDefault */
+  static void SetDefaultMaxFreeBuffers(size_t maxFreeBuffers);
+
+private:
+  typedef std::tuple<int, int, int> BufferKey; //rows, cols, type
+
+  const size_t m_maxFreeBuffers;
+  mutable std::mutex m_mutex;
+  std::map<BufferKey, std::vector<cv::Mat>> m_freeBuffers;
+  std::atomic<size_t> m_nbAllocations;
+
+  static size_t s_defaultMaxFreeBuffers;
+
+  /** Keep the buffer of mat for a next Get if nobody else uses it */
+  void Release(const cv::Mat& mat);
+};
+}
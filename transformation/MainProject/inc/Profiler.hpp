@@ -0,0 +1,114 @@
+/**
+ * Per frame timers and counters of the processing stages, written as a JSON or CSV profile at the end of a run
+ */
+#pragma once
+
+#include <map>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <utility>
+
+namespace IMT {
+
+class Profiler
+{
+public:
+  enum class Kind {
+    TIMER, //duration in second
+    COUNTER
+  };
+
+  /** \brief RAII: the measures of the calling thread are attributed to the frame frameId of profiler until the scope is destroyed
+   *  (by default the profiler of the enclosing scope). The measures done outside of a frame scope are ignored.
+   */
+  class FrameScope
+  {
+  public:
+    explicit FrameScope(int frameId, Profiler& profiler = GetCurrent()): m_previous(SetCurrent(frameId, &profiler)) {}
+    ~FrameScope(void) {SetCurrent(m_previous.first, m_previous.second);}
+    FrameScope(const FrameScope&) = delete;
+    FrameScope& operator=(const FrameScope&) = delete;
+  private:
+    const std::pair<int, Profiler*> m_previous;
+  };
+
+  /** \brief RAII: add the time spent in the scope to the timer name of the current frame. Does not read the clock if the current profiler is disabled */
+  class ScopedTimer
+  {
+  public:
+    explicit ScopedTimer(const std::string& name): m_name(), m_start(), m_isActive(GetCurrent().IsEnabled())
+    {
+      if (m_isActive)
+      {
+        m_name = name;
+        m_start = std::chrono::steady_clock::now();
+      }
+    }
+    ~ScopedTimer(void)
+    {
+      if (m_isActive)
+      {
+        AddTime(m_name, std::chrono::duration<double>(std::chrono::steady_clock::now()-m_start).count());
+      }
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+  private:
+    std::string m_name;
+    std::chrono::steady_clock::time_point m_start;
+    const bool m_isActive;
+  };
+
+  Profiler(void): m_isEnabled(false), m_mutex(), m_timers(), m_counters() {}
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  /** \brief Add value to the measure name of the frame frameId (the values added to the same frame are summed) */
+  void Add(Kind kind, int frameId, const std::string& name, double value);
+  /** \brief Sum of the values of the measure name over all the frames */
+  double GetTotal(Kind kind, const std::string& name) const;
+  void Clear(void);
+
+  /** \brief Write the per frame values and the aggregates over the frames (total, mean, min, median, 90th and 99th percentiles, max) of each measure */
+  void WriteJSON(std::ostream& os) const;
+  /** \brief Same as WriteJSON in space separated text: one line per frame and measure in framesOs, one line per measure in summaryOs */
+  void WriteCSV(std::ostream& framesOs, std::ostream& summaryOs) const;
+  /** \brief Write a JSON profile if path ends with ".json". Otherwise write the CSV profile in path and the aggregates in the same path with the "_summary" suffix */
+  void Write(const std::string& path) const;
+
+  /** \brief Enable or disable the measures of the static measure functions in this profiler (disabled by default) */
+  void SetEnabled(bool isEnabled) {m_isEnabled.store(isEnabled, std::memory_order_relaxed);}
+  bool IsEnabled(void) const {return m_isEnabled.load(std::memory_order_relaxed);}
+
+  /** \brief Profiler used outside of the frame scopes given another profiler */
+  static Profiler& GetDefault(void);
+  /** \brief Profiler of the frame scope of the calling thread (the default profiler outside of the frame scopes): used by the static measure functions */
+  static Profiler& GetCurrent(void);
+  /** \brief Add a duration (in second) to the timer name of the current frame of the calling thread */
+  static void AddTime(const std::string& name, double seconds);
+  /** \brief Add value to the counter name of the current frame of the calling thread */
+  static void AddCount(const std::string& name, double value);
+  /** \brief Run f and add its duration to the timer name. Return the value returned by f */
+  template<class Function>
+  static auto Time(const std::string& name, Function f) -> decltype(f())
+  {
+    ScopedTimer timer(name);
+    return f();
+  }
+
+private:
+  typedef std::map<std::string, std::map<int, double>> MeasureMap; //name -> frameId -> value
+
+  std::atomic<bool> m_isEnabled;
+  mutable std::mutex m_mutex;
+  MeasureMap m_timers;
+  MeasureMap m_counters;
+
+  /** Set the current frame and profiler of the calling thread, return the previous ones */
+  static std::pair<int, Profiler*> SetCurrent(int frameId, Profiler* profiler);
+  const MeasureMap& GetMeasures(Kind kind) const {return kind == Kind::TIMER ? m_timers : m_counters;}
+};
+}
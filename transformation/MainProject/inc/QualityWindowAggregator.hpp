@@ -0,0 +1,57 @@
+/**
+ * Online sliding-window aggregation of the per-frame quality measures
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "SlidingWindow.hpp"
+
+namespace IMT {
+
+class QualityWindowAggregator
+{
+public:
+  enum class OutputFormat {
+    CSV,
+    BINARY
+  };
+  /** \brief Constructor
+   *
+   * \param pathToOutput std::string Path to the output file
+   * \param metricNames std::vector<std::string> Name of each quality metric, in the order given to AddFrame
+   * \param windowDurations std::vector<double> Duration of each window in second (written in the output)
+   * \param windowSizes std::vector<unsigned int> Size of each window in number of processed frames
+   * \param percentiles std::vector<double> Percentiles (between 0 and 100) computed for each window
+   * \param format OutputFormat Comma-separated text (CSV) or compact binary output
+   *
+   * The binary file starts with the "QWIN" tag followed by uint32 version, nbMetrics, nbWindows, nbPercentiles,
+   * then for each metric its name (uint32 length + chars), the window durations (double) and the percentiles (double).
+   * Each record is uint32 frameId, windowId, metricId then double mean, min, max and the percentiles.
+   */
+  QualityWindowAggregator(std::string pathToOutput, std::vector<std::string> metricNames, std::vector<double> windowDurations, std::vector<unsigned int> windowSizes, std::vector<double> percentiles, OutputFormat format);
+  ~QualityWindowAggregator(void) = default;
+
+  /** \brief Add the quality measures of a processed frame and write the aggregates of each full window.
+   *  The non finite values (e.g. the infinite PSNR of identical pictures) are skipped: nothing is written for them.
+   *
+   * \param frameId unsigned int Id of the frame
+   * \param metricValues const std::vector<double>& One value per metric (same order as metricNames)
+   *
+   */
+  void AddFrame(unsigned int frameId, const std::vector<double>& metricValues);
+private:
+  std::vector<std::string> m_metricNames;
+  std::vector<double> m_windowDurations;
+  std::vector<double> m_percentiles;
+  OutputFormat m_format;
+  std::ofstream m_output;
+  /**< m_windows[w*nbMetrics + m] is the window w for the metric m */
+  std::vector<SlidingWindow> m_windows;
+
+  void WriteHeader(void);
+  template<typename T> void WriteBinary(const T& v) { m_output.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+};
+}
@@ -15,64 +15,70 @@ struct not_unit_quaternion_exception : std::exception
   char const* what() const throw() { return "Rotation require unit quaternion"; }
 };
 
-class Quaternion
+/** \brief Quaternion on the scalar type T: double (Quaternion) for the reference geometry, float (QuaternionF32) for the float32 geometry mode */
+template<class T>
+class QuaternionT
 {
 public:
-  constexpr Quaternion(void): m_w(0), m_v(), m_isNormalized(false) {}
-  constexpr Quaternion(const SCALAR& w, const VectorCartesian& v): m_w(w), m_v(v), m_isNormalized(false) {}
-  constexpr explicit Quaternion(const SCALAR& w): m_w(w), m_v(), m_isNormalized(false) {}
-  constexpr explicit Quaternion(const VectorCartesian& v): m_w(0), m_v(v), m_isNormalized(false) {}
-  static Quaternion FromEuler(const SCALAR& yaw, const SCALAR& pitch, const SCALAR& roll)
-  {
-    double t0 = std::cos(yaw * 0.5);
-  	double t1 = std::sin(yaw * 0.5);
-  	double t2 = std::cos(roll * 0.5);
-  	double t3 = std::sin(roll * 0.5);
-  	// double t4 = std::cos( (pitch - PI_L/2.0) * 0.5);
-  	// double t5 = std::sin( (pitch - PI_L/2.0) * 0.5);
-    double t4 = std::cos( pitch * 0.5);
-  	double t5 = std::sin( pitch * 0.5);
-
-    auto q = Quaternion(t0 * t2 * t4 + t1 * t3 * t5, VectorCartesian( t0 * t3 * t4 - t1 * t2 * t5,
+  typedef T Scalar;
+  typedef VectorCartesianT<T> Vect;
+  constexpr QuaternionT(void): m_w(0), m_v(), m_isNormalized(false) {}
+  constexpr QuaternionT(const T& w, const Vect& v): m_w(w), m_v(v), m_isNormalized(false) {}
+  constexpr explicit QuaternionT(const T& w): m_w(w), m_v(), m_isNormalized(false) {}
+  constexpr explicit QuaternionT(const Vect& v): m_w(0), m_v(v), m_isNormalized(false) {}
+  //explicit conversion between the double and the float32 geometry
+  template<class U> constexpr explicit QuaternionT(const QuaternionT<U>& q): m_w(T(q.GetW())), m_v(Vect(q.GetV())), m_isNormalized(false) {}
+  static QuaternionT FromEuler(const T& yaw, const T& pitch, const T& roll)
+  {
+    T t0 = std::cos(yaw * T(0.5));
+  	T t1 = std::sin(yaw * T(0.5));
+  	T t2 = std::cos(roll * T(0.5));
+  	T t3 = std::sin(roll * T(0.5));
+  	// T t4 = std::cos( (pitch - PI_L/2.0) * 0.5);
+  	// T t5 = std::sin( (pitch - PI_L/2.0) * 0.5);
+    T t4 = std::cos( pitch * T(0.5));
+  	T t5 = std::sin( pitch * T(0.5));
+
+    auto q = QuaternionT(t0 * t2 * t4 + t1 * t3 * t5, Vect( t0 * t3 * t4 - t1 * t2 * t5,
                                                                       t0 * t2 * t5 + t1 * t3 * t4,
                                                                       t1 * t2 * t4 - t0 * t3 * t5));
     q.Normalize();
     return q;
   }
 
-  constexpr SCALAR DotProduct(const Quaternion& q) const {return m_w*q.m_w + m_v.DotProduct(q.m_v);}
-  constexpr SCALAR Norm(void) const {return std::sqrt(DotProduct(*this));}
+  constexpr T DotProduct(const QuaternionT& q) const {return m_w*q.m_w + m_v.DotProduct(q.m_v);}
+  constexpr T Norm(void) const {return std::sqrt(DotProduct(*this));}
 
-  constexpr Quaternion operator+(const Quaternion& q) const
+  constexpr QuaternionT operator+(const QuaternionT& q) const
   {
-    return Quaternion(m_w+q.m_w, m_v+q.m_v);
+    return QuaternionT(m_w+q.m_w, m_v+q.m_v);
   }
-  constexpr Quaternion operator+(const VectorCartesian& v) const
-  { return this->operator+(Quaternion(v)); }
-  constexpr Quaternion operator-(const Quaternion& q) const
+  constexpr QuaternionT operator+(const Vect& v) const
+  { return this->operator+(QuaternionT(v)); }
+  constexpr QuaternionT operator-(const QuaternionT& q) const
   {
-    return Quaternion(m_w-q.m_w, m_v-q.m_v);
+    return QuaternionT(m_w-q.m_w, m_v-q.m_v);
   }
-  constexpr Quaternion operator-(void) const
+  constexpr QuaternionT operator-(void) const
   {
-    return Quaternion(-m_w, -m_v);
+    return QuaternionT(-m_w, -m_v);
   }
-  constexpr Quaternion operator-(const VectorCartesian& v) const
-  { return this->operator-(Quaternion(v)); }
-  constexpr Quaternion operator*(const Quaternion& q) const
+  constexpr QuaternionT operator-(const Vect& v) const
+  { return this->operator-(QuaternionT(v)); }
+  constexpr QuaternionT operator*(const QuaternionT& q) const
   {
-    return Quaternion((m_w*q.m_w) - (m_v*q.m_v),
+    return QuaternionT((m_w*q.m_w) - (m_v*q.m_v),
                       (m_w*q.m_v) + (q.m_w*m_v) + (m_v ^ q.m_v));
   }
-  constexpr Quaternion operator*(const VectorCartesian& v) const
-  { return this->operator*(Quaternion(v)); }
-  constexpr Quaternion operator*(SCALAR s) const
+  constexpr QuaternionT operator*(const Vect& v) const
+  { return this->operator*(QuaternionT(v)); }
+  constexpr QuaternionT operator*(T s) const
   {
-    return Quaternion(m_w*s, m_v*s);
+    return QuaternionT(m_w*s, m_v*s);
   }
-  constexpr Quaternion operator/(const SCALAR& s) const
+  constexpr QuaternionT operator/(const T& s) const
   {
-    return Quaternion(m_w/s, m_v/s);
+    return QuaternionT(m_w/s, m_v/s);
   }
 
   std::ostream& operator<<(std::ostream& o) const
@@ -81,18 +87,18 @@ public:
     return o;
   }
 
-  // Quaternion& operator=(const Quaternion& q)
+  // QuaternionT& operator=(const QuaternionT& q)
   // {
   //   m_w = q.m_w;
   //   m_v = q.m_v;
   //   return *this;
   // }
 
-  constexpr bool operator==(const Quaternion& q) const
+  constexpr bool operator==(const QuaternionT& q) const
   {
     return m_w == q.m_w && m_v == q.m_v;
   }
-  constexpr bool operator!=(const Quaternion& q) const
+  constexpr bool operator!=(const QuaternionT& q) const
   {
     return !(*this == q);
   }
@@ -106,74 +112,74 @@ public:
     }
   }
 
-  Quaternion Normalized(void)
+  QuaternionT Normalized(void)
   {
     return !m_isNormalized ? (*this / Norm()) : *this;
   }
 
-  constexpr SCALAR GetW(void) const {return m_w;}
-  constexpr VectorCartesian GetV(void) const {return m_v;}
+  constexpr T GetW(void) const {return m_w;}
+  constexpr Vect GetV(void) const {return m_v;}
 
   constexpr bool IsPur(void) const {return m_w == 0;}
-  constexpr Quaternion Conj(void) const {return Quaternion(m_w, -m_v);}
-  constexpr Quaternion Inv(void) const {return m_isNormalized ? Conj() : Conj()/std::pow(Norm(),2);}
-  constexpr VectorCartesian Rotation(const VectorCartesian& v) const
+  constexpr QuaternionT Conj(void) const {return QuaternionT(m_w, -m_v);}
+  constexpr QuaternionT Inv(void) const {return m_isNormalized ? Conj() : Conj()/std::pow(Norm(),2);}
+  constexpr Vect Rotation(const Vect& v) const
   {
     return m_isNormalized ?
             ((*this)*v*(this->Conj())).GetV() :
             ((*this)*v*(this->Conj())/std::pow(this->Norm(), 2)).GetV();
   }
 
-  static constexpr Quaternion Exp(const Quaternion& q)
+  static constexpr QuaternionT Exp(const QuaternionT& q)
   {
-    return Quaternion(std::cos(q.m_v.Norm())*std::exp(q.m_w),
+    return QuaternionT(std::cos(q.m_v.Norm())*std::exp(q.m_w),
                       q.m_v.Norm() != 0 ? std::sin(q.m_v.Norm()) * (q.m_v / q.m_v.Norm()) : q.m_v
                     );
   }
-  static constexpr Quaternion Log(const Quaternion& q)
+  static constexpr QuaternionT Log(const QuaternionT& q)
   {
-    return Quaternion(std::log(q.Norm()),
+    return QuaternionT(std::log(q.Norm()),
                       q.m_v.Norm() != 0 && q.Norm() != 0 ? std::acos(q.m_w/q.Norm())*(q.m_v/q.m_v.Norm()) : q.m_v
                     );
   }
-  static constexpr SCALAR Distance(const Quaternion& q1, const Quaternion& q2)
+  static constexpr T Distance(const QuaternionT& q1, const QuaternionT& q2)
   {
     return (q2-q1).Norm();
   }
 
-  static SCALAR OrthodromicDistance(const Quaternion& q1, const Quaternion& q2)
+  static T OrthodromicDistance(const QuaternionT& q1, const QuaternionT& q2)
   {
-    auto origine = VectorCartesian(1, 0, 0);
-    Quaternion p1 = Quaternion(q1.Rotation(origine));
-    Quaternion p2 = Quaternion(q2.Rotation(origine));
+    auto origine = Vect(1, 0, 0);
+    QuaternionT p1 = QuaternionT(q1.Rotation(origine));
+    QuaternionT p2 = QuaternionT(q2.Rotation(origine));
     auto p = p1 * p2;
     // p1 and p2 are pur so -p.m_w is the dot product and p.m_v is the vector product of p1 and p2
     return std::atan2(p.m_v.Norm(), -p.m_w);
   }
 
-  static constexpr Quaternion pow(const Quaternion& q, const SCALAR& k)
+  static constexpr QuaternionT pow(const QuaternionT& q, const T& k)
   {
-    return Quaternion::Exp(Quaternion::Log(q) * k);
+    return QuaternionT::Exp(QuaternionT::Log(q) * k);
   }
 
-  static Quaternion SLERP(const Quaternion& q1, const Quaternion& q2, const SCALAR& k)
+  static QuaternionT SLERP(const QuaternionT& q1, const QuaternionT& q2, const T& k)
   {
     if (q1.DotProduct(q2) < 0)
     {
-      return q1 * Quaternion::pow(q1.Inv() * (-q2), k);
+      return q1 * QuaternionT::pow(q1.Inv() * (-q2), k);
     }
     else
     {
-      return q1 * Quaternion::pow(q1.Inv() * q2, k);
+      return q1 * QuaternionT::pow(q1.Inv() * q2, k);
     }
   }
 
-  static constexpr Quaternion QuaternionFromAngleAxis(const SCALAR& theta, const VectorCartesian& u)
+  static constexpr QuaternionT QuaternionFromAngleAxis(const T& theta, const Vect& u)
   {
-    return Quaternion(std::cos(theta/2), std::sin(theta/2)*(u/u.Norm()));
+    return QuaternionT(std::cos(theta/2), std::sin(theta/2)*(u/u.Norm()));
   }
 
-  static VectorCartesian AverageAngularVelocity(Quaternion q1, Quaternion q2, const SCALAR& deltaT)
+  static Vect AverageAngularVelocity(QuaternionT q1, QuaternionT q2, const T& deltaT)
   {
     if (q1.DotProduct(q2) < 0)
     {
@@ -185,7 +191,7 @@ public:
       {
         q1.Normalize();
       }
-      q1 = Quaternion(q1.Rotation(VectorCartesian(1, 0, 0)));
+      q1 = QuaternionT(q1.Rotation(Vect(1, 0, 0)));
     }
     if (!q2.IsPur())
     {
@@ -193,29 +199,32 @@ public:
       {
         q2.Normalize();
       }
-      q2 = Quaternion(q2.Rotation(VectorCartesian(1, 0, 0)));
+      q2 = QuaternionT(q2.Rotation(Vect(1, 0, 0)));
     }
     auto deltaQ = q2 - q1;
-    auto W = (deltaQ * (2.0 / deltaT))*q1.Inv();
+    auto W = (deltaQ * (T(2) / deltaT))*q1.Inv();
     return W.m_v;
   }
 
 private:
-  SCALAR m_w;
-  VectorCartesian m_v;
+  T m_w;
+  Vect m_v;
   bool m_isNormalized;
 };
 
-inline std::ostream& operator<<(std::ostream& o, const Quaternion& q) {return q.operator<<(o);}
-inline constexpr Quaternion operator+(const SCALAR& s, const Quaternion& q) {return Quaternion(s) + q;}
-inline constexpr Quaternion operator-(const SCALAR& s, const Quaternion& q) {return Quaternion(s) - q;}
-inline constexpr Quaternion operator+(const VectorCartesian& v, const Quaternion& q) {return Quaternion(v) + q;}
-inline constexpr Quaternion operator-(const VectorCartesian& v, const Quaternion& q) {return Quaternion(v) - q;}
-inline constexpr Quaternion operator+(const VectorCartesian& v, const SCALAR& s) {return Quaternion(v) + Quaternion(s);}
-inline constexpr Quaternion operator-(const VectorCartesian& v, const SCALAR& s) {return Quaternion(v) - Quaternion(s);}
-inline constexpr Quaternion operator*(const SCALAR& s, const Quaternion& q) {return q * s;}
-inline constexpr Quaternion operator*(const VectorCartesian& v, const Quaternion& q) {return Quaternion(v) * q;}
-inline constexpr Quaternion operator*(const Quaternion& q, const VectorCartesian& v) {return q * Quaternion(v);}
+typedef QuaternionT<SCALAR> Quaternion;
+typedef QuaternionT<float> QuaternionF32;
+
+template<class T> inline std::ostream& operator<<(std::ostream& o, const QuaternionT<T>& q) {return q.operator<<(o);}
+//The scalars are not deduced (the quaternion or the vector gives the type) so that any number can be used
+template<class T> inline constexpr QuaternionT<T> operator+(const typename QuaternionT<T>::Scalar& s, const QuaternionT<T>& q) {return QuaternionT<T>(s) + q;}
+template<class T> inline constexpr QuaternionT<T> operator-(const typename QuaternionT<T>::Scalar& s, const QuaternionT<T>& q) {return QuaternionT<T>(s) - q;}
+template<class T> inline constexpr QuaternionT<T> operator+(const VectorCartesianT<T>& v, const QuaternionT<T>& q) {return QuaternionT<T>(v) + q;}
+template<class T> inline constexpr QuaternionT<T> operator-(const VectorCartesianT<T>& v, const QuaternionT<T>& q) {return QuaternionT<T>(v) - q;}
+template<class T> inline constexpr QuaternionT<T> operator+(const VectorCartesianT<T>& v, const typename VectorCartesianT<T>::Scalar& s) {return QuaternionT<T>(v) + QuaternionT<T>(s);}
+template<class T> inline constexpr QuaternionT<T> operator-(const VectorCartesianT<T>& v, const typename VectorCartesianT<T>::Scalar& s) {return QuaternionT<T>(v) - QuaternionT<T>(s);}
+template<class T> inline constexpr QuaternionT<T> operator*(const typename QuaternionT<T>::Scalar& s, const QuaternionT<T>& q) {return q * s;}
+template<class T> inline constexpr QuaternionT<T> operator*(const VectorCartesianT<T>& v, const QuaternionT<T>& q) {return QuaternionT<T>(v) * q;}
 
 // inline constexpr Quaternion pow(const Quaternion& q, const SCALAR& k)
 // {
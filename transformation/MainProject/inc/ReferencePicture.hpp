@@ -0,0 +1,54 @@
+/**
+ * Reference picture whose preprocessing is computed once per frame and shared by all the tested flows
+ */
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include <memory>
+
+#include "Picture.hpp"
+
+namespace IMT {
+
+class ReferencePicture
+{
+public:
+  /** \brief Constructor. Nothing is computed before a quality measure first needs it.
+   *
+   * \param pict std::shared_ptr<Picture> The reference picture
+   *
+   */
+  explicit ReferencePicture(std::shared_ptr<Picture> pict): m_pict(std::move(pict)), m_mutex(),
+    m_luma(), m_ssimMoments(nullptr), m_msssimPyramid(), m_sphereSamples() {}
+  ~ReferencePicture(void) = default;
+
+  const Picture& GetPicture(void) const {return *m_pict;}
+
+  /** \brief Same as Picture::GetPSNR, the Y plane of the reference is converted only once */
+  double GetPSNR(const Picture& pic) const;
+  /** \brief Same as Picture::GetSSIM, the Gaussian moments of the reference are computed only once */
+  double GetSSIM(const Picture& pic) const;
+  /** \brief Same as Picture::GetMSSSIM, the moments of the reference pyramid are computed only once */
+  double GetMSSSIM(const Picture& pic) const;
+  /** \brief Same as Picture::GetWSPSNR (nothing to reuse: the weights depend on both layouts) */
+  double GetWSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic) const {return m_pict->GetWSPSNR(pic, layoutThisPict, layoutArgPic);}
+  /** \brief Same as Picture::GetSPSNR, the reference is sampled on the sphere only once per (layout, interpolation, number of points)
+   */
+  double GetSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic, Picture::InterpolationTech it, unsigned long nbPoints = SpherePointSet::DefaultNbPoints) const;
+private:
+  typedef std::tuple<const Layout*, int, unsigned long> SampleKey;
+
+  std::shared_ptr<Picture> m_pict;
+  /**< protect the lazy initialization of the caches: the flows may be evaluated in parallel */
+  mutable std::mutex m_mutex;
+  mutable cv::Mat m_luma;
+  mutable std::shared_ptr<Picture::SSIMMoments> m_ssimMoments;
+  mutable std::vector<Picture::SSIMMoments> m_msssimPyramid;
+  mutable std::map<SampleKey, cv::Mat> m_sphereSamples;
+
+  void CheckSize(const Picture& pic, const std::string& measure) const;
+};
+}
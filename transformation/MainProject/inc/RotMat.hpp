@@ -0,0 +1,81 @@
+#pragma once
+#include <iostream>
+
+#include "Vector.hpp"
+#include "Quaternion.hpp"
+
+namespace IMT {
+
+/** \brief 3x3 rotation matrix (row major). Cheaper to apply than a quaternion (9 multiplications, no normalization)
+ *  and usable in constant expressions: the face rotations of the polyhedral layouts are compile-time tables of RotMat.
+ *  T is double (RotMat) or float (RotMatF32, float32 geometry mode).
+ */
+template<class T>
+class RotMatT
+{
+public:
+  typedef T Scalar;
+  constexpr RotMatT(void): m_m{1, 0, 0, 0, 1, 0, 0, 0, 1} {}
+  constexpr RotMatT(T m00, T m01, T m02,
+                    T m10, T m11, T m12,
+                    T m20, T m21, T m22): m_m{m00, m01, m02, m10, m11, m12, m20, m21, m22} {}
+  //explicit conversion between the double and the float32 geometry
+  template<class U> constexpr explicit RotMatT(const RotMatT<U>& r): RotMatT(T(r(0,0)), T(r(0,1)), T(r(0,2)), T(r(1,0)), T(r(1,1)), T(r(1,2)), T(r(2,0)), T(r(2,1)), T(r(2,2))) {}
+  ~RotMatT(void) = default;
+
+  /** \brief Matrix of the rotation done by q.Rotation (q does not need to be normalized) */
+  static constexpr RotMatT FromQuaternion(const QuaternionT<T>& q)
+  {
+    return FromQuaternion(q.GetW(), q.GetV().GetX(), q.GetV().GetY(), q.GetV().GetZ(), q.DotProduct(q));
+  }
+
+  constexpr T operator()(unsigned int i, unsigned int j) const {return m_m[3*i+j];}
+
+  constexpr VectorCartesianT<T> operator*(const VectorCartesianT<T>& v) const
+  {
+    return VectorCartesianT<T>(m_m[0]*v.GetX() + m_m[1]*v.GetY() + m_m[2]*v.GetZ(),
+                           m_m[3]*v.GetX() + m_m[4]*v.GetY() + m_m[5]*v.GetZ(),
+                           m_m[6]*v.GetX() + m_m[7]*v.GetY() + m_m[8]*v.GetZ());
+  }
+
+  constexpr RotMatT operator*(const RotMatT& r) const
+  {
+    return RotMatT(Row(0)*r.Col(0), Row(0)*r.Col(1), Row(0)*r.Col(2),
+                  Row(1)*r.Col(0), Row(1)*r.Col(1), Row(1)*r.Col(2),
+                  Row(2)*r.Col(0), Row(2)*r.Col(1), Row(2)*r.Col(2));
+  }
+
+  //The inverse of a rotation matrix is its transpose
+  constexpr RotMatT Transpose(void) const
+  {
+    return RotMatT(m_m[0], m_m[3], m_m[6],
+                  m_m[1], m_m[4], m_m[7],
+                  m_m[2], m_m[5], m_m[8]);
+  }
+  constexpr RotMatT Inv(void) const {return Transpose();}
+
+  constexpr VectorCartesianT<T> Row(unsigned int i) const {return VectorCartesianT<T>(m_m[3*i], m_m[3*i+1], m_m[3*i+2]);}
+  constexpr VectorCartesianT<T> Col(unsigned int j) const {return VectorCartesianT<T>(m_m[j], m_m[3+j], m_m[6+j]);}
+
+  std::ostream& operator<<(std::ostream& o) const
+  {
+    o << "[" << Row(0) << ", " << Row(1) << ", " << Row(2) << "]";
+    return o;
+  }
+
+private:
+  T m_m[9];
+
+  static constexpr RotMatT FromQuaternion(T w, T x, T y, T z, T n)
+  {
+    return RotMatT((w*w+x*x-y*y-z*z)/n, 2*(x*y-w*z)/n, 2*(x*z+w*y)/n,
+                  2*(x*y+w*z)/n, (w*w-x*x+y*y-z*z)/n, 2*(y*z-w*x)/n,
+                  2*(x*z-w*y)/n, 2*(y*z+w*x)/n, (w*w-x*x-y*y+z*z)/n);
+  }
+};
+
+typedef RotMatT<SCALAR> RotMat;
+typedef RotMatT<float> RotMatF32;
+
+template<class T> inline std::ostream& operator<<(std::ostream& o, const RotMatT<T>& r) {return r.operator<<(o);}
+}
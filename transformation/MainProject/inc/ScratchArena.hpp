@@ -0,0 +1,52 @@
+/**
+ * Per thread arena of reusable matrices for the temporaries of the quality measures
+ */
+#pragma once
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+namespace IMT {
+
+/** The matrices given by GetMat belong to the innermost open Scope of the arena: they are reused by the next GetMat once
+ *  the scope is closed. A temporary computed with the OpenCV functions (output argument or matrix expression) is written in
+ *  place when its matrix already has the right size and type, so the same computation done for each frame does not allocate anymore.
+ */
+class ScratchArena
+{
+public:
+  /** RAII: the matrices taken from the arena after the creation of the scope are given back when it is destroyed. Scopes have to be nested */
+  class Scope
+  {
+  public:
+    explicit Scope(ScratchArena& arena): m_arena(arena), m_mark(arena.m_nbUsed) {}
+    Scope(void): Scope(ScratchArena::GetThreadLocal()) {}
+    ~Scope(void) {m_arena.m_nbUsed = m_mark;}
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  private:
+    ScratchArena& m_arena;
+    const size_t m_mark;
+  };
+
+  ScratchArena(void): m_slots(), m_nbUsed(0), m_nbAllocations(0) {}
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /** \brief Return a matrix whose content is undefined, valid until the current scope is closed */
+  cv::Mat GetMat(int rows, int cols, int type);
+
+  /** Number of buffers allocated by the arena since its creation */
+  size_t GetNbAllocations(void) const {return m_nbAllocations;}
+
+  /** \brief Arena of the calling thread */
+  static ScratchArena& GetThreadLocal(void);
+
+private:
+  static constexpr size_t m_maxFreeSlots = 16;
+  std::vector<cv::Mat> m_slots; //[0, m_nbUsed): in use; [m_nbUsed, end): free
+  size_t m_nbUsed;
+  size_t m_nbAllocations;
+};
+}
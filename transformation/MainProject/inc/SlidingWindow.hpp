@@ -0,0 +1,97 @@
+/**
+ * Online statistics (mean, min, max, percentiles) over the last values of a stream
+ */
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+namespace IMT {
+
+class SlidingWindow
+{
+public:
+  /** \brief Constructor
+   *
+   * \param windowSize unsigned int Maximum number of values kept in the window (must be > 0)
+   *
+   */
+  explicit SlidingWindow(unsigned int windowSize): m_windowSize(windowSize), m_ring(), m_sorted(), m_next(0), m_sum(0), m_nbRemoved(0)
+  {
+    if (m_windowSize == 0)
+    {
+      throw std::invalid_argument("Sliding window size must be strictly positive");
+    }
+    m_ring.reserve(m_windowSize);
+    m_sorted.reserve(m_windowSize);
+  }
+
+  /** \brief Add a new value to the window. If the window is full the oldest value is removed. Memory and time in O(windowSize).
+   *  The non finite values (NaN, infinity) are skipped: they would break the order of the sorted values and the running sum.
+   *  Return false if the value is skipped.
+   */
+  bool Push(double value)
+  {
+    if (!std::isfinite(value))
+    {
+      return false;
+    }
+    if (m_ring.size() < m_windowSize)
+    {
+      m_ring.push_back(value);
+    }
+    else
+    {
+      double oldest = m_ring[m_next];
+      m_sum -= oldest;
+      m_sorted.erase(std::lower_bound(m_sorted.begin(), m_sorted.end(), oldest));
+      m_ring[m_next] = value;
+      m_next = (m_next+1) % m_windowSize;
+      ++m_nbRemoved;
+    }
+    m_sum += value;
+    if (m_nbRemoved == m_windowSize)
+    {//the rounding errors of the running sum accumulate: recompute it once per window (amortized O(1))
+      m_nbRemoved = 0;
+      m_sum = 0;
+      for (auto v: m_ring)
+      {
+        m_sum += v;
+      }
+    }
+    m_sorted.insert(std::upper_bound(m_sorted.begin(), m_sorted.end(), value), value);
+    return true;
+  }
+
+  unsigned int GetWindowSize(void) const {return m_windowSize;}
+  unsigned int GetNbValues(void) const {return m_sorted.size();}
+  bool IsFull(void) const {return m_sorted.size() == m_windowSize;}
+  bool IsEmpty(void) const {return m_sorted.empty();}
+
+  double GetMean(void) const {return IsEmpty() ? 0 : m_sum/m_sorted.size();}
+  double GetMin(void) const {return IsEmpty() ? 0 : m_sorted.front();}
+  double GetMax(void) const {return IsEmpty() ? 0 : m_sorted.back();}
+  /** \brief Return the percentile p (between 0 and 100) of the values in the window, with a linear interpolation between the two closest ranks.
+   */
+  double GetPercentile(double p) const
+  {
+    if (IsEmpty())
+    {
+      return 0;
+    }
+    double pos = std::min(std::max(p, 0.0), 100.0)/100.0 * (m_sorted.size()-1);
+    size_t low = std::floor(pos);
+    size_t high = std::ceil(pos);
+    return m_sorted[low] + (pos-low)*(m_sorted[high]-m_sorted[low]);
+  }
+private:
+  unsigned int m_windowSize;
+  std::vector<double> m_ring; //values in the arrival order (circular buffer)
+  std::vector<double> m_sorted; //same values, sorted
+  size_t m_next; //index of the oldest value in m_ring when the window is full
+  double m_sum;
+  unsigned int m_nbRemoved; //number of values removed from m_sum since it was last recomputed
+};
+}
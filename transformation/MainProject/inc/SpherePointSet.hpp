@@ -0,0 +1,53 @@
+/**
+ * Set of points uniformly distributed on the unit sphere (Fibonacci lattice) generated at runtime
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "Common.hpp"
+#include "VectorBatch.hpp"
+
+namespace IMT {
+
+class SpherePointSet
+{
+public:
+  /**< Number of points of the historical S-PSNR sampling */
+  static constexpr unsigned long DefaultNbPoints = 655362;
+
+  /** \brief Return the set of nbPoints points. The set is generated only once per process and, if a cache directory is set, stored on the disk to be reused by the next runs.
+   *
+   * \param nbPoints unsigned long Number of points on the sphere (must be > 0)
+   * \return std::shared_ptr<const SpherePointSet> The shared point set
+   *
+   */
+  static std::shared_ptr<const SpherePointSet> Get(unsigned long nbPoints);
+
+  /** \brief Set the directory where the generated point sets are cached. If empty (default) the point sets are not stored on the disk.
+   */
+  static void SetCacheDirectory(std::string cacheDirectory);
+
+  unsigned long GetNbPoints(void) const {return m_theta.size();}
+  /** \brief Return the point p on the unit sphere */
+  Coord3dSpherical GetPoint(unsigned long p) const {return Coord3dSpherical(1, m_theta[p], m_phi[p]);}
+  /** \brief Return all the points as unit Cartesian vectors (structure of arrays) */
+  const VectorBatch& GetCartesianPoints(void) const {return m_points;}
+
+  /** \brief Generate the Fibonacci lattice with nbPoints points (without using the cache) */
+  explicit SpherePointSet(unsigned long nbPoints);
+private:
+  SpherePointSet(std::vector<double> theta, std::vector<double> phi): m_theta(std::move(theta)), m_phi(std::move(phi)), m_points(VectorBatch::FromSpherical(m_theta, m_phi)) {}
+
+  /** Return nullptr if the cache file is missing, invalid or truncated: the point set is then generated again */
+  static std::shared_ptr<const SpherePointSet> ReadFromCache(const std::string& path, unsigned long nbPoints);
+  /** A cache file that cannot be written is ignored */
+  void WriteToCache(const std::string& path) const;
+
+  std::vector<double> m_theta; //between -PI and PI
+  std::vector<double> m_phi; //between 0 and PI
+  VectorBatch m_points; //the same points in Cartesian coordinates
+};
+}
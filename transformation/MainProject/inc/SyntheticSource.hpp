@@ -0,0 +1,41 @@
+/**
+ * Procedurally generated input frames, used instead of the input videos to measure the throughput of the projections
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "Picture.hpp"
+
+namespace IMT {
+
+class SyntheticSource
+{
+public:
+  enum class Content {
+    GRADIENT, //smooth color gradients
+    CHECKERBOARD, //black and white squares: sharp edges everywhere
+    NOISE //uniform random pixels: worst case for the interpolations and the encoders
+  };
+
+  /** \brief Constructor: the pattern is generated once, the frames are horizontal circular shifts of it */
+  SyntheticSource(Content content, unsigned int width, unsigned int height);
+  SyntheticSource(const SyntheticSource&) = delete;
+  SyntheticSource& operator=(const SyntheticSource&) = delete;
+
+  /** \brief Return the frame frameId: the pattern shifted by a few columns per frame, in a buffer of the PicturePool */
+  std::shared_ptr<Picture> GetFrame(int frameId) const;
+
+  unsigned int GetWidth(void) const {return m_pattern.cols;}
+  unsigned int GetHeight(void) const {return m_pattern.rows;}
+
+  /** \brief Parse "gradient", "checkerboard" or "noise". Throw std::invalid_argument for other names */
+  static Content ParseContent(const std::string& contentName);
+
+private:
+  cv::Mat m_pattern;
+};
+}
@@ -0,0 +1,115 @@
+/**
+ * Persistent thread pool with work stealing, shared by the parallel loops of the program
+ */
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace IMT {
+
+class TaskPool
+{
+public:
+  typedef std::function<void(void)> Task;
+  /** Body of a parallel loop: process the indexes [first, last) */
+  typedef std::function<void(size_t first, size_t last)> RangeFunction;
+
+  /** \brief Constructor
+   *
+   * \param nbThreads unsigned int Number of worker threads (0: one per hardware thread)
+   * \param pinThreads bool If true the worker i is pinned to the CPU i (modulo the number of CPUs). Only supported on Linux
+   *
+   */
+  explicit TaskPool(unsigned int nbThreads, bool pinThreads = false);
+  ~TaskPool(void);
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  unsigned int GetNbThreads(void) const {return m_workers.size();}
+  /** Number of workers that could not be pinned to their CPU (all of them if the pinning is not supported on this platform, 0 without pinning) */
+  unsigned int GetNbUnpinnedWorkers(void) const {return m_nbUnpinnedWorkers;}
+  /** Number of submitted tasks that threw an exception */
+  size_t GetNbFailedTasks(void) const {return m_nbFailedTasks;}
+
+  /** \brief Run the task on one of the workers. A task submitted by a worker is added to the queue of this worker, the idle workers steal
+   *  the oldest tasks of the other queues. The task should not throw: an exception is caught and counted by GetNbFailedTasks.
+   */
+  void Submit(Task task);
+
+  /** \brief Run body on the chunks of [begin, end) of at most grain indexes. The calling thread processes chunks too and returns once all of them are done.
+   *
+   * \param grain size_t Maximum number of indexes per chunk (0 is taken as 1)
+   * \param maxThreads unsigned int Maximum number of threads (calling thread included) running the chunks of this loop. 0 for no limit
+   *
+   * Can be nested: a chunk can run another parallel loop. The first exception thrown by body is rethrown once the running chunks are done (the remaining chunks are skipped).
+   */
+  void ParallelFor(size_t begin, size_t end, size_t grain, const RangeFunction& body, unsigned int maxThreads = 0);
+
+  /** \brief Same as ParallelFor but each chunk returns a partial result. The partial results are combined in the order of the chunks,
+   *  so the result does not depend on the scheduling (same floating point rounding from one run to the other).
+   *
+   * \param chunkBody T(size_t first, size_t last) Return the partial result of the indexes [first, last)
+   * \param combine T(const T&, const T&) Combine two results
+   */
+  template<class T, class ChunkFunction, class CombineFunction>
+  T ParallelReduce(size_t begin, size_t end, size_t grain, T init, ChunkFunction chunkBody, CombineFunction combine, unsigned int maxThreads = 0)
+  {
+    if (begin >= end)
+    {
+      return init;
+    }
+    grain = grain == 0 ? 1 : grain;
+    std::vector<T> partials((end-begin+grain-1)/grain, init);
+    ParallelFor(begin, end, grain, [&](size_t first, size_t last) {partials[(first-begin)/grain] = chunkBody(first, last);}, maxThreads);
+    T result = init;
+    for (const auto& p: partials)
+    {
+      result = combine(result, p);
+    }
+    return result;
+  }
+
+  /** \brief Pool shared by the whole program. Created at the first call with the number of threads given to SetDefaultNbThreads */
+  static TaskPool& GetDefault(void);
+  /** \brief Number of threads of the default pool: has to be called before the first GetDefault */
+  static void SetDefaultNbThreads(unsigned int nbThreads);
+  /** \brief Pin the threads of the default pool to the CPUs: has to be called before the first GetDefault */
+  static void SetDefaultThreadPinning(bool pinThreads);
+  /** \brief Minimum number of elementary items (pixels, samples on the sphere) processed by a chunk of the parallel loops (default 4096) */
+  static void SetDefaultGrainSize(size_t grainSize);
+  /** \brief Grain (number of loop indexes per chunk) of a loop where each index processes itemSize elementary items: at least 1 */
+  static size_t GetGrain(size_t itemSize);
+
+private:
+  struct WorkerQueue
+  {
+    std::mutex m_mutex;
+    std::deque<Task> m_tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> m_queues; //one per worker
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_hasTask;
+  std::atomic<size_t> m_nbPendingTasks;
+  std::atomic<size_t> m_nextQueue;
+  bool m_stop;
+  unsigned int m_nbUnpinnedWorkers;
+  std::atomic<size_t> m_nbFailedTasks;
+
+  static unsigned int s_defaultNbThreads;
+  static bool s_defaultPinThreads;
+  static size_t s_defaultGrainSize;
+
+  void WorkerLoop(unsigned int workerId);
+  /** Pop a task from the back of the worker queue or steal one from the front of another queue */
+  bool TakeTask(unsigned int workerId, Task& task);
+};
+}
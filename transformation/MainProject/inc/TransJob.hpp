@@ -0,0 +1,164 @@
+/**
+ * One transformation job: the flows, the input and output videos and the quality measures described by a configuration (same keys as the ini file)
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <ostream>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <mutex>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include "Picture.hpp"
+#include "Layout.hpp"
+#include "FramePipeline.hpp"
+#include "MultiViewportQuality.hpp"
+#include "QualityWindowAggregator.hpp"
+#include "FaceQualityMap.hpp"
+#include "SyntheticSource.hpp"
+#include "Profiler.hpp"
+
+namespace IMT {
+
+class ReferencePicture;
+
+/** The job is built from a configuration (the ini file of the trans tool parsed in a ptree): the constructor parses it, initializes the
+ *  layouts of each flow and opens the input videos, the output videos and the quality files. The frames are then either pulled from
+ *  the input videos by Run, or pushed one by one with ProcessFrame. The quality of each frame is given to the quality callback.
+ *  The messages of the job go to the log stream (discarded if none is given) and the configuration errors are thrown as std::invalid_argument.
+ *  The libav wrapper still prints the format of the input videos and the libav errors on the standard output, as do the layouts when an
+ *  input video does not have the expected number of streams.
+ *  The global settings of the configuration (task pool, picture pool, codec threads) are process wide: by default the constructor sets them
+ *  (ConfigureProcess). When several jobs run at the same time they are set once with ConfigureProcess and the jobs are built without them.
+ *  Each job has its own profiler.
+ *  If Global.nbShards > 1, Run splits the frames in GOP-aligned ranges processed in parallel by one job per shard, then concatenates
+ *  the output videos and the quality files of the shards (the callbacks are then called by the threads of the shards).
+ */
+class TransJob
+{
+public:
+  typedef boost::property_tree::ptree Config;
+  /** Quality of the output picture of the flow flowId (> 0, compared to the flow 0) for the frame frameId, in the order of GetQualityNames */
+  typedef std::function<void(int frameId, unsigned int flowId, const std::vector<std::string>& qualityNames, const std::vector<double>& quality)> QualityCallback;
+  /** Output picture of each flow for the frame frameId */
+  typedef FramePipeline::FrameFunction OutputCallback;
+
+  /** \brief Constructor. Throw std::invalid_argument if the configuration is not valid (including the missing keys and the values of the wrong type)
+   *
+   * \param config const Config& Configuration (same keys as the ini file of the trans tool)
+   * \param log std::ostream* Stream for the progress messages. nullptr: nothing is printed
+   * \param configureProcess bool If true the process wide settings of the configuration are applied (ConfigureProcess)
+   *
+   */
+  explicit TransJob(const Config& config, std::ostream* log = nullptr, bool configureProcess = true);
+  TransJob(const TransJob&) = delete;
+  TransJob& operator=(const TransJob&) = delete;
+
+  /** \brief Apply the process wide settings of the configuration (Global keys of GetProcessSettingKeys) and recycle the decoded pictures in the
+   *  picture pool. Not thread safe: has to be called before the jobs are built. Throw std::invalid_argument if a value is not valid
+   */
+  static void ConfigureProcess(const Config& config);
+  /** Name of the keys of the Global section applied by ConfigureProcess */
+  static const std::vector<std::string>& GetProcessSettingKeys(void);
+  /** \brief Parse an ini configuration file */
+  static Config ReadIni(const std::string& pathToIni);
+
+  void SetQualityCallback(QualityCallback qualityCallback) {m_qualityCallback = std::move(qualityCallback);}
+  void SetOutputCallback(OutputCallback outputCallback) {m_outputCallback = std::move(outputCallback);}
+
+  /** \brief Process the frames [startFrame, startFrame+nbFrames) read from the input videos (or the synthetic input) with the frame pipeline.
+   *  Write the profile and the synthetic throughput at the end if they are enabled.
+   */
+  void Run(void);
+  /** \brief Split the frames [startFrame, startFrame+nbFrames) in at most nbShards ranges of consecutive frames (first frame, number of frames).
+   *  Each range starts with a new GOP of the output videos (gopSize output frames, one output frame every processingStep frames).
+   */
+  static std::vector<std::pair<unsigned int, unsigned int>> ComputeShards(unsigned int startFrame, unsigned int nbFrames, unsigned int processingStep, unsigned int gopSize, unsigned int nbShards);
+  /** \brief Path given to the job of the shard k instead of path: "_shard<k+1>_" is inserted before the extension. An empty path stays empty */
+  static std::string GetShardPath(const std::string& path, unsigned int k);
+  /** \brief Write the lines of the input files one after the other in the output file. The nbHeaderLines first lines are kept only from the first input.
+   *  The missing inputs are skipped. Throw std::invalid_argument if the output file cannot be opened
+   */
+  static void ConcatenateFiles(const std::vector<std::string>& inputPaths, const std::string& outputPath, unsigned int nbHeaderLines);
+  /** \brief Process one frame pushed by the caller in the calling thread: project the input picture of each flow, measure and encode the output pictures
+   *
+   * \param frameId int Id of the frame (used for the quality files and the dynamic layouts)
+   * \param inputPicts const FramePipeline::FramePictures& Input picture of each flow, in the resolution of the input layout of the flow
+   * \return FramePipeline::FramePictures Output picture of each flow
+   *
+   */
+  FramePipeline::FramePictures ProcessFrame(int frameId, const FramePipeline::FramePictures& inputPicts);
+
+  unsigned int GetNbFlows(void) const {return m_layoutFlowVect.size();}
+  /** Name of the computed metrics, in the order given to the quality callback and written in the quality files */
+  const std::vector<std::string>& GetQualityNames(void) const {return m_qualityNames;}
+  const Layout& GetInputLayout(unsigned int flowId) const {return *m_layoutFlowVect[flowId].front();}
+  const Layout& GetOutputLayout(unsigned int flowId) const {return *m_layoutFlowVect[flowId].back();}
+  int GetNbProcessedFrames(void) const {return m_nbProcessedFrames;}
+
+private:
+  Config m_config;
+  std::ostream m_nullLog; //no stream buffer: discards everything
+  std::ostream& m_log;
+  std::mutex m_logMutex;
+
+  std::vector<std::vector<std::string>> m_layoutFlowSections; //name of the layouts of each flow
+  std::vector<std::vector<std::shared_ptr<Layout>>> m_layoutFlowVect;
+  std::vector<std::string> m_qualityNames;
+
+  std::string m_pathToOutputVideo;
+  std::string m_pathToOutputQuality;
+  int m_processingStep;
+  bool m_displayFinalPict;
+  unsigned int m_nbFrames;
+  unsigned int m_startFrame;
+  double m_fps;
+  unsigned long m_spsnrNbPoints;
+  std::string m_pathToProfile;
+  std::shared_ptr<Profiler> m_profiler; //measures of the stages (shared with the jobs of the shards)
+  bool m_useSyntheticInput;
+  unsigned int m_pipelineQueueSize;
+  bool m_hasDynamicFinalLayout;
+  bool m_isInputSeeked; //the input videos start at startFrame
+  std::vector<std::pair<unsigned int, unsigned int>> m_shardVect; //frame ranges of the shards (empty: no sharding)
+
+  std::vector<std::shared_ptr<SyntheticSource>> m_syntheticSourceVect;
+  std::shared_ptr<MultiViewportQuality> m_multiViewportQuality;
+  std::vector<std::shared_ptr<std::ofstream>> m_qualityWriterVect;
+  std::vector<std::shared_ptr<FaceQualityMap>> m_faceQualityMapVect;
+  std::vector<std::shared_ptr<std::ofstream>> m_faceQualityWriterVect;
+  std::vector<std::shared_ptr<QualityWindowAggregator>> m_qualityWindowVect;
+
+  QualityCallback m_qualityCallback;
+  OutputCallback m_outputCallback;
+
+  int m_nbProcessedFrames;
+  std::chrono::high_resolution_clock::time_point m_lastEndTime;
+  double m_averageDuration;
+
+  /** Write one line in the log. The stages of the frame pipeline run concurrently: their messages are written with Log, one line at a time */
+  void Log(const std::string& line);
+  /** Stages of the frame pipeline */
+  FramePipeline::FramePictures Decode(int count);
+  std::shared_ptr<Picture> Project(unsigned int j, int count, std::shared_ptr<Picture> pict);
+  void Measure(int count, const FramePipeline::FramePictures& outputPicts);
+  void Encode(int count, const FramePipeline::FramePictures& outputPicts);
+
+  /** Run one job per shard and concatenate their outputs */
+  void RunShards(void);
+  void ConcatenateShardFiles(unsigned int j, const std::string& suffix, unsigned int nbHeaderLines) const;
+  /** Path of the output file of the flow j: path without its extension, the flow number, the final layout, the suffix and the extension */
+  std::string GetFlowPath(const std::string& path, unsigned int j, const std::string& suffix) const;
+
+  double ComputeQuality(const std::string& qualityName, const ReferencePicture& refPict, const Picture& pictOut, Layout& layoutOut);
+  void PrintSyntheticThroughput(double runDuration);
+  /** Values of the JSON list stored in the key of the configuration. Throw std::invalid_argument if it is not a valid JSON list */
+  std::vector<std::string> GetJSONList(const std::string& key) const;
+};
+}
@@ -1,22 +1,17 @@
 #pragma once
 #include <cmath>
 #include <limits>
+#include <ostream>
+#include <algorithm>
+#include <type_traits>
+
+#include "FastMath.hpp"
 
 typedef  double SCALAR;
 
 namespace IMT {
 
-class Vector
-{
-public:
-  constexpr Vector(void) {}
-  ~Vector(void) = default;
-
-  // virtual SCALAR Norm(void) const = 0;
-  virtual std::ostream& operator<<(std::ostream& o) const = 0;
-};
-
-class VectorSpherical;
+template<class T> class VectorSphericalT;
 
 template<class T>
 static constexpr typename std::enable_if<!std::numeric_limits<T>::is_integer, bool>::type
@@ -29,51 +24,62 @@ static constexpr typename std::enable_if<!std::numeric_limits<T>::is_integer, bo
            || std::abs(x-y) < std::numeric_limits<T>::min();
 }
 
-class VectorCartesian: public Vector
+/** \brief Cartesian vector. The scalar type T is double (VectorCartesian) for the reference geometry and float (VectorCartesianF32) for the float32 geometry mode.
+ *  Plain value type (no virtual function, trivially copyable): arrays of vectors can be copied with memcpy and vectorized. Printed with the free operator<<.
+ */
+template<class T>
+class VectorCartesianT
 {
 public:
-  constexpr VectorCartesian(void): Vector(), m_x(0), m_y(0), m_z(0) {}
-  constexpr VectorCartesian(SCALAR x, SCALAR y, SCALAR z): Vector(), m_x(x), m_y(y), m_z(z) {}
-  constexpr VectorCartesian(const VectorSpherical& v);
-  ~VectorCartesian(void) = default;
-
-  constexpr SCALAR DotProduct(const VectorCartesian& v) const {return m_x*v.m_x + m_y*v.m_y + m_z*v.m_z;}
-  constexpr SCALAR Norm(void) const {return std::sqrt(DotProduct(*this));}
-
-  constexpr VectorCartesian operator+(const VectorCartesian& v) const {return VectorCartesian(m_x+v.m_x, m_y+v.m_y, m_z+v.m_z);}
-  constexpr VectorCartesian operator-(void) const {return VectorCartesian(-m_x, -m_y, -m_z);}
-  constexpr VectorCartesian operator-(const VectorCartesian& v) const {return VectorCartesian(m_x-v.m_x, m_y-v.m_y, m_z-v.m_z);}
-  constexpr VectorCartesian operator*(const SCALAR& s) const {return VectorCartesian(s*m_x, s*m_y, s*m_z);}
-  constexpr VectorCartesian operator/(const SCALAR& s) const {return VectorCartesian(m_x/s, m_y/s, m_z/s);}
-  VectorCartesian& operator/=(const SCALAR& s) { m_x/=s; m_y/=s; m_z/=s; return *this;}
-  VectorCartesian& operator*=(const SCALAR& s) { m_x*=s; m_y*=s; m_z*=s; return *this;}
+  typedef T Scalar;
+  constexpr VectorCartesianT(void): m_x(0), m_y(0), m_z(0) {}
+  constexpr VectorCartesianT(T x, T y, T z): m_x(x), m_y(y), m_z(z) {}
+  constexpr VectorCartesianT(const VectorSphericalT<T>& v);
+  //explicit conversion between the double and the float32 geometry
+  template<class U> constexpr explicit VectorCartesianT(const VectorCartesianT<U>& v): m_x(T(v.GetX())), m_y(T(v.GetY())), m_z(T(v.GetZ())) {}
+  ~VectorCartesianT(void) = default;
+
+  constexpr T DotProduct(const VectorCartesianT& v) const {return m_x*v.m_x + m_y*v.m_y + m_z*v.m_z;}
+  constexpr T Norm(void) const {return std::sqrt(DotProduct(*this));}
+
+  constexpr VectorCartesianT operator+(const VectorCartesianT& v) const {return VectorCartesianT(m_x+v.m_x, m_y+v.m_y, m_z+v.m_z);}
+  constexpr VectorCartesianT operator-(void) const {return VectorCartesianT(-m_x, -m_y, -m_z);}
+  constexpr VectorCartesianT operator-(const VectorCartesianT& v) const {return VectorCartesianT(m_x-v.m_x, m_y-v.m_y, m_z-v.m_z);}
+  constexpr VectorCartesianT operator*(const T& s) const {return VectorCartesianT(s*m_x, s*m_y, s*m_z);}
+  constexpr VectorCartesianT operator/(const T& s) const {return VectorCartesianT(m_x/s, m_y/s, m_z/s);}
+  VectorCartesianT& operator/=(const T& s) { m_x/=s; m_y/=s; m_z/=s; return *this;}
+  VectorCartesianT& operator*=(const T& s) { m_x*=s; m_y*=s; m_z*=s; return *this;}
   //dot product
-  constexpr SCALAR operator*(const VectorCartesian& v) const {return DotProduct(v);}
+  constexpr T operator*(const VectorCartesianT& v) const {return DotProduct(v);}
   //Vector product
-  constexpr VectorCartesian operator^(const VectorCartesian& v) const {return VectorCartesian(m_y*v.m_z-m_z*v.m_y,
+  constexpr VectorCartesianT operator^(const VectorCartesianT& v) const {return VectorCartesianT(m_y*v.m_z-m_z*v.m_y,
                     m_z*v.m_x-m_x*v.m_z,
                     m_x*v.m_y-m_y*v.m_x);}
 
-  constexpr bool operator==(const VectorCartesian& v) const
+  constexpr bool operator==(const VectorCartesianT& v) const
   {
     return AlmostEqual(m_x, v.m_x) && AlmostEqual(m_y, v.m_y) &&  AlmostEqual(m_z, v.m_z);
   }
-  constexpr bool operator!=(const VectorCartesian& v) const
+  constexpr bool operator!=(const VectorCartesianT& v) const
   {
     return !(*this == v);
   }
 
-  constexpr VectorCartesian VectorProduct(const VectorCartesian& v) const {return (*this)^v; }
+  constexpr VectorCartesianT VectorProduct(const VectorCartesianT& v) const {return (*this)^v; }
 
-  virtual std::ostream& operator<<(std::ostream& o) const override
+  //Friend (not template) so that the scalar can be any number
+  friend constexpr VectorCartesianT operator*(const T& s, const VectorCartesianT& v) {return v * s;}
+
+  static constexpr VectorCartesianT FromSpherical(T theta, T phi)
   {
-    o << "(" << m_x << ", "  << m_y << ", " <<  m_z << ")";
-    return o;
+    return VectorCartesianT(std::sin(phi)*std::cos(theta), std::sin(phi)*std::sin(theta), std::cos(phi));
   }
-
-  static constexpr VectorCartesian FromSpherical(SCALAR theta, SCALAR phi)
+  static VectorCartesianT FromSpherical(T theta, T phi, MathMode mode)
   {
-    return VectorCartesian(std::sin(phi)*std::cos(theta), std::sin(phi)*std::sin(theta), std::cos(phi));
+    T sinT, cosT, sinP, cosP;
+    SinCos(theta, sinT, cosT, mode);
+    SinCos(phi, sinP, cosP, mode);
+    return VectorCartesianT(sinP*cosT, sinP*sinT, cosP);
   }
 
   // static VectorCartesian FromSpherical(const VectorSpherical& v)
@@ -81,68 +87,94 @@ public:
   //   return v.ToCartesian();
   // }
 
-  constexpr SCALAR GetX(void) const {return m_x;}
-  constexpr SCALAR GetY(void) const {return m_y;}
-  constexpr SCALAR GetZ(void) const {return m_z;}
-  void SetX(const SCALAR& x) {m_x = x;}
-  void SetY(const SCALAR& y) {m_y = y;}
-  void SetZ(const SCALAR& z) {m_z = z;}
+  //Spherical angles of the direction (the vector does not need to be normalized): theta in [-pi, pi] and phi in [0, pi]
+  constexpr T GetTheta(void) const {return std::atan2(m_y, m_x);}
+  constexpr T GetPhi(void) const {return std::atan2(std::sqrt(m_x*m_x+m_y*m_y), m_z);}
+  //Same with the trigonometry selected by mode (see FastMath.hpp)
+  T GetTheta(MathMode mode) const {return Atan2(m_y, m_x, mode);}
+  T GetPhi(MathMode mode) const {return Atan2(std::sqrt(m_x*m_x+m_y*m_y), m_z, mode);}
+
+  constexpr T GetX(void) const {return m_x;}
+  constexpr T GetY(void) const {return m_y;}
+  constexpr T GetZ(void) const {return m_z;}
+  void SetX(const T& x) {m_x = x;}
+  void SetY(const T& y) {m_y = y;}
+  void SetZ(const T& z) {m_z = z;}
 private:
-  SCALAR m_x;
-  SCALAR m_y;
-  SCALAR m_z;
+  T m_x;
+  T m_y;
+  T m_z;
 };
 
 
-inline std::ostream& operator<<(std::ostream& o, const Vector& v) {return v.operator<<(o);}
-inline constexpr VectorCartesian operator*(const SCALAR& s, const VectorCartesian& v) {return v * s;}
+typedef VectorCartesianT<SCALAR> VectorCartesian;
+typedef VectorCartesianT<float> VectorCartesianF32;
 
-class VectorSpherical: public Vector
+template<class T> inline std::ostream& operator<<(std::ostream& o, const VectorCartesianT<T>& v)
+{
+  o << "(" << v.GetX() << ", "  << v.GetY() << ", " <<  v.GetZ() << ")";
+  return o;
+}
+
+static_assert(std::is_trivially_copyable<VectorCartesian>::value && sizeof(VectorCartesian) == 3*sizeof(SCALAR), "VectorCartesian should be a plain value type");
+
+template<class T>
+class VectorSphericalT
 {
 public:
-  constexpr VectorSpherical(void): Vector(), m_r(0), m_theta(0), m_phi(0) {}
-  constexpr VectorSpherical(SCALAR rho, SCALAR theta, SCALAR phi): Vector(), m_r(rho), m_theta(theta), m_phi(phi) {}
-  constexpr VectorSpherical(const VectorCartesian& v): VectorSpherical(v.Norm(), std::atan2(v.GetY(), v.GetX()), std::acos(v.GetZ()/v.Norm())) {}
-  ~VectorSpherical(void) = default;
+  typedef T Scalar;
+  constexpr VectorSphericalT(void): m_r(0), m_theta(0), m_phi(0) {}
+  constexpr VectorSphericalT(T rho, T theta, T phi): m_r(rho), m_theta(theta), m_phi(phi) {}
+  constexpr VectorSphericalT(const VectorCartesianT<T>& v): VectorSphericalT(v.Norm(), std::atan2(v.GetY(), v.GetX()), std::acos(v.GetZ()/v.Norm())) {}
+  ~VectorSphericalT(void) = default;
 
   // constexpr operator VectorCartesian() const { return ToCartesian();}
 
-  constexpr SCALAR Norm(void) const {return GetRho();}
+  constexpr T Norm(void) const {return GetRho();}
 
-  constexpr SCALAR GetRho(void) const {return m_r;}
-  constexpr SCALAR GetTheta(void) const {return m_theta;}
-  constexpr SCALAR GetPhi(void) const {return m_phi;}
-  void SetRho(const SCALAR& r) {m_r = r;}
-  void SetTheta(const SCALAR& theta) {m_theta = theta;}
-  void SetPhi(const SCALAR& phi) {m_phi = phi;}
+  constexpr T GetRho(void) const {return m_r;}
+  constexpr T GetTheta(void) const {return m_theta;}
+  constexpr T GetPhi(void) const {return m_phi;}
+  void SetRho(const T& r) {m_r = r;}
+  void SetTheta(const T& theta) {m_theta = theta;}
+  void SetPhi(const T& phi) {m_phi = phi;}
 
-  constexpr VectorSpherical operator*(const SCALAR& s) const { return VectorSpherical(m_r*s, m_theta, m_phi); }
-  constexpr VectorSpherical operator/(const SCALAR& s) const { return VectorSpherical(m_r/s, m_theta, m_phi); }
-  constexpr bool operator==(const VectorSpherical& v) const { return AlmostEqual(m_r, v.m_r) && AlmostEqual(m_theta, v.m_theta) &&  AlmostEqual(m_phi, v.m_phi); }
+  constexpr VectorSphericalT operator*(const T& s) const { return VectorSphericalT(m_r*s, m_theta, m_phi); }
+  constexpr VectorSphericalT operator/(const T& s) const { return VectorSphericalT(m_r/s, m_theta, m_phi); }
+  constexpr bool operator==(const VectorSphericalT& v) const { return AlmostEqual(m_r, v.m_r) && AlmostEqual(m_theta, v.m_theta) &&  AlmostEqual(m_phi, v.m_phi); }
 
-  constexpr VectorCartesian ToCartesian(void) const
+  constexpr VectorCartesianT<T> ToCartesian(void) const
   {
-    return VectorCartesian(m_r*std::sin(m_phi)*std::cos(m_theta), m_r*std::sin(m_phi)*std::sin(m_theta), m_r*std::cos(m_phi));
+    return VectorCartesianT<T>(m_r*std::sin(m_phi)*std::cos(m_theta), m_r*std::sin(m_phi)*std::sin(m_theta), m_r*std::cos(m_phi));
   }
 
-  virtual std::ostream& operator<<(std::ostream& o) const override
-  {
-    o << "(spherical: " << m_r << ", "  << m_theta << ", " <<  m_phi << ")";
-    return o;
-  }
+  //Mixed operations are done in Cartesian coordinates. They are friends (not templates) so that the implicit conversions still apply
+  friend constexpr VectorCartesianT<T> operator+(const VectorSphericalT& v1, const VectorCartesianT<T>& v2) {return VectorCartesianT<T>(v1)+v2;}
+  friend constexpr VectorCartesianT<T> operator-(const VectorSphericalT& v1, const VectorCartesianT<T>& v2) {return VectorCartesianT<T>(v1)-v2;}
+  //dot product
+  friend constexpr T operator*(const VectorSphericalT& v1, const VectorCartesianT<T>& v2) {return VectorCartesianT<T>(v1) * v2;}
+  friend constexpr VectorCartesianT<T> operator*(const T& s, const VectorSphericalT& v) {return VectorCartesianT<T>(v) * s;}
+  //Vector product
+  friend constexpr VectorCartesianT<T> operator^(const VectorSphericalT& v1, const VectorCartesianT<T>& v2) { return VectorCartesianT<T>(v1)^v2; }
+  friend constexpr VectorCartesianT<T> operator-(const VectorSphericalT& v1) {return -VectorCartesianT<T>(v1);}
+
 private:
-  SCALAR m_r;
-  SCALAR m_theta;
-  SCALAR m_phi;
+  T m_r;
+  T m_theta;
+  T m_phi;
 };
 
-constexpr VectorCartesian::VectorCartesian(const VectorSpherical& v): VectorCartesian(v.GetRho()*std::sin(v.GetPhi())*std::cos(v.GetTheta()), v.GetRho()*std::sin(v.GetPhi())*std::sin(v.GetTheta()), v.GetRho()*std::cos(v.GetPhi())){}
-constexpr VectorCartesian operator+(const VectorSpherical& v1, const VectorCartesian& v2) {return VectorCartesian(v1)+v2;}
-constexpr VectorCartesian operator-(const VectorSpherical& v1, const VectorCartesian& v2) {return VectorCartesian(v1)-v2;}
-//dot product
-constexpr SCALAR operator*(const VectorSpherical& v1, const VectorCartesian& v2) {return VectorCartesian(v1) * v2;}
-template<class T, typename std::enable_if<!std::numeric_limits<T>::is_integer, bool>::type> constexpr VectorCartesian operator*(const T& s, const VectorCartesian& v) {return v*s;}
-//Vector product
-constexpr VectorCartesian operator^(const VectorSpherical& v1, const VectorCartesian& v2) { return VectorCartesian(v1)^v2; }
-constexpr VectorCartesian operator-(const VectorSpherical& v1) {return -VectorCartesian(v1);}
+template<class T> constexpr VectorCartesianT<T>::VectorCartesianT(const VectorSphericalT<T>& v): VectorCartesianT(v.GetRho()*std::sin(v.GetPhi())*std::cos(v.GetTheta()), v.GetRho()*std::sin(v.GetPhi())*std::sin(v.GetTheta()), v.GetRho()*std::cos(v.GetPhi())){}
+
+typedef VectorSphericalT<SCALAR> VectorSpherical;
+typedef VectorSphericalT<float> VectorSphericalF32;
+
+template<class T> inline std::ostream& operator<<(std::ostream& o, const VectorSphericalT<T>& v)
+{
+  o << "(spherical: " << v.GetRho() << ", "  << v.GetTheta() << ", " <<  v.GetPhi() << ")";
+  return o;
+}
+
+static_assert(std::is_trivially_copyable<VectorSpherical>::value && sizeof(VectorSpherical) == 3*sizeof(SCALAR), "VectorSpherical should be a plain value type");
+
 }
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <cmath>
+
+#include "Vector.hpp"
+#include "RotMat.hpp"
+
+namespace IMT {
+
+/** \brief Batch of Cartesian vectors stored as a structure of arrays (one array per coordinate).
+ *  The batch routines below are simple loops on contiguous arrays that the compiler can vectorize.
+ */
+template<class T>
+class VectorBatchT
+{
+public:
+  typedef T Scalar;
+  VectorBatchT(void): m_x(), m_y(), m_z() {}
+  explicit VectorBatchT(size_t size): m_x(size), m_y(size), m_z(size) {}
+  ~VectorBatchT(void) = default;
+
+  size_t Size(void) const {return m_x.size();}
+  void Resize(size_t size) {m_x.resize(size); m_y.resize(size); m_z.resize(size);}
+
+  VectorCartesianT<T> Get(size_t i) const {return VectorCartesianT<T>(m_x[i], m_y[i], m_z[i]);}
+  void Set(size_t i, const VectorCartesianT<T>& v) {m_x[i] = v.GetX(); m_y[i] = v.GetY(); m_z[i] = v.GetZ();}
+
+  T* X(void) {return m_x.data();}
+  T* Y(void) {return m_y.data();}
+  T* Z(void) {return m_z.data();}
+  const T* X(void) const {return m_x.data();}
+  const T* Y(void) const {return m_y.data();}
+  const T* Z(void) const {return m_z.data();}
+
+  /** \brief Return the batch of the unit vectors with the spherical angles theta[i] and phi[i] */
+  static VectorBatchT FromSpherical(const std::vector<T>& theta, const std::vector<T>& phi)
+  {
+    VectorBatchT batch(theta.size());
+    for (size_t i = 0; i < batch.Size(); ++i)
+    {
+      const T sinP = std::sin(phi[i]);
+      batch.m_x[i] = sinP*std::cos(theta[i]);
+      batch.m_y[i] = sinP*std::sin(theta[i]);
+      batch.m_z[i] = std::cos(phi[i]);
+    }
+    return batch;
+  }
+
+private:
+  std::vector<T> m_x;
+  std::vector<T> m_y;
+  std::vector<T> m_z;
+};
+
+typedef VectorBatchT<SCALAR> VectorBatch;
+typedef VectorBatchT<float> VectorBatchF32;
+
+/** \brief Apply the rotation matrix to each vector of the batch (in place) */
+template<class T>
+void Rotation(VectorBatchT<T>& batch, const RotMatT<T>& rotationMat)
+{
+  T* x = batch.X();
+  T* y = batch.Y();
+  T* z = batch.Z();
+  const T m00(rotationMat(0,0)), m01(rotationMat(0,1)), m02(rotationMat(0,2));
+  const T m10(rotationMat(1,0)), m11(rotationMat(1,1)), m12(rotationMat(1,2));
+  const T m20(rotationMat(2,0)), m21(rotationMat(2,1)), m22(rotationMat(2,2));
+  for (size_t i = 0; i < batch.Size(); ++i)
+  {
+    const T vx(x[i]), vy(y[i]), vz(z[i]);
+    x[i] = m00*vx + m01*vy + m02*vz;
+    y[i] = m10*vx + m11*vy + m12*vz;
+    z[i] = m20*vx + m21*vy + m22*vz;
+  }
+}
+
+/** \brief Divide each vector of the batch by its norm (in place). The null vectors are kept null. */
+template<class T>
+void Normalize(VectorBatchT<T>& batch)
+{
+  T* x = batch.X();
+  T* y = batch.Y();
+  T* z = batch.Z();
+  for (size_t i = 0; i < batch.Size(); ++i)
+  {
+    const T n = std::sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+    const T invN = n != 0 ? T(1)/n : T(0);
+    x[i] *= invN;
+    y[i] *= invN;
+    z[i] *= invN;
+  }
+}
+}
@@ -19,6 +19,15 @@ class VectorialTrans
         {//default transformation do nothing
             return std::move(vectAfter);
         }
+        //Same transformations for the float32 geometry mode. By default they go through the double precision transformations.
+        virtual Coord3dCartF32 FromBeforeTrans3dToAfterTrans3dF32(const Coord3dCartF32& vectBefore)
+        {
+            return Coord3dCartF32(FromBeforeTrans3dToAfterTrans3d(Coord3dCart(vectBefore)));
+        }
+        virtual Coord3dCartF32 FromAfterTrans3dToBeforeTrans3dF32(const Coord3dCartF32& vectAfter)
+        {
+            return Coord3dCartF32(FromAfterTrans3dToBeforeTrans3d(Coord3dCart(vectAfter)));
+        }
 
     private:
 };
@@ -15,11 +15,16 @@ class DynamicPosition
 {
 public:
   /** Constructor for a static position */
-  DynamicPosition(Quaternion rotationQuaternion): m_isStatic(true), m_firstTimestamp(0.0), m_rotQuaternion(rotationQuaternion), m_inputPositionsTrace(){}
+  DynamicPosition(Quaternion rotationQuaternion): m_isStatic(true), m_firstTimestamp(0.0), m_rotQuaternion(rotationQuaternion),
+    m_rotMat(RotMat::FromQuaternion(rotationQuaternion)), m_invRotMat(m_rotMat.Transpose()), m_inputPositionsTrace(){}
   /** Constructor that take the path to an input positions trace file */
-  DynamicPosition(std::string pathToInputPositionsTrace): m_isStatic(false), m_firstTimestamp(-1.0), m_rotQuaternion(), m_inputPositionsTrace(pathToInputPositionsTrace){}
+  DynamicPosition(std::string pathToInputPositionsTrace): m_isStatic(false), m_firstTimestamp(-1.0), m_rotQuaternion(),
+    m_rotMat(), m_invRotMat(), m_inputPositionsTrace(pathToInputPositionsTrace){}
 
   const Quaternion& GetNextPosition(void) const { return m_rotQuaternion;}
+  /** Matrix of the current position (and its inverse): cheaper than the quaternion to rotate many points. Rebuilt once by each SetNextPosition */
+  const RotMat& GetNextRotMat(void) const { return m_rotMat;}
+  const RotMat& GetNextInvRotMat(void) const { return m_invRotMat;}
 
   void SetNextPosition(double relatifTimestamp);
 
@@ -27,6 +32,10 @@ private:
   bool m_isStatic;
   double m_firstTimestamp;
   Quaternion m_rotQuaternion;
+  RotMat m_rotMat;
+  RotMat m_invRotMat;
   std::ifstream m_inputPositionsTrace;
+
+  void ReadNextPosition(double relatifTimestamp);
 };
 }
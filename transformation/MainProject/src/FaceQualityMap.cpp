@@ -0,0 +1,100 @@
+/**
+ * Compute the quality of each face (or tile) of a layout
+ */
+
+#include "FaceQualityMap.hpp"
+#include "TaskPool.hpp"
+
+#include <stdexcept>
+
+using namespace IMT;
+
+FaceQualityMap::FaceQualityMap(Layout& layoutRef, Layout& layoutFaces):
+  m_width(layoutFaces.GetWidth()), m_height(layoutFaces.GetHeight()), m_nbFaces(layoutFaces.GetNbFaces()),
+  m_faceIds(m_width*m_height, -1), m_surfaces(m_width*m_height, 0)
+{
+  if (layoutRef.GetWidth() != m_width || layoutRef.GetHeight() != m_height)
+  {
+    throw std::invalid_argument("Per face quality computation require pictures to have the same width and height");
+  }
+  TaskPool::GetDefault().ParallelFor(0, m_height, TaskPool::GetGrain(m_width), [&](size_t firstRow, size_t lastRow)
+  {
+    for (unsigned int j = firstRow; j < lastRow; ++j)
+    {
+      for (unsigned int i = 0; i < m_width; ++i)
+      {
+        int faceId = layoutFaces.GetFaceId(CoordI(i,j));
+        if (faceId >= 0 && unsigned(faceId) < m_nbFaces)
+        {
+          m_faceIds[j*m_width+i] = faceId;
+          //same weight as the WS-PSNR
+          m_surfaces[j*m_width+i] = (layoutRef.GetSurfacePixel(CoordI(i,j)) + layoutFaces.GetSurfacePixel(CoordI(i,j)))/2.0;
+        }
+      }
+    }
+  });
+}
+
+std::tuple<std::vector<double>, std::vector<double>> FaceQualityMap::ComputeQuality(const Picture& pictRef, const Picture& pict) const
+{
+  if (unsigned(pictRef.GetWidth()) != m_width || unsigned(pictRef.GetHeight()) != m_height || unsigned(pict.GetWidth()) != m_width || unsigned(pict.GetHeight()) != m_height)
+  {
+    throw std::invalid_argument("Per face quality computation require pictures with the size of the layouts");
+  }
+  cv::Mat vRefYUV;
+  cv::Mat vArgYUV;
+  cv::cvtColor(pictRef.GetMat(), vRefYUV, cv::COLOR_BGR2YUV);
+  cv::cvtColor(pict.GetMat(), vArgYUV, cv::COLOR_BGR2YUV);
+
+  //sums[4*f] = sum of the squared errors, sums[4*f+1] = weighted sum of the squared errors, sums[4*f+2] = number of pixels, sums[4*f+3] = sum of the surfaces
+  std::vector<double> sums = TaskPool::GetDefault().ParallelReduce(0, m_height, TaskPool::GetGrain(m_width), std::vector<double>(4*m_nbFaces, 0),
+    [&](size_t firstRow, size_t lastRow)
+    {
+      std::vector<double> localSums(4*m_nbFaces, 0);
+      for (unsigned int j = firstRow; j < lastRow; ++j)
+      {
+        for (unsigned int i = 0; i < m_width; ++i)
+        {
+          int faceId = m_faceIds[j*m_width+i];
+          if (faceId < 0)
+          {
+            continue;
+          }
+          double diff = double(vRefYUV.at<Pixel>(j, i)[0]) - double(vArgYUV.at<Pixel>(j, i)[0]);
+          double surface = m_surfaces[j*m_width+i];
+          localSums[4*faceId] += diff*diff;
+          localSums[4*faceId+1] += surface*diff*diff;
+          localSums[4*faceId+2] += 1;
+          localSums[4*faceId+3] += surface;
+        }
+      }
+      return localSums;
+    },
+    [](std::vector<double> a, const std::vector<double>& b)
+    {
+      for (size_t k = 0; k < a.size(); ++k)
+      {
+        a[k] += b[k];
+      }
+      return a;
+    });
+  std::vector<double> sumSquare(m_nbFaces), sumWeightedSquare(m_nbFaces), nbPixels(m_nbFaces), sumSurface(m_nbFaces);
+  for (unsigned int f = 0; f < m_nbFaces; ++f)
+  {
+    sumSquare[f] = sums[4*f];
+    sumWeightedSquare[f] = sums[4*f+1];
+    nbPixels[f] = sums[4*f+2];
+    sumSurface[f] = sums[4*f+3];
+  }
+
+  std::vector<double> psnr(m_nbFaces, 100.0);
+  std::vector<double> wspsnr(m_nbFaces, 100.0);
+  for (unsigned int f = 0; f < m_nbFaces; ++f)
+  {
+    double mse = nbPixels[f] > 0 ? sumSquare[f]/nbPixels[f] : 0;
+    double wsmse = sumSurface[f] > 0 ? sumWeightedSquare[f]/sumSurface[f] : 0;
+    psnr[f] = mse != 0 ? 10.0*std::log10((255*255)/mse) : 100.0;
+    wspsnr[f] = wsmse != 0 ? 10.0*std::log10((255*255)/wsmse) : 100.0;
+  }
+  return std::make_tuple(std::move(psnr), std::move(wspsnr));
+}
@@ -0,0 +1,244 @@
+/**
+ * Frame level pipeline: decode, projection (one stage per flow), quality measure and encode stages connected by bounded queues
+ */
+
+#include "FramePipeline.hpp"
+
+#include <thread>
+
+#include "TaskPool.hpp"
+#include "Profiler.hpp"
+
+using namespace IMT;
+
+namespace
+{
+  /** Name of the profiler measure of each flow (built once per run) */
+  std::vector<std::string> FlowMeasureNames(const std::string& prefix, unsigned int nbFlows)
+  {
+    std::vector<std::string> names;
+    for (unsigned int flowId = 0; flowId < nbFlows; ++flowId)
+    {
+      names.push_back(prefix+std::to_string(flowId));
+    }
+    return names;
+  }
+}
+
+void FramePipeline::RunSequential(int nbFrames, DecodeFunction& decode, ProjectFunction& project, FrameFunction& measure, FrameFunction& encode)
+{
+  const auto projectionNames = FlowMeasureNames("projection/flow", m_nbFlows);
+  for (int frameId = 0; frameId < nbFrames; ++frameId)
+  {
+    Profiler::FrameScope frameScope(frameId, m_profiler);
+    FramePictures picts = Profiler::Time("decode", [&]{return decode(frameId);});
+    if (picts.empty())
+    {
+      continue;
+    }
+    //the flows are independent: they are projected concurrently on the shared task pool
+    TaskPool::GetDefault().ParallelFor(0, m_nbFlows, 1, [&](size_t firstFlow, size_t lastFlow)
+    {
+      Profiler::FrameScope flowFrameScope(frameId, m_profiler);
+      for (size_t flowId = firstFlow; flowId < lastFlow; ++flowId)
+      {
+        Profiler::ScopedTimer timer(projectionNames[flowId]);
+        picts[flowId] = project(flowId, frameId, picts[flowId]);
+      }
+    });
+    Profiler::Time("measure", [&]{measure(frameId, picts);});
+    Profiler::Time("encode", [&]{encode(frameId, picts);});
+  }
+}
+
+bool FramePipeline::WaitMeasured(unsigned long nbFrames)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_measured.wait(lock, [this, nbFrames]{return m_isAborted || m_nbMeasuredFrames >= nbFrames;});
+  return !m_isAborted;
+}
+
+void FramePipeline::SetMeasured(unsigned long nbFrames)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_nbMeasuredFrames = nbFrames;
+  m_measured.notify_all();
+}
+
+void FramePipeline::Abort(std::exception_ptr error, const std::function<void(void)>& closeQueues)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_error == nullptr)
+    {
+      m_error = error;
+    }
+    m_isAborted = true;
+    m_measured.notify_all();
+  }
+  closeQueues();
+}
+
+void FramePipeline::Run(int nbFrames, DecodeFunction decode, ProjectFunction project, FrameFunction measure, FrameFunction encode)
+{
+  if (m_queueSize == 0)
+  {
+    RunSequential(nbFrames, decode, project, measure, encode);
+    return;
+  }
+  m_nbMeasuredFrames = 0;
+  m_isAborted = false;
+  m_error = nullptr;
+
+  std::vector<std::shared_ptr<BoundedQueue<FlowJob>>> projectInQueues;
+  std::vector<std::shared_ptr<BoundedQueue<FlowJob>>> projectOutQueues;
+  for (unsigned int flowId = 0; flowId < m_nbFlows; ++flowId)
+  {
+    projectInQueues.push_back(std::make_shared<BoundedQueue<FlowJob>>(m_queueSize));
+    projectOutQueues.push_back(std::make_shared<BoundedQueue<FlowJob>>(m_queueSize));
+  }
+  BoundedQueue<FrameJob> encodeQueue(m_queueSize);
+  //the depth of a queue is sampled after each push (number of frames waiting for the next stage)
+  const auto projectionNames = FlowMeasureNames("projection/flow", m_nbFlows);
+  const auto projectQueueNames = FlowMeasureNames("queue/projection/flow", m_nbFlows);
+  const auto measureQueueNames = FlowMeasureNames("queue/measure/flow", m_nbFlows);
+  auto closeQueues = [&]()
+  {
+    for (unsigned int flowId = 0; flowId < m_nbFlows; ++flowId)
+    {
+      projectInQueues[flowId]->Close();
+      projectOutQueues[flowId]->Close();
+    }
+    encodeQueue.Close();
+  };
+
+  std::vector<std::thread> threads;
+  //Decode stage: the decoders are read in order, the pictures of a processed frame are dispatched to the projection stages
+  threads.emplace_back([&]()
+  {
+    try
+    {
+      for (int frameId = 0; frameId < nbFrames; ++frameId)
+      {
+        Profiler::FrameScope frameScope(frameId, m_profiler);
+        FramePictures picts = Profiler::Time("decode", [&]{return decode(frameId);});
+        if (picts.empty())
+        {
+          continue;
+        }
+        for (unsigned int flowId = 0; flowId < m_nbFlows; ++flowId)
+        {
+          if (!projectInQueues[flowId]->Push(FlowJob(frameId, picts[flowId])))
+          {
+            return;
+          }
+          Profiler::AddCount(projectQueueNames[flowId], projectInQueues[flowId]->GetSize());
+        }
+      }
+      for (auto& q: projectInQueues)
+      {
+        q->Close();
+      }
+    }
+    catch (...)
+    {
+      Abort(std::current_exception(), closeQueues);
+    }
+  });
+  //Projection stages: one per flow, the layouts of a flow are only used by its own stage
+  for (unsigned int flowId = 0; flowId < m_nbFlows; ++flowId)
+  {
+    threads.emplace_back([&, flowId]()
+    {
+      try
+      {
+        FlowJob job;
+        unsigned long nbProjectedFrames = 0;
+        while (projectInQueues[flowId]->Pop(job))
+        {
+          if (m_lockstepMeasure && !WaitMeasured(nbProjectedFrames))
+          {
+            return;
+          }
+          Profiler::FrameScope frameScope(job.m_frameId, m_profiler);
+          {
+            Profiler::ScopedTimer timer(projectionNames[flowId]);
+            job.m_pict = project(flowId, job.m_frameId, job.m_pict);
+          }
+          ++nbProjectedFrames;
+          if (!projectOutQueues[flowId]->Push(std::move(job)))
+          {
+            return;
+          }
+          Profiler::AddCount(measureQueueNames[flowId], projectOutQueues[flowId]->GetSize());
+        }
+        projectOutQueues[flowId]->Close();
+      }
+      catch (...)
+      {
+        Abort(std::current_exception(), closeQueues);
+      }
+    });
+  }
+  //Measure stage: gather the output pictures of all the flows for the next frame
+  threads.emplace_back([&]()
+  {
+    try
+    {
+      unsigned long nbMeasuredFrames = 0;
+      while (true)
+      {
+        FrameJob frame;
+        FlowJob job;
+        for (unsigned int flowId = 0; flowId < m_nbFlows; ++flowId)
+        {
+          if (!projectOutQueues[flowId]->Pop(job))
+          {
+            encodeQueue.Close();
+            return;
+          }
+          frame.m_frameId = job.m_frameId;
+          frame.m_picts.push_back(std::move(job.m_pict));
+        }
+        Profiler::FrameScope frameScope(frame.m_frameId, m_profiler);
+        Profiler::Time("measure", [&]{measure(frame.m_frameId, frame.m_picts);});
+        SetMeasured(++nbMeasuredFrames);
+        if (!encodeQueue.Push(std::move(frame)))
+        {
+          return;
+        }
+        Profiler::AddCount("queue/encode", encodeQueue.GetSize());
+      }
+    }
+    catch (...)
+    {
+      Abort(std::current_exception(), closeQueues);
+    }
+  });
+  //Encode stage
+  threads.emplace_back([&]()
+  {
+    try
+    {
+      FrameJob frame;
+      while (encodeQueue.Pop(frame))
+      {
+        Profiler::FrameScope frameScope(frame.m_frameId, m_profiler);
+        Profiler::Time("encode", [&]{encode(frame.m_frameId, frame.m_picts);});
+      }
+    }
+    catch (...)
+    {
+      Abort(std::current_exception(), closeQueues);
+    }
+  });
+
+  for (auto& t: threads)
+  {
+    t.join();
+  }
+  if (m_error != nullptr)
+  {
+    std::rethrow_exception(m_error);
+  }
+}
@@ -0,0 +1,417 @@
+/**
+ * Long running server: receive job configurations on a local socket and run them in the same process (no start up cost per job)
+ */
+
+#include "JobServer.hpp"
+
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <boost/property_tree/json_parser.hpp>
+
+using namespace IMT;
+
+namespace
+{
+  constexpr int c_listenBacklog = 16;
+
+  std::string QuoteJSON(const std::string& str)
+  {
+    std::ostringstream out;
+    out << '"';
+    for (unsigned char c: str)
+    {
+      switch (c)
+      {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+          if (c < 0x20)
+          {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+          }
+          else
+          {
+            out << c;
+          }
+      }
+    }
+    out << '"';
+    return out.str();
+  }
+
+  //NaN and infinity are not valid in JSON (e.g. the PSNR of two identical pictures)
+  std::string ToJSON(double value)
+  {
+    if (!std::isfinite(value))
+    {
+      return "null";
+    }
+    std::ostringstream out;
+    out << std::setprecision(12) << value;
+    return out.str();
+  }
+
+  //boost::property_tree::write_json writes the top level lists as objects: the layoutFlow list would not be valid anymore
+  std::string WriteJSON(const boost::property_tree::ptree& node)
+  {
+    if (node.empty())
+    {
+      return QuoteJSON(node.data());
+    }
+    bool isList = true;
+    for (const auto& child: node)
+    {
+      isList = isList && child.first.empty();
+    }
+    std::string json = isList ? "[" : "{";
+    bool isFirst = true;
+    for (const auto& child: node)
+    {
+      json += (isFirst ? "" : ",")+(isList ? "" : QuoteJSON(child.first)+":")+WriteJSON(child.second);
+      isFirst = false;
+    }
+    return json+(isList ? "]" : "}");
+  }
+
+  std::string ErrnoMessage(const std::string& what)
+  {
+    return what+": "+std::strerror(errno);
+  }
+
+  //release the job slot when the job ends (also when it throws)
+  struct JobSlot
+  {
+    JobSlot(std::mutex& mutex, std::condition_variable& jobFinished, unsigned int& nbRunningJobs):
+      m_mutex(mutex), m_jobFinished(jobFinished), m_nbRunningJobs(nbRunningJobs) {}
+    ~JobSlot(void)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_nbRunningJobs;
+      }
+      m_jobFinished.notify_one();
+    }
+    std::mutex& m_mutex;
+    std::condition_variable& m_jobFinished;
+    unsigned int& m_nbRunningJobs;
+  };
+}
+
+JobServer::JobServer(const std::string& address, unsigned int maxRunningJobs, std::ostream* log):
+  m_address(address), m_listenFd(-1), m_maxRunningJobs(std::max(1u, maxRunningJobs)), m_nullLog(nullptr),
+  m_log(log != nullptr ? *log : m_nullLog), m_logMutex(), m_isStopped(false), m_nbJobs(0), m_mutex(), m_jobFinished(),
+  m_nbRunningJobs(0), m_connectionFds(), m_connectionThreads(), m_finishedThreadIds()
+{
+  if (address.compare(0, 5, "unix:") == 0)
+  {
+    const std::string path = address.substr(5);
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+    {
+      throw std::invalid_argument("Not valid Unix socket path: "+path);
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0)
+    {
+      throw std::invalid_argument(ErrnoMessage("Cannot create the socket "+address));
+    }
+    //socket file left by a previous server
+    unlink(path.c_str());
+    if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+      close(m_listenFd);
+      throw std::invalid_argument(ErrnoMessage("Cannot bind the socket "+address));
+    }
+  }
+  else if (address.compare(0, 4, "tcp:") == 0)
+  {
+    size_t pos = 0;
+    int port = -1;
+    try
+    {
+      port = std::stoi(address.substr(4), &pos);
+    }
+    catch (const std::logic_error&) {}
+    if (port <= 0 || port > 65535 || pos != address.size()-4)
+    {
+      throw std::invalid_argument("Not valid TCP port: "+address.substr(4));
+    }
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    //only the local clients can submit jobs
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    m_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenFd < 0)
+    {
+      throw std::invalid_argument(ErrnoMessage("Cannot create the socket "+address));
+    }
+    int reuse = 1;
+    setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+      close(m_listenFd);
+      throw std::invalid_argument(ErrnoMessage("Cannot bind the socket "+address));
+    }
+  }
+  else
+  {
+    throw std::invalid_argument("Server address "+address+" not recognized (unix:<path> or tcp:<port>)");
+  }
+  if (listen(m_listenFd, c_listenBacklog) < 0)
+  {
+    close(m_listenFd);
+    throw std::invalid_argument(ErrnoMessage("Cannot listen on the socket "+address));
+  }
+}
+
+JobServer::~JobServer(void)
+{
+  Stop();
+  for (auto& connectionThread: m_connectionThreads)
+  {
+    connectionThread.second.join();
+  }
+  close(m_listenFd);
+  if (m_address.compare(0, 5, "unix:") == 0)
+  {
+    unlink(m_address.substr(5).c_str());
+  }
+}
+
+void JobServer::Serve(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log << "Waiting for jobs on " << m_address << " (" << m_maxRunningJobs << " concurrent jobs)" << std::endl;
+  }
+  while (!m_isStopped)
+  {
+    int fd = accept(m_listenFd, nullptr, nullptr);
+    if (fd < 0)
+    {
+      if (errno == EINTR || errno == ECONNABORTED)
+      {
+        continue;
+      }
+      if (!m_isStopped)
+      {
+        std::lock_guard<std::mutex> lock(m_logMutex);
+        m_log << ErrnoMessage("Cannot accept a connection") << std::endl;
+      }
+      break;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isStopped)
+    {
+      close(fd);
+      break;
+    }
+    JoinFinishedThreads();
+    m_connectionFds.insert(fd);
+    std::thread connectionThread(&JobServer::HandleConnection, this, fd);
+    auto threadId = connectionThread.get_id();
+    m_connectionThreads.emplace(threadId, std::move(connectionThread));
+  }
+}
+
+void JobServer::JoinFinishedThreads(void)
+{
+  for (auto threadId: m_finishedThreadIds)
+  {//the thread has nothing left to do after giving its id: the join does not wait
+    auto it = m_connectionThreads.find(threadId);
+    it->second.join();
+    m_connectionThreads.erase(it);
+  }
+  m_finishedThreadIds.clear();
+}
+
+void JobServer::Stop(void)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_isStopped = true;
+  //wake up accept and the blocking reads; the file descriptors are closed by their owner
+  shutdown(m_listenFd, SHUT_RDWR);
+  for (int fd: m_connectionFds)
+  {
+    shutdown(fd, SHUT_RDWR);
+  }
+  m_jobFinished.notify_all();
+}
+
+TransJob::Config JobServer::ParseJobConfig(const std::string& json)
+{
+  TransJob::Config jsonConfig;
+  try
+  {
+    std::istringstream ss(json);
+    boost::property_tree::read_json(ss, jsonConfig);
+  }
+  catch (const boost::property_tree::ptree_error& e)
+  {
+    throw std::invalid_argument(std::string("Error while parsing the job configuration: ")+e.what());
+  }
+  //the process wide settings are shared by the concurrent jobs: they are set once when the server starts
+  auto globalSection = jsonConfig.get_child_optional("Global");
+  for (const auto& key: TransJob::GetProcessSettingKeys())
+  {
+    if (globalSection && globalSection->count(key) > 0)
+    {
+      throw std::invalid_argument("Global."+key+" is a setting of the server process: it cannot be changed by a job");
+    }
+  }
+  TransJob::Config config;
+  for (const auto& section: jsonConfig)
+  {
+    if (section.first.empty() || section.second.empty())
+    {
+      throw std::invalid_argument("The job configuration should be a JSON object of sections: "+QuoteJSON(section.first)+" is not a section");
+    }
+    auto& configSection = config.put_child(TransJob::Config::path_type(section.first, '\0'), TransJob::Config());
+    for (const auto& key: section.second)
+    {
+      if (key.second.empty())
+      {
+        configSection.put(TransJob::Config::path_type(key.first, '\0'), key.second.data());
+      }
+      else
+      {//list or object: stored as in the ini file, parsed later by the job
+        configSection.put(TransJob::Config::path_type(key.first, '\0'), WriteJSON(key.second));
+      }
+    }
+  }
+  return config;
+}
+
+void JobServer::HandleConnection(int fd)
+{
+  std::mutex sendMutex;
+  std::string buffer;
+  char readBuffer[4096];
+  ssize_t nbRead;
+  while (!m_isStopped && (nbRead = recv(fd, readBuffer, sizeof(readBuffer), 0)) != 0)
+  {
+    if (nbRead < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+    buffer.append(readBuffer, nbRead);
+    size_t endOfLine;
+    while ((endOfLine = buffer.find('\n')) != std::string::npos)
+    {
+      std::string line = buffer.substr(0, endOfLine);
+      buffer.erase(0, endOfLine+1);
+      if (line.find_first_not_of(" \t\r") != std::string::npos)
+      {
+        RunJob(fd, sendMutex, line);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_connectionFds.erase(fd);
+  close(fd);
+  m_finishedThreadIds.push_back(std::this_thread::get_id());
+}
+
+void JobServer::RunJob(int fd, std::mutex& sendMutex, const std::string& json)
+{
+  const int jobId = ++m_nbJobs;
+  const std::string jobHeader = "{\"job\": "+std::to_string(jobId)+", \"event\": ";
+  if (!Send(fd, sendMutex, jobHeader+"\"accepted\"}"))
+  {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobFinished.wait(lock, [this] () {return m_isStopped || m_nbRunningJobs < m_maxRunningJobs;});
+    if (m_isStopped)
+    {
+      return;
+    }
+    ++m_nbRunningJobs;
+  }
+  JobSlot jobSlot(m_mutex, m_jobFinished, m_nbRunningJobs);
+  {
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log << "Start job " << jobId << std::endl;
+  }
+  auto startTime = std::chrono::high_resolution_clock::now();
+  try
+  {
+    TransJob job(ParseJobConfig(json), nullptr, false);
+    job.SetQualityCallback([&] (int frameId, unsigned int flowId, const std::vector<std::string>& qualityNames, const std::vector<double>& quality)
+    {
+      std::string message = jobHeader+"\"quality\", \"frame\": "+std::to_string(frameId)+", \"flow\": "+std::to_string(flowId)+", \"quality\": {";
+      for (size_t i = 0; i < qualityNames.size(); ++i)
+      {
+        message += (i == 0 ? "" : ", ")+QuoteJSON(qualityNames[i])+": "+ToJSON(quality[i]);
+      }
+      Send(fd, sendMutex, message+"}}");
+    });
+    job.SetOutputCallback([&] (int frameId, const FramePipeline::FramePictures&)
+    {
+      //stop the job if the client is gone: nobody reads the results
+      if (!Send(fd, sendMutex, jobHeader+"\"frame\", \"frame\": "+std::to_string(frameId)+"}"))
+      {
+        throw std::runtime_error("Connection closed by the client");
+      }
+    });
+    job.Run();
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now()-startTime;
+    Send(fd, sendMutex, jobHeader+"\"done\", \"frames\": "+std::to_string(job.GetNbProcessedFrames())+", \"duration\": "+ToJSON(duration.count())+"}");
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log << "Job " << jobId << " done: " << job.GetNbProcessedFrames() << " frames in " << duration.count() << "s" << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    Send(fd, sendMutex, jobHeader+"\"error\", \"message\": "+QuoteJSON(e.what())+"}");
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log << "Job " << jobId << " failed: " << e.what() << std::endl;
+  }
+}
+
+bool JobServer::Send(int fd, std::mutex& sendMutex, const std::string& message)
+{
+  std::lock_guard<std::mutex> lock(sendMutex);
+  const std::string line = message+"\n";
+  size_t nbSent = 0;
+  while (nbSent < line.size())
+  {
+    //no SIGPIPE if the client is gone
+    ssize_t n = send(fd, line.data()+nbSent, line.size()-nbSent, MSG_NOSIGNAL);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    nbSent += n;
+  }
+  return true;
+}
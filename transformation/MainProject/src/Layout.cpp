@@ -1,5 +1,7 @@
 #include "Layout.hpp"
+#include "Profiler.hpp"
 #include <stdexcept>
+#include <algorithm>
 
 
 using namespace IMT;
@@ -9,9 +11,63 @@ Coord3dCart Layout::From2dTo3d(const CoordI& pixelCoord) const
     return m_vectorialTrans->FromBeforeTrans3dToAfterTrans3d(FromNormalizedInfoTo3d(From2dToNormalizedFaceInfo(pixelCoord)));
 }
 
-CoordF Layout::FromSphereTo2d(const Coord3dSpherical& sphericalCoord) const
+CoordF Layout::FromSphereTo2d(const Coord3dCart& coord) const
 {
-    return FromNormalizedInfoTo2d(From3dToNormalizedFaceInfo(m_vectorialTrans->FromAfterTrans3dToBeforeTrans3d(sphericalCoord)));
+    return FromNormalizedInfoTo2d(From3dToNormalizedFaceInfo(m_vectorialTrans->FromAfterTrans3dToBeforeTrans3d(coord)));
+}
+
+void Layout::FromSphereTo2dBatch(const VectorBatch& coords, size_t start, size_t count, CoordF* out) const
+{
+    for (size_t k = 0; k < count; ++k)
+    {
+        out[k] = FromSphereTo2d(coords.Get(start+k));
+    }
+}
+
+Coord3dCartF32 Layout::From2dTo3dF32(const CoordI& pixelCoord) const
+{
+    return m_vectorialTrans->FromBeforeTrans3dToAfterTrans3dF32(FromNormalizedInfoTo3dF32(From2dToNormalizedFaceInfo(pixelCoord)));
+}
+
+CoordF Layout::FromSphereTo2dF32(const Coord3dCartF32& coord) const
+{
+    return FromNormalizedInfoTo2d(From3dToNormalizedFaceInfoF32(m_vectorialTrans->FromAfterTrans3dToBeforeTrans3dF32(coord)));
+}
+
+bool Layout::MapPixel(const Layout& destLayout, const CoordI& pixel, GeometryPrecision precision, CoordF& coord) const
+{
+    if (precision == GeometryPrecision::Float32)
+    {
+        Coord3dCartF32 thisPixel3d = destLayout.From2dTo3dF32(pixel);
+        float norm = thisPixel3d.Norm();
+        if (norm == 0 || std::isnan(norm))
+        {
+            return false;
+        }
+        coord = FromSphereTo2dF32(thisPixel3d);
+        return true;
+    }
+    Coord3dCart thisPixel3d = destLayout.From2dTo3d(pixel); // coordinate of the pixel in the output picture in the 3d space
+    SCALAR norm = thisPixel3d.Norm();
+    if (norm == 0 || std::isnan(norm))
+    {
+        return false;
+    }
+    coord = FromSphereTo2d(thisPixel3d); //coordinate of the corresponding pixel in the input picture
+    return true;
+}
+
+void Layout::MapRow(const Layout& destLayout, unsigned int row, VectorBatch& points, CoordF* coords, char* onSphere) const
+{
+    for (unsigned int i = 0; i < destLayout.m_outWidth; ++i)
+    {
+        Coord3dCart thisPixel3d = destLayout.From2dTo3d(CoordI(i, row));
+        SCALAR norm = thisPixel3d.Norm();
+        onSphere[i] = norm != 0 && !std::isnan(norm);
+        //the black pixels get a valid direction: their position is not used
+        points.Set(i, onSphere[i] ? thisPixel3d : Coord3dCart(1, 0, 0));
+    }
+    FromSphereTo2dBatch(points, 0, destLayout.m_outWidth, coords);
 }
 
 std::shared_ptr<Picture> Layout::ToLayout(const Picture& layoutPic, const Layout& destLayout) const
@@ -20,31 +76,90 @@ std::shared_ptr<Picture> Layout::ToLayout(const Picture& layoutPic, const Layout
     {
         throw std::logic_error("Layout have to be initialized first before using it");
     }
-    cv::Mat picMat = cv::Mat::zeros(destLayout.m_outHeight, destLayout.m_outWidth, layoutPic.GetMat().type());
-    auto pic = std::make_shared<Picture>(picMat);
-    #pragma omp parallel for collapse(2) shared(pic, layoutPic, destLayout) schedule(dynamic)
-    for (auto i = 0; i < pic->GetMat().cols; ++i)
+    //the buffer is recycled from a previous frame: every pixel is written
+    auto pic = PicturePool::GetDefault()->Get(destLayout.m_outHeight, destLayout.m_outWidth, layoutPic.GetMat().type());
+    //number of interpolated pixels, counted per chunk: the chunks are not run on the profiled thread
+    std::atomic<unsigned long> nbInterpolated(0);
+    //chunks of rows of the output picture, run on the shared task pool
+    //with the double geometry the rows are mapped with FromSphereTo2dBatch, the float32 geometry maps the pixels one by one
+    const bool mapRows = m_geometryPrecision == GeometryPrecision::Double;
+    TaskPool::GetDefault().ParallelFor(0, pic->GetMat().rows, TaskPool::GetGrain(pic->GetMat().cols), [&](size_t firstRow, size_t lastRow)
     {
-        for (auto j = 0; j < pic->GetMat().rows; ++j)
+        unsigned long chunkNbInterpolated = 0;
+        const size_t rowSize = mapRows ? pic->GetMat().cols : 0;
+        VectorBatch rowPoints(rowSize);
+        std::vector<CoordF> rowCoords(rowSize);
+        std::vector<char> rowOnSphere(rowSize);
+        for (int j = int(firstRow); j < int(lastRow); ++j)
         {
-            Coord3dSpherical thisPixel3dPolar = destLayout.From2dTo3d(CoordI(i,j)); // coordinate of the pixel (i, j) in the output picture in the 3d space
-            if (thisPixel3dPolar.Norm() != 0 && !std::isnan(thisPixel3dPolar.Norm()))
-            {//Keep the pixel black (i.e. do nothing) if == 0
-                auto coordPixelOriginalPic = FromSphereTo2d(thisPixel3dPolar); //coordinate of the corresponding pixel in the input picture
-                if (inInterval(coordPixelOriginalPic.x, 0, layoutPic.GetMat().cols) && inInterval(coordPixelOriginalPic.y, 0, layoutPic.GetMat().rows))
+            if (mapRows)
+            {
+                MapRow(destLayout, j, rowPoints, rowCoords.data(), rowOnSphere.data());
+            }
+            for (auto i = 0; i < pic->GetMat().cols; ++i)
+            {
+                Pixel value(0, 0, 0); //the pixel is black if the pixel (i, j) is not on the sphere
+                CoordF coordPixelOriginalPic; //coordinate of the corresponding pixel in the input picture
+                bool onSphere = false;
+                if (mapRows)
                 {
-                    pic->SetValue(CoordI(i,j), layoutPic.GetInterPixel(coordPixelOriginalPic, m_interpol));
+                    coordPixelOriginalPic = rowCoords[i];
+                    onSphere = rowOnSphere[i] != 0;
                 }
                 else
                 {
-                //std::cout << "(i,j)= (" << i << "(max = "<< pic->GetMat().cols << "), "<<j <<") : theta = " << thisPixel3dPolar.GetTheta() << "; phi=" << thisPixel3dPolar.GetPhi() << "; iOrr = " << coordPixelOriginalPic.x << "; jOrr = " << coordPixelOriginalPic.y << "Max (i,j)orr = " << layoutPic.GetMat().cols << ", " << layoutPic.GetMat().rows << std::endl;
+                    onSphere = MapPixel(destLayout, CoordI(i,j), m_geometryPrecision, coordPixelOriginalPic);
                 }
+                if (onSphere)
+                {
+                    if (inInterval(coordPixelOriginalPic.x, 0, layoutPic.GetMat().cols) && inInterval(coordPixelOriginalPic.y, 0, layoutPic.GetMat().rows))
+                    {
+                        value = layoutPic.GetInterPixel(coordPixelOriginalPic, m_interpol);
+                        ++chunkNbInterpolated;
+                    }
+                }
+                pic->SetValue(CoordI(i,j), value);
             }
         }
-    }
+        nbInterpolated += chunkNbInterpolated;
+    }, m_maxThreads);
+    Profiler::AddCount("pixelsRemapped", double(pic->GetMat().rows)*pic->GetMat().cols);
+    Profiler::AddCount("samplesInterpolated", nbInterpolated);
     return pic;
 }
 
+double Layout::GetGeometryPrecisionError(const Layout& destLayout) const
+{
+    if (!m_isInit)
+    {
+        throw std::logic_error("Layout have to be initialized first before using it");
+    }
+    std::vector<double> rowMaxError(destLayout.m_outHeight, 0);
+    TaskPool::GetDefault().ParallelFor(0, destLayout.m_outHeight, TaskPool::GetGrain(destLayout.m_outWidth), [&](size_t firstRow, size_t lastRow)
+    {
+        for (unsigned int j = firstRow; j < lastRow; ++j)
+        {
+            for (unsigned int i = 0; i < destLayout.m_outWidth; ++i)
+            {
+                CoordF coordDouble, coordFloat;
+                bool okDouble = MapPixel(destLayout, CoordI(i,j), GeometryPrecision::Double, coordDouble);
+                bool okFloat = MapPixel(destLayout, CoordI(i,j), GeometryPrecision::Float32, coordFloat);
+                if (okDouble && okFloat)
+                {
+                    double dx = std::abs(coordDouble.x-coordFloat.x);
+                    if (WrapsHorizontally())
+                    {//the horizontal distance is taken modulo the width: x = 0 and x = width are the same point
+                        dx = std::min(dx, m_outWidth-dx);
+                    }
+                    double dy = coordDouble.y-coordFloat.y;
+                    rowMaxError[j] = std::max(rowMaxError[j], std::sqrt(dx*dx+dy*dy));
+                }
+            }
+        }
+    }, m_maxThreads);
+    return rowMaxError.empty() ? 0 : *std::max_element(rowMaxError.begin(), rowMaxError.end());
+}
+
 double Layout::GetSurfacePixel(const CoordI& pixelCoord)
 {
   NormalizedFaceInfo nfi_0_0 = From2dToNormalizedFaceInfo(pixelCoord);
@@ -94,11 +94,25 @@ unsigned int LayoutCubeMap::JEndOffset(LayoutCubeMapBased::Faces f) const
     }
 }
 
-LayoutCubeMapBased::Faces LayoutCubeMap::From2dToFace(unsigned int i, unsigned int j) const
+std::array<LayoutCubeMapBased::FaceRectangle,6> LayoutCubeMap::ComputeFaceRectangles(void) const
+{
+    std::array<FaceRectangle,6> faceRectangles;
+    for (auto f: ClassificationOrder())
+    {
+        int facePositionId = m_fp.m_faceToId.at(f);
+        if (facePositionId != -1)
+        {
+            faceRectangles[static_cast<unsigned>(f)] = FaceRectangle(IStartOffset(f), IEndOffset(f), JStartOffset(f), JEndOffset(f), m_fp.m_rotationFace[facePositionId]);
+        }
+    }
+    return faceRectangles;
+}
+
+LayoutCubeMapBased::Faces LayoutCubeMap::From2dToFaceByOffsets(unsigned int i, unsigned int j) const
 {
-    for(const auto& f: get_range<Faces>())
+    for (auto f: ClassificationOrder())
     {
-        if (f != Faces::Last && f != Faces::Black && InFace(i,j,f))
+        if (inInterval(i, IStartOffset(f), IEndOffset(f)) && inInterval(j, JStartOffset(f), JEndOffset(f)))
         {
             return f;
         }
@@ -106,6 +120,11 @@ LayoutCubeMapBased::Faces LayoutCubeMap::From2dToFace(unsigned int i, unsigned i
     return Faces::Black;
 }
 
+LayoutCubeMapBased::Faces LayoutCubeMap::From2dToFace(unsigned int i, unsigned int j) const
+{
+    return From2dToFaceFromTable(i, j);
+}
+
 Layout::NormalizedFaceInfo LayoutCubeMap::From2dToNormalizedFaceInfo(const CoordI& pixel) const
 {
     auto f = From2dToFace(pixel.x, pixel.y);
@@ -113,11 +132,12 @@ Layout::NormalizedFaceInfo LayoutCubeMap::From2dToNormalizedFaceInfo(const Coord
     {
         return Layout::NormalizedFaceInfo(CoordF(0,0), static_cast<int>(f));
     }
-    double u = double(pixel.x - IStartOffset(f))/GetResH(f);
-    double v = double(pixel.y - JStartOffset(f))/GetResV(f);
+    const auto& rect = GetFaceRectangle(f);
+    double u = double(pixel.x - rect.m_iStart)/GetResH(f);
+    double v = double(pixel.y - rect.m_jStart)/GetResV(f);
     double i(-1);
     double j(-1);
-    std::tie(i,j) = m_fp.GetIJ2dToNorm(u, v, f);
+    std::tie(i,j) = FacePosition::GetIJ2dToNorm(u, v, rect.m_rotation);
     return Layout::NormalizedFaceInfo(CoordF(i,j), static_cast<int>(f));
 }
 
@@ -130,10 +150,15 @@ CoordF LayoutCubeMap::FromNormalizedInfoTo2d(const Layout::NormalizedFaceInfo& n
     const CoordF& coord (ni.m_normalizedFaceCoordinate);
     if (f != Faces::Last && f != Faces::Black)
     {
+        const auto& rect = GetFaceRectangle(f);
+        if (!rect.m_inLayout)
+        {
+            throw std::invalid_argument("FromNormalizedInfoTo2d: the face "+std::to_string(ni.m_faceId)+" is not in the layout");
+        }
         double i(-1);
         double j(-1);
-        std::tie(i,j) = m_fp.GetIJNormTo2d(coord.x, coord.y, f);
-        return CoordF(BORDERH(GetResH(f)*i)+IStartOffset(f), BORDERV(GetResV(f)*j)+JStartOffset(f));
+        std::tie(i,j) = FacePosition::GetIJNormTo2d(coord.x, coord.y, rect.m_rotation, f);
+        return CoordF(BORDERH(GetResH(f)*i)+rect.m_iStart, BORDERV(GetResV(f)*j)+rect.m_jStart);
     }
     else
     {
@@ -155,7 +180,7 @@ std::shared_ptr<Picture> LayoutCubeMap::ReadNextPictureFromVideoImpl(void)
           auto facePictPtr = m_inputVideoPtr->GetNextPicture(i);
           if (!isInit)
           {
-              outputMat = cv::Mat( m_outHeight, m_outWidth, facePictPtr->type());
+              outputMat = PicturePool::GetDefault()->GetMat(m_outHeight, m_outWidth, facePictPtr->type());
               isInit = true;
           }
           cv::Mat facePictMat ( outputMat, roi);
@@ -166,9 +191,9 @@ std::shared_ptr<Picture> LayoutCubeMap::ReadNextPictureFromVideoImpl(void)
     {
       auto facePictPtr = m_inputVideoPtr->GetNextPicture(0);
       //outputMat = cv::Mat( m_outHeight, m_outWidth, facePictPtr->type());
-      facePictPtr->copyTo(outputMat);
+      outputMat = *facePictPtr; //the decoded picture is not shared: no need to copy it
     }
-    return std::make_shared<Picture>(outputMat);
+    return PicturePool::GetDefault()->Adopt(outputMat);
 }
 
 void LayoutCubeMap::WritePictureToVideoImpl(std::shared_ptr<Picture> pict)
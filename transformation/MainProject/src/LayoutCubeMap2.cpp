@@ -20,7 +20,7 @@ unsigned int LayoutCubeMap2::IStartOffset(LayoutCubeMapBased::Faces f) const
         return GetResH(Faces::Left)+m_maxOffsetTFB+GetResH(Faces::Right);
     case Faces::Black:
     case Faces::Last:
-        std::invalid_argument("IStartOffset: Last is not a valid face");
+        throw std::invalid_argument("IStartOffset: Last is not a valid face");
     }
 }
 
@@ -42,7 +42,7 @@ unsigned int LayoutCubeMap2::IEndOffset(LayoutCubeMapBased::Faces f) const
         return GetResH(Faces::Left)+m_maxOffsetTFB+GetResH(Faces::Right)+GetResH(Faces::Back);
     case Faces::Black:
     case Faces::Last:
-        std::invalid_argument("IEndOffset: Last is not a valid face");
+        throw std::invalid_argument("IEndOffset: Last is not a valid face");
     }
 }
 
@@ -64,7 +64,7 @@ unsigned int LayoutCubeMap2::JStartOffset(LayoutCubeMapBased::Faces f) const
         return GetResV(Faces::Top)+(m_maxOffsetLFRB-GetResV(Faces::Back))/2;
     case Faces::Black:
     case Faces::Last:
-        std::invalid_argument("JStartOffset: Last is not a valid face");
+        throw std::invalid_argument("JStartOffset: Last is not a valid face");
     }
 }
 
@@ -86,40 +86,35 @@ unsigned int LayoutCubeMap2::JEndOffset(LayoutCubeMapBased::Faces f) const
         return GetResV(Faces::Top)+GetResV(Faces::Back)+(m_maxOffsetLFRB-GetResV(Faces::Back))/2;
     case Faces::Black:
     case Faces::Last:
-        std::invalid_argument("JEndOffset: Last is not a valid face");
+        throw std::invalid_argument("JEndOffset: Last is not a valid face");
     }
 }
+
+std::array<LayoutCubeMapBased::FaceRectangle,6> LayoutCubeMap2::ComputeFaceRectangles(void) const
+{
+    std::array<FaceRectangle,6> faceRectangles;
+    for (auto f: ClassificationOrder())
+    {
+        faceRectangles[static_cast<unsigned>(f)] = FaceRectangle(IStartOffset(f), IEndOffset(f), JStartOffset(f), JEndOffset(f));
+    }
+    return faceRectangles;
+}
 
+LayoutCubeMapBased::Faces LayoutCubeMap2::From2dToFaceByOffsets(unsigned int i, unsigned int j) const
+{
+    for (auto f: ClassificationOrder())
+    {
+        if (inInterval(i, IStartOffset(f), IEndOffset(f)) && inInterval(j, JStartOffset(f), JEndOffset(f)))
+        {
+            return f;
+        }
+    }
+    return Faces::Black;
+}
+
 LayoutCubeMapBased::Faces LayoutCubeMap2::From2dToFace(unsigned int i, unsigned int j) const
 {
-	if ( InFace(i,j,Faces::Left))
-    {
-        return Faces::Left;
-    }
-    else if (InFace(i,j,Faces::Top))
-    {
-        return Faces::Top;
-    }
-    else if (InFace(i,j,Faces::Front))
-    {
-        return Faces::Front;
-    }
-    else if (InFace(i,j,Faces::Bottom))
-    {
-        return Faces::Bottom;
-    }
-    else if (InFace(i,j,Faces::Right))
-    {
-        return Faces::Right;
-    }
-    else if (InFace(i,j,Faces::Back))
-    {
-        return Faces::Back;
-    }
-    else
-    {
-        return Faces::Black;
-    }
+    return From2dToFaceFromTable(i, j);
 }
 
 #define BORDERH(x) (MAX(1.0, MIN(GetResH(f)-1,x)))
@@ -131,11 +126,12 @@ CoordF LayoutCubeMap2::FromNormalizedInfoTo2d(const Layout::NormalizedFaceInfo&
     const CoordF& coord(ni.m_normalizedFaceCoordinate);
     if (f != Faces::Black && f != Faces::Last)
     {
-        return CoordF(BORDERH(GetResH(f)*coord.x)+IStartOffset(f), BORDERV(GetResV(f)*coord.y)+JStartOffset(f));
+        const auto& rect = GetFaceRectangle(f);
+        return CoordF(BORDERH(GetResH(f)*coord.x)+rect.m_iStart, BORDERV(GetResV(f)*coord.y)+rect.m_jStart);
     }
     else
     {
-        std::invalid_argument("FromNormalizedInfoTo2d: Last or Black are not a valid face");
+        throw std::invalid_argument("FromNormalizedInfoTo2d: Last or Black are not a valid face");
     }
 }
 
@@ -146,8 +142,9 @@ Layout::NormalizedFaceInfo LayoutCubeMap2::From2dToNormalizedFaceInfo(const Coor
     {
         return NormalizedFaceInfo(CoordF(0, 0), static_cast<int>(f));
     }
-    double normalizedI = double(pixel.x-IStartOffset(f))/GetResH(f);
-    double normalizedJ = double(pixel.y-JStartOffset(f))/GetResV(f);
+    const auto& rect = GetFaceRectangle(f);
+    double normalizedI = double(pixel.x-rect.m_iStart)/GetResH(f);
+    double normalizedJ = double(pixel.y-rect.m_jStart)/GetResV(f);
     return NormalizedFaceInfo(CoordF(normalizedI, normalizedJ), static_cast<int>(f));
 }
 
@@ -165,7 +162,7 @@ std::shared_ptr<Picture> LayoutCubeMap2::ReadNextPictureFromVideoImpl(void)
           //std::cout << "Expected Width: "<< GetRes(f) << "; Height " << GetRes(f)  << "; received width "<< facePictPtr->cols << " height "<< facePictPtr->rows << std::endl;
           if (!isInit)
           {
-              outputMat = cv::Mat( m_outHeight, m_outWidth, facePictPtr->type());
+              outputMat = PicturePool::GetDefault()->GetMat(m_outHeight, m_outWidth, facePictPtr->type());
               isInit = true;
           }
           cv::Mat facePictMat ( outputMat, roi);
@@ -176,9 +173,9 @@ std::shared_ptr<Picture> LayoutCubeMap2::ReadNextPictureFromVideoImpl(void)
     {
       auto facePictPtr = m_inputVideoPtr->GetNextPicture(0);
       //outputMat = cv::Mat( m_outHeight, m_outWidth, facePictPtr->type());
-      facePictPtr->copyTo(outputMat);
+      outputMat = *facePictPtr; //the decoded picture is not shared: no need to copy it
     }
-    return std::make_shared<Picture>(outputMat);
+    return PicturePool::GetDefault()->Adopt(outputMat);
 }
 
 void LayoutCubeMap2::WritePictureToVideoImpl(std::shared_ptr<Picture> pict)
@@ -2,6 +2,11 @@
 
 using namespace IMT;
 
+constexpr unsigned long LayoutCubeMapBased::m_maxFaceRasterSize;
+constexpr SCALAR LayoutCubeMapBased::m_facePlans[7][4];
+constexpr RotMat LayoutCubeMapBased::m_faceRotations[6];
+constexpr RotMatF32 LayoutCubeMapBased::m_faceRotationsF32[6];
+
 Coord3dCart LayoutCubeMapBased::FromNormalizedInfoTo3d(const Layout::NormalizedFaceInfo& ni) const
 {
     Faces f = static_cast<Faces>(ni.m_faceId);
@@ -10,43 +15,35 @@ Coord3dCart LayoutCubeMapBased::FromNormalizedInfoTo3d(const Layout::NormalizedF
     double j = (ni.m_normalizedFaceCoordinate.y - 0.5)*2.f;
     if (m_equalArea)
     {
-        i = tan( (PI()/2.0)*(ni.m_normalizedFaceCoordinate.x - 0.5));
-        j = tan( (PI()/2.0)*(ni.m_normalizedFaceCoordinate.y - 0.5));
+        i = Tan( (PI()/2.0)*(ni.m_normalizedFaceCoordinate.x - 0.5), m_mathMode);
+        j = Tan( (PI()/2.0)*(ni.m_normalizedFaceCoordinate.y - 0.5), m_mathMode);
     }
     Coord3dCart point(1, i, -j);
     // return Rotation(point, m_rotQuaternion*FaceToRotQuaternion(f));
-    Coord3dCart v = Rotation(point, FaceToRotQuaternion(f));
+    Coord3dCart v = FaceToRotMat(f)*point;
     v = v/v.Norm();
     // if (f == Faces::Front && i < 0.9 && j == 0)
     // {
-    //   std::cout << "V = " << v/v.Norm() << " p = " << Coord3dCart(Rotation(point, FaceToRotQuaternion(f)))/Rotation(point, FaceToRotQuaternion(f)).Norm() << std::endl;
+    //   std::cout << "V = " << v/v.Norm() << " p = " << Coord3dCart(FaceToRotMat(f)*point)/(FaceToRotMat(f)*point).Norm() << std::endl;
     // }
-    return Rotation(v, m_rotQuaternion);
+    return Rotation(v, m_rotMat);
 }
 
 
-Layout::NormalizedFaceInfo LayoutCubeMapBased::From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const
+Layout::NormalizedFaceInfo LayoutCubeMapBased::From3dToNormalizedFaceInfo(const Coord3dCart& coord) const
 {
-    //First we find the face with which we intersect
-    Coord3dSpherical p = Coord3dCart(Rotation(sphericalCoord, m_rotQuaternion.Inv()));
-    p = Coord3dCart(p)/p.Norm();
-
-
-    // if (Coord3dCart(p).GetX() > 0.99999)
-    // std::cout << "V = " << Coord3dCart(sphericalCoord) << " P = " << Coord3dCart(p) << std::endl;
-
-    FaceToPlanFct<Faces> lambda = [this] (Faces f) {return this->FromFaceToPlan(f);};
-    auto rtr = IntersectionCart(lambda, Coord3dCart(p)/p.Norm());
+    //First we find the face with which we intersect (the intersection with the cube does not depend on the norm of the direction)
+    auto rtr = IntersectionCube(Rotation(coord, m_invRotMat));
     Coord3dCart inter = std::get<0>(rtr);
     Faces f = std::get<1>(rtr);
 
-    Coord3dCart canonicPoint ( Rotation(inter, FaceToRotQuaternion(f).Inv()) );
+    Coord3dCart canonicPoint ( FaceToRotMat(f).Transpose()*inter );
     double u(-1), v(-1);
     if (m_equalArea)
     {
-        u = (2.0*atan(canonicPoint.GetY())/PI()) + 0.5;
+        u = (2.0*Atan(canonicPoint.GetY(), m_mathMode)/PI()) + 0.5;
         //canonicPoint.SetX(2.0*2.0*atan(canonicPoint.GetX())/PI());
-        v = (2.0*atan(canonicPoint.GetZ())/PI()) + 0.5;
+        v = (2.0*Atan(canonicPoint.GetZ(), m_mathMode)/PI()) + 0.5;
         //canonicPoint.SetY(2.0*2.0*atan(canonicPoint.GetY())/PI());
     }
     else
@@ -59,72 +56,95 @@ Layout::NormalizedFaceInfo LayoutCubeMapBased::From3dToNormalizedFaceInfo(const
     return ni;
 }
 
-void LayoutCubeMapBased::InitFaceRotations(void)
+Coord3dCartF32 LayoutCubeMapBased::FromNormalizedInfoTo3dF32(const Layout::NormalizedFaceInfo& ni) const
+{
+    Faces f = static_cast<Faces>(ni.m_faceId);
+    if (f == Faces::Black) {return Coord3dCartF32(0,0,0);}
+    float i = (float(ni.m_normalizedFaceCoordinate.x) - 0.5f)*2.f;
+    float j = (float(ni.m_normalizedFaceCoordinate.y) - 0.5f)*2.f;
+    if (m_equalArea)
+    {
+        i = Tan( float(PI()/2.0)*(float(ni.m_normalizedFaceCoordinate.x) - 0.5f), m_mathMode);
+        j = Tan( float(PI()/2.0)*(float(ni.m_normalizedFaceCoordinate.y) - 0.5f), m_mathMode);
+    }
+    Coord3dCartF32 v = FaceToRotMatF32(f)*Coord3dCartF32(1, i, -j);
+    v = v/v.Norm();
+    return Rotation(v, m_rotMatF32);
+}
+
+Layout::NormalizedFaceInfo LayoutCubeMapBased::From3dToNormalizedFaceInfoF32(const Coord3dCartF32& coord) const
 {
-    for (auto f: get_range<LayoutCubeMapBased::Faces>())
+    auto rtr = IntersectionCube(Rotation(coord, m_invRotMatF32));
+    Faces f = std::get<1>(rtr);
+
+    Coord3dCartF32 canonicPoint ( FaceToRotMatF32(f).Transpose()*std::get<0>(rtr) );
+    float u(-1), v(-1);
+    if (m_equalArea)
+    {
+        u = (2.f*Atan(canonicPoint.GetY(), m_mathMode)/float(PI())) + 0.5f;
+        v = (2.f*Atan(canonicPoint.GetZ(), m_mathMode)/float(PI())) + 0.5f;
+    }
+    else
     {
-        switch (f)
+        u = (canonicPoint.GetY()+1.f)/2.f;
+        v = (canonicPoint.GetZ()+1.f)/2.f;
+    }
+    return Layout::NormalizedFaceInfo(CoordF(u, 1-v), static_cast<int>(f));
+}
+
+template<class T>
+std::tuple<VectorCartesianT<T>, LayoutCubeMapBased::Faces> LayoutCubeMapBased::IntersectionCube(const VectorCartesianT<T>& direction)
+{
+    //The cube faces are the plans x=+-1, y=+-1 and z=+-1: the closest one is given by the largest absolute coordinate.
+    //On a tie the first face in the Faces order wins, as with the plan by plan intersection.
+    const T ax = std::abs(direction.GetX());
+    const T ay = std::abs(direction.GetY());
+    const T az = std::abs(direction.GetZ());
+    if (ax >= ay && ax >= az)
+    {
+        return std::make_tuple(direction/ax, direction.GetX() > 0 ? Faces::Front : Faces::Back);
+    }
+    if (ay >= az)
+    {
+        return std::make_tuple(direction/ay, direction.GetY() > 0 ? Faces::Right : Faces::Left);
+    }
+    return std::make_tuple(direction/az, direction.GetZ() > 0 ? Faces::Top : Faces::Bottom);
+}
+
+void LayoutCubeMapBased::InitFaceTable(std::array<FaceRectangle,6> faceRectangles, const std::array<Faces,6>& classificationOrder)
+{
+    m_faceRectangles = std::move(faceRectangles);
+    m_classificationOrder = classificationOrder;
+    m_faceRaster.clear();
+    m_faceRasterWidth = 0;
+    m_faceRasterHeight = 0;
+    if (static_cast<unsigned long>(GetWidth())*GetHeight() > m_maxFaceRasterSize)
+    {
+        return;
+    }
+    m_faceRaster.resize(static_cast<unsigned long>(GetWidth())*GetHeight());
+    TaskPool::GetDefault().ParallelFor(0, GetHeight(), TaskPool::GetGrain(GetWidth()), [&](size_t firstRow, size_t lastRow)
+    {
+        for (unsigned int j = firstRow; j < lastRow; ++j)
         {
-            case Faces::Front:
-                m_faceRotations[static_cast<unsigned>(f)] =
-                    // RotMat(1, 0, 0,
-                    //        0, 1, 0,
-                    //        0, 0, -1
-                    //        );
-                    Quaternion(1);
-                break;
-            case Faces::Back:
-                m_faceRotations[static_cast<unsigned>(f)] =
-                    // RotMat(-1, 0, 0,
-                    //        0, -1, 0,
-                    //        0, 0, -1
-                    //        );
-                    Quaternion(0, VectorCartesian(0, 0, 1));
-                break;
-            case Faces::Left:
-                m_faceRotations[static_cast<unsigned>(f)] =
-                    // RotMat(0, 1, 0,
-                    //        -1, 0, 0,
-                    //        0, 0, -1
-                    //        );
-                    Quaternion(std::cos(-PI()/4), std::sin(-PI()/4)*VectorCartesian(0, 0, 1));
-                break;
-            case Faces::Right:
-                m_faceRotations[static_cast<unsigned>(f)] =
-                    // RotMat(0, -1, 0,
-                    //        1, 0, 0,
-                    //        0, 0, -1
-                    //        );
-                    Quaternion(std::cos(PI()/4), std::sin(PI()/4)*VectorCartesian(0, 0, 1));
-                break;
-            case Faces::Top:
-                m_faceRotations[static_cast<unsigned>(f)] =
-                    // RotMat(0, 0, 1,
-                    //        0, 1, 0,
-                    //        1, 0, 0
-                    //        );
-                    Quaternion(std::cos(-PI()/4), std::sin(-PI()/4)*VectorCartesian(0, 1, 0));
-                break;
-            case Faces::Bottom:
-                m_faceRotations[static_cast<unsigned>(f)] =
-                    // RotMat(0, 0, -1,
-                    //        0, 1, 0,
-                    //        -1, 0, 0
-                    //        );
-                    Quaternion(std::cos(PI()/4), std::sin(PI()/4)*VectorCartesian(0, 1, 0));
-                break;
-            case Faces::Last:
-            case Faces::Black:
-                continue;
+            for (unsigned int i = 0; i < GetWidth(); ++i)
+            {
+                m_faceRaster[j*GetWidth()+i] = static_cast<signed char>(ClassifyPixel(i, j));
+            }
         }
-    }
+    });
+    m_faceRasterWidth = GetWidth();
+    m_faceRasterHeight = GetHeight();
 }
 
-const Quaternion& LayoutCubeMapBased::FaceToRotQuaternion(Faces f) const
+LayoutCubeMapBased::Faces LayoutCubeMapBased::ClassifyPixel(unsigned int i, unsigned int j) const
 {
-    if (f == Faces::Last || f == Faces::Black)
+    for (auto f: m_classificationOrder)
     {
-        throw std::invalid_argument("FaceToRotQuaternion: Last is not a valid face");
+        if (m_faceRectangles[static_cast<unsigned>(f)].Contains(i, j))
+        {
+            return f;
+        }
     }
-    return m_faceRotations[static_cast<unsigned>(f)];
+    return Faces::Black;
 }
@@ -0,0 +1,47 @@
+#include "LayoutEquirectangular.hpp"
+
+using namespace IMT;
+
+constexpr size_t LayoutEquirectangular::m_batchSize;
+
+void LayoutEquirectangular::FromSphereTo2dBatch(const VectorBatch& coords, size_t start, size_t count, CoordF* out) const
+{
+    VectorBatch rotCoords(m_batchSize);
+    double horizontalNorm[m_batchSize];
+    double theta[m_batchSize];
+    double phi[m_batchSize];
+    for (size_t first = 0; first < count; first += m_batchSize)
+    {
+        const size_t n = std::min(m_batchSize, count-first);
+        rotCoords.Resize(n);
+        for (size_t k = 0; k < n; ++k)
+        {
+            rotCoords.Set(k, m_vectorialTrans->FromAfterTrans3dToBeforeTrans3d(coords.Get(start+first+k)));
+        }
+        Rotation(rotCoords, m_invRotMat);
+        const double* x = rotCoords.X();
+        const double* y = rotCoords.Y();
+        const double* z = rotCoords.Z();
+        for (size_t k = 0; k < n; ++k)
+        {
+            horizontalNorm[k] = std::sqrt(x[k]*x[k]+y[k]*y[k]);
+        }
+        if (m_mathMode == MathMode::Fast)
+        {
+            FastMath::Atan2(y, x, theta, n);
+            FastMath::Atan2(horizontalNorm, z, phi, n);
+        }
+        else
+        {
+            for (size_t k = 0; k < n; ++k)
+            {
+                theta[k] = std::atan2(y[k], x[k]);
+                phi[k] = std::atan2(horizontalNorm[k], z[k]);
+            }
+        }
+        for (size_t k = 0; k < n; ++k)
+        {
+            out[first+k] = CoordF((0.5+theta[k]/(2.0*PI()))*GetWidth(), phi[k]/PI()*GetHeight());
+        }
+    }
+}
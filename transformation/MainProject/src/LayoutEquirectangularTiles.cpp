@@ -0,0 +1,380 @@
+#include "LayoutEquirectangularTiles.hpp"
+
+#include <algorithm>
+
+using namespace IMT;
+
+constexpr unsigned int LayoutEquirectangularTiles::m_nbAngleBins;
+
+LayoutEquirectangularTiles::LayoutEquirectangularTiles(unsigned int nbHTiles, unsigned int nbVTiles, ScaleTilesMap scaleTile, TileRatios tileRatios, Quaternion rotationQuaternion, std::tuple<unsigned int, unsigned int> originalRes, bool useTile, bool upscale, std::shared_ptr<VectorialTrans> vectorialTrans):
+  Layout(vectorialTrans), m_nbHTiles(nbHTiles), m_nbVTiles(nbVTiles),
+  m_scaleTile(nbHTiles*nbVTiles), m_tileWidths(nbHTiles*nbVTiles), m_tileHeights(nbHTiles*nbVTiles), m_offsets(nbHTiles*nbVTiles), m_endOffsets(nbHTiles*nbVTiles),
+  m_hTileRatios(std::move(std::get<0>(tileRatios))), m_vTileRatios(std::move(std::get<1>(tileRatios))), m_colsMaxSize(nbHTiles), m_rowsMaxSize(nbVTiles),
+  m_colsStart(), m_rowsStart(), m_colIndex(), m_rowIndex(), m_hRatioStart(), m_hRatioEnd(), m_vRatioStart(), m_vRatioEnd(),
+  m_thetaStart(), m_phiStart(), m_hTileOfAngle(), m_vTileOfAngle(),
+  m_rotationQuaternion(rotationQuaternion), m_rotMat(RotMat::FromQuaternion(rotationQuaternion)), m_invRotMat(m_rotMat.Transpose()),
+  m_originalRes(std::move(originalRes)), m_useTile(useTile), m_upscale(upscale)
+{
+    if (nbHTiles == 0 || nbVTiles == 0)
+    {
+        throw std::invalid_argument("EquirectangularTiles: the number of horizontal and vertical tiles should be positive");
+    }
+    if (scaleTile.size() != nbHTiles || m_hTileRatios.size() != nbHTiles || m_vTileRatios.size() != nbVTiles)
+    {
+        throw std::invalid_argument("EquirectangularTiles: the tile scales and ratios do not match the "+std::to_string(nbHTiles)+"x"+std::to_string(nbVTiles)+" grid");
+    }
+    for (unsigned int i = 0; i < nbHTiles; ++i)
+    {
+        if (scaleTile[i].size() != nbVTiles)
+        {
+            throw std::invalid_argument("EquirectangularTiles: the tile scales do not match the "+std::to_string(nbHTiles)+"x"+std::to_string(nbVTiles)+" grid");
+        }
+        std::copy(scaleTile[i].begin(), scaleTile[i].end(), m_scaleTile.begin()+i*nbVTiles);
+    }
+}
+
+CoordI LayoutEquirectangularTiles::GetReferenceResolution(void)
+{
+    unsigned maxI(0), maxJ(0);
+    for (unsigned i = 0; i < m_nbHTiles; ++i)
+    {
+        for (unsigned j = 0; j < m_nbVTiles; ++j)
+        {
+            maxI = MAX(maxI, m_tileWidths[i*m_nbVTiles+j]/(GetHTileRatio(i)*m_nbHTiles));
+            maxJ = MAX(maxJ, m_tileHeights[i*m_nbVTiles+j]/(GetVTileRatio(j)*m_nbVTiles));
+        }
+    }
+    PRINT_DEBUG( m_nbHTiles*maxI << " " << m_nbVTiles*maxJ << std::endl )
+    return CoordI(m_nbHTiles*maxI, m_nbVTiles*maxJ);
+}
+
+CoordI LayoutEquirectangularTiles::GetReferenceResolution(unsigned width, unsigned heigth, const ScaleTilesMap& scaleTm)
+{
+    unsigned int nbHTiles = scaleTm.size();
+    unsigned int nbVTiles = nbHTiles > 0 ? scaleTm[0].size() : 0;
+    double sumRationCols = 0;
+    double sumRationRows = 0;
+    for (unsigned int i = 0; i < nbHTiles; ++i)
+    {
+        double maxCols(0);
+        for (unsigned int j = 0; j < nbVTiles; ++j)
+        {
+            maxCols = std::max(maxCols, scaleTm[i][j]);
+        }
+        sumRationCols += maxCols;
+    }
+    for (unsigned int j = 0; j < nbVTiles; ++j)
+    {
+        double maxRows(0);
+        for (unsigned int i = 0; i < nbHTiles; ++i)
+        {
+            maxRows = std::max(maxRows, scaleTm[i][j]);
+        }
+        sumRationRows += maxRows;
+    }
+    PRINT_DEBUG( nbHTiles*width/sumRationCols << "; " << nbVTiles*heigth/sumRationRows << std::endl)
+    PRINT_DEBUG( width << "; " << heigth << std::endl)
+    PRINT_DEBUG( sumRationCols << "; " << sumRationRows << std::endl)
+    return CoordI(nbHTiles*width/sumRationCols, nbVTiles*heigth/sumRationRows);
+}
+
+Layout::NormalizedFaceInfo LayoutEquirectangularTiles::From2dToNormalizedFaceInfo(const CoordI& pixel) const
+{
+    unsigned int i,j;
+    if (!From2dToTileId(pixel.x, pixel.y, i, j))
+    {
+        return NormalizedFaceInfo(CoordF(0,0), -1);
+    }
+    auto tileIndex = i*m_nbVTiles+j;
+    auto normPixel = pixel-m_offsets[tileIndex];
+    //upscaling: spacial quantification
+    if (m_upscale)
+    {
+       normPixel.x = unsigned(normPixel.x * m_scaleTile[tileIndex])/m_scaleTile[tileIndex];
+       normPixel.y = unsigned(normPixel.y * m_scaleTile[tileIndex])/m_scaleTile[tileIndex];
+    }
+    return NormalizedFaceInfo(CoordF(double(normPixel.x)/m_tileWidths[tileIndex], double(normPixel.y)/m_tileHeights[tileIndex]), tileIndex);
+}
+
+CoordF LayoutEquirectangularTiles::FromNormalizedInfoTo2d(const NormalizedFaceInfo& ni) const
+{
+    if (ni.m_faceId < 0 || unsigned(ni.m_faceId) >= m_nbHTiles*m_nbVTiles)
+    {
+        throw std::invalid_argument("FromNormalizedInfoTo2d: invalide tile id "+std::to_string(ni.m_faceId));
+    }
+    const auto& offset = m_offsets[ni.m_faceId];
+    return CoordF(ni.m_normalizedFaceCoordinate.x*m_tileWidths[ni.m_faceId]+offset.x, ni.m_normalizedFaceCoordinate.y * m_tileHeights[ni.m_faceId]+offset.y);
+}
+
+Layout::NormalizedFaceInfo LayoutEquirectangularTiles::From3dToNormalizedFaceInfo(const Coord3dCart& coord) const
+{
+    Coord3dCart rotCoord = Rotation(coord, m_invRotMat);
+    double i = 0.5+rotCoord.GetTheta(m_mathMode)/ (2.0*PI());
+    double j = rotCoord.GetPhi(m_mathMode) / PI();
+    //Find tile id: the angle tables give the first candidate column (resp. row), the next one is needed only near a tile border
+    unsigned int ni(0), nj(0);
+    double normalizedCoordI(0.0), normalizedCoordJ(0.0);
+    unsigned ii = m_hTileOfAngle[AngleBin(i)];
+    while (ii < m_nbHTiles && m_hRatioEnd[ii] <= i)
+    {
+      ++ii;
+    }
+    if (ii < m_nbHTiles)
+    {
+      ni = ii;
+      normalizedCoordI = (i-m_hRatioStart[ii])/GetHTileRatio(ii);
+    }
+    unsigned jj = m_vTileOfAngle[AngleBin(j)];
+    while (jj < m_nbVTiles && m_vRatioEnd[jj] < j)
+    {
+      ++jj;
+    }
+    if (jj < m_nbVTiles)
+    {
+      nj = jj;
+      normalizedCoordJ = (j-m_vRatioStart[jj])/GetVTileRatio(jj);
+    }
+    return NormalizedFaceInfo(CoordF(normalizedCoordI, normalizedCoordJ), ni*m_nbVTiles+nj);
+}
+
+Coord3dCart LayoutEquirectangularTiles::FromNormalizedInfoTo3d(const NormalizedFaceInfo& ni) const
+{
+    if (ni.m_faceId == -1) {return Coord3dCart(0,0,0);}
+    auto ti = ToTileId(ni.m_faceId);
+    double theta = m_thetaStart[std::get<0>(ti)] + 2.0*PI()*ni.m_normalizedFaceCoordinate.x*GetHTileRatio(std::get<0>(ti));
+    double phi = m_phiStart[std::get<1>(ti)] + PI()*ni.m_normalizedFaceCoordinate.y*GetVTileRatio(std::get<1>(ti));
+    Coord3dCart v = Coord3dCart::FromSpherical(theta, phi, m_mathMode);
+    return Rotation(v, m_rotMat);
+}
+
+std::shared_ptr<Picture> LayoutEquirectangularTiles::ReadNextPictureFromVideoImpl(void)
+{
+    bool isInit = false;
+    cv::Mat outputMat;
+    if (m_useTile)
+    {
+      for (unsigned t = 0; t < m_nbHTiles*m_nbVTiles; ++t)
+      {
+          const auto& offset = m_offsets[t];
+          cv::Rect roi( offset.x,  offset.y, m_tileWidths[t], m_tileHeights[t] );
+          auto facePictPtr = m_inputVideoPtr->GetNextPicture(t);
+          if (!isInit)
+          {
+              outputMat = PicturePool::GetDefault()->GetMat(GetHeight(), GetWidth(), facePictPtr->type());
+              isInit = true;
+          }
+          cv::Mat facePictMat ( outputMat, roi);
+          facePictPtr->copyTo(facePictMat);
+      }
+    }
+    else
+    {
+      auto facePictPtr = m_inputVideoPtr->GetNextPicture(0);
+      outputMat = *facePictPtr; //the decoded picture is not shared: no need to copy it
+    }
+    return PicturePool::GetDefault()->Adopt(outputMat);
+}
+
+void LayoutEquirectangularTiles::WritePictureToVideoImpl(std::shared_ptr<Picture> pict)
+{
+    if (m_useTile)
+    {
+      for (unsigned t = 0; t < m_nbHTiles*m_nbVTiles; ++t)
+      {
+          const auto& offset = m_offsets[t];
+          cv::Rect roi( offset.x,  offset.y, m_tileWidths[t], m_tileHeights[t] );
+          cv::Mat facePictMat ( pict->GetMat(), roi);
+          m_outputVideoPtr->Write( facePictMat, t);
+      }
+    }
+    else
+    {
+      m_outputVideoPtr->Write(pict->GetMat(), 0);
+    }
+}
+
+std::shared_ptr<IMT::LibAv::VideoReader> LayoutEquirectangularTiles::InitInputVideoImpl(std::string pathToInputVideo, unsigned nbFrame)
+{
+    std::shared_ptr<IMT::LibAv::VideoReader> vrPtr = std::make_shared<IMT::LibAv::VideoReader>(pathToInputVideo);
+    vrPtr->Init(nbFrame);
+    if ((m_useTile && vrPtr->GetNbStream() != m_nbHTiles*m_nbVTiles) || (vrPtr->GetNbStream() != 1))
+    {
+        std::cout << "Unsupported number of stream for EquirectangularTiles input video: "<<vrPtr->GetNbStream() <<" instead of "<< m_nbHTiles*m_nbVTiles << std::endl;
+        return nullptr;
+    }
+    //we could add some other check for instance on the width, height of each stream
+    return vrPtr;
+}
+
+std::shared_ptr<IMT::LibAv::VideoWriter> LayoutEquirectangularTiles::InitOutputVideoImpl(std::string pathToOutputVideo, std::string codecId, unsigned fps, unsigned gop_size, std::vector<int> bit_rateVect)
+{
+    std::shared_ptr<IMT::LibAv::VideoWriter> vwPtr = std::make_shared<IMT::LibAv::VideoWriter>(pathToOutputVideo);
+    if (m_useTile)
+    {
+      std::vector<int> br(bit_rateVect.begin(), bit_rateVect.begin()+m_nbHTiles*m_nbVTiles);
+      vwPtr->Init(codecId, m_tileWidths, m_tileHeights, fps, gop_size, br);
+    }
+    else
+    {
+      std::vector<int> br(bit_rateVect.begin(), bit_rateVect.begin()+1);
+      vwPtr->Init(codecId, std::vector<unsigned>(1, GetWidth()), std::vector<unsigned>(1, GetHeight()), fps, gop_size, br);
+    }
+    return vwPtr;
+}
+
+void LayoutEquirectangularTiles::InitImpl(void)
+{
+    //Update tile resolutions
+    for(unsigned int i = 0; i < m_nbHTiles; ++i)
+    {
+      for (unsigned int j = 0; j < m_nbVTiles; ++j)
+      {
+          auto t = i*m_nbVTiles+j;
+          auto scale = m_upscale ? 1.0 : m_scaleTile[t];
+          m_tileWidths[t] = GetHTileRatio(i)*std::get<0>(m_originalRes)*scale;
+          m_tileHeights[t] = GetVTileRatio(j)*std::get<1>(m_originalRes)*scale;
+      }
+    }
+    //Compute columns and rows size in pixels
+    unsigned int sumWidth(0), sumHeight(0);
+
+    for (unsigned int i = 0; i < m_nbHTiles; ++i)
+    {
+        unsigned int maxCol = 0;
+        for(unsigned int j = 0; j < m_nbVTiles; ++j)
+        {
+            PRINT_DEBUG ("("<<i<<","<<j<<") ->"<< m_tileWidths[i*m_nbVTiles+j]<<" ")
+            maxCol = MAX(maxCol, m_tileWidths[i*m_nbVTiles+j]);
+        }
+        PRINT_DEBUG (" max = " << maxCol << std::endl)
+        sumWidth += maxCol;
+        m_colsMaxSize[i] = maxCol;
+    }
+    PRINT_DEBUG ("---- total = " << sumWidth << std::endl)
+
+    for (unsigned int j = 0; j < m_nbVTiles; ++j)
+    {
+        unsigned int maxRow = 0;
+        for(unsigned int i = 0; i < m_nbHTiles; ++i)
+        {
+            PRINT_DEBUG ("("<<i<<","<<j<<") ->"<< m_tileHeights[i*m_nbVTiles+j]<<" ")
+            maxRow = MAX(maxRow, m_tileHeights[i*m_nbVTiles+j]);
+        }
+        PRINT_DEBUG (" maxRow = " << maxRow << std::endl)
+        sumHeight += maxRow;
+        m_rowsMaxSize[j] = maxRow;
+    }
+    PRINT_DEBUG ("---- total = " << sumHeight << std::endl)
+    SetWidth(sumWidth);
+    SetHeight(sumHeight);
+    //Compute tiles starting offsets
+    unsigned int offCol(0);
+    for (unsigned i = 0; i < m_nbHTiles; ++i)
+    {
+        unsigned int offRow(0);
+        for (unsigned j = 0; j < m_nbVTiles; ++j)
+        {
+            auto t = i*m_nbVTiles+j;
+            unsigned int offI(offCol), offJ(offRow);
+            if (i != 0)
+            {
+                offI += (m_colsMaxSize[i]-m_tileWidths[t])/2;
+            }
+            if (j != 0)
+            {
+                offJ += (m_rowsMaxSize[j]-m_tileHeights[t])/2;
+            }
+            m_offsets[t] = CoordI(offI, offJ);
+            m_endOffsets[t] = CoordI(offI+m_tileWidths[t], offJ+m_tileHeights[t]);
+            offRow += m_rowsMaxSize[j];
+        }
+        offCol += m_colsMaxSize[i];
+    }
+    InitLookupTables(sumWidth, sumHeight);
+}
+
+void LayoutEquirectangularTiles::InitLookupTables(unsigned int sumWidth, unsigned int sumHeight)
+{
+    //Columns and rows starting offsets. The tile ends are inclusive: the last pixel of a column can also be in the next one
+    m_colsStart.assign(m_nbHTiles, 0);
+    m_rowsStart.assign(m_nbVTiles, 0);
+    unsigned int start(0);
+    for (unsigned int i = 0; i < m_nbHTiles; ++i)
+    {
+        m_colsStart[i] = start;
+        start += m_colsMaxSize[i];
+    }
+    start = 0;
+    for (unsigned int j = 0; j < m_nbVTiles; ++j)
+    {
+        m_rowsStart[j] = start;
+        start += m_rowsMaxSize[j];
+    }
+    m_colIndex.assign(sumWidth+1, 0);
+    for (unsigned int x = 0, k = 0; x <= sumWidth; ++x)
+    {
+        while (k+1 < m_nbHTiles && m_colsStart[k]+m_colsMaxSize[k] < x) {++k;}
+        m_colIndex[x] = k;
+    }
+    m_rowIndex.assign(sumHeight+1, 0);
+    for (unsigned int y = 0, l = 0; y <= sumHeight; ++y)
+    {
+        while (l+1 < m_nbVTiles && m_rowsStart[l]+m_rowsMaxSize[l] < y) {++l;}
+        m_rowIndex[y] = l;
+    }
+
+    //Prefix sums of the ratios (same summation order as a linear scan)
+    m_thetaStart.assign(m_nbHTiles, 0);
+    m_hRatioStart.assign(m_nbHTiles, 0);
+    m_hRatioEnd.assign(m_nbHTiles, 0);
+    m_phiStart.assign(m_nbVTiles, 0);
+    m_vRatioStart.assign(m_nbVTiles, 0);
+    m_vRatioEnd.assign(m_nbVTiles, 0);
+    double sum(0), theta(-PI()), phi(0);
+    for (unsigned int i = 0; i < m_nbHTiles; ++i)
+    {
+        m_thetaStart[i] = theta;
+        theta += 2.0*PI() * GetHTileRatio(i);
+        sum += GetHTileRatio(i);
+        m_hRatioEnd[i] = sum;
+        m_hRatioStart[i] = sum - GetHTileRatio(i);
+    }
+    sum = 0;
+    for (unsigned int j = 0; j < m_nbVTiles; ++j)
+    {
+        m_phiStart[j] = phi;
+        phi += PI() * GetVTileRatio(j);
+        sum += GetVTileRatio(j);
+        m_vRatioEnd[j] = sum;
+        m_vRatioStart[j] = sum - GetVTileRatio(j);
+    }
+    for (unsigned int b = 0; b < m_nbAngleBins; ++b)
+    {
+        double v = double(b)/m_nbAngleBins;
+        unsigned int ii(0), jj(0);
+        while (ii < m_nbHTiles && m_hRatioEnd[ii] <= v) {++ii;}
+        while (jj < m_nbVTiles && m_vRatioEnd[jj] < v) {++jj;}
+        m_hTileOfAngle[b] = ii;
+        m_vTileOfAngle[b] = jj;
+    }
+}
+
+bool LayoutEquirectangularTiles::From2dToTileId(unsigned int i, unsigned int j, unsigned int& k, unsigned int& l) const
+{
+    if (i >= m_colIndex.size() || j >= m_rowIndex.size())
+    {
+        return false;
+    }
+    for (k = m_colIndex[i]; k < m_nbHTiles && m_colsStart[k] <= i; ++k)
+    {
+        for (l = m_rowIndex[j]; l < m_nbVTiles && m_rowsStart[l] <= j; ++l)
+        {
+            auto t = k*m_nbVTiles+l;
+            if (Inside(i,j, m_offsets[t], m_endOffsets[t]))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -14,28 +14,26 @@ CoordF LayoutFlatFixed::FromNormalizedInfoTo2d(const Layout::NormalizedFaceInfo&
     const CoordF& coord(ni.m_normalizedFaceCoordinate);
     return CoordF(coord.x*m_outWidth, (coord.y)*m_outHeight);
 }
-Layout::NormalizedFaceInfo LayoutFlatFixed::From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const
+Layout::NormalizedFaceInfo LayoutFlatFixed::From3dToNormalizedFaceInfo(const Coord3dCart& coord) const
 {
-    const Quaternion& rotationMat = m_dynamicPosition.GetNextPosition();
-    Coord3dSpherical cardPosition = Rotation(sphericalCoord, rotationMat.Inv());
-    cardPosition.SetTheta(0.5+cardPosition.GetTheta()/m_horizontalAngleOfVision);
-    cardPosition.SetPhi(0.5+(cardPosition.GetPhi() - PI()/2)/m_verticalAngleOfVision);
-    return Layout::NormalizedFaceInfo(CoordF(cardPosition.GetTheta(), cardPosition.GetPhi()), 0);
+    const RotMat& invRotationMat = m_dynamicPosition.GetNextInvRotMat();
+    Coord3dCart cardPosition = Rotation(coord, invRotationMat);
+    return Layout::NormalizedFaceInfo(CoordF(0.5+cardPosition.GetTheta(m_mathMode)/m_horizontalAngleOfVision,
+                                             0.5+(cardPosition.GetPhi(m_mathMode) - PI()/2)/m_verticalAngleOfVision), 0);
 }
 Coord3dCart LayoutFlatFixed::FromNormalizedInfoTo3d(const Layout::NormalizedFaceInfo& ni) const
 {
     const CoordF& coord(ni.m_normalizedFaceCoordinate);
     // Coord3dCart coordBefRot(1.f, (coord.x-0.5)*m_maxHDist, (coord.y-0.5)*m_maxVDist);//coordinate in the plan x=1
-    Coord3dSpherical coordBefRot(1.f, (coord.x-0.5)*m_horizontalAngleOfVision, PI()/2+(coord.y-0.5)*m_verticalAngleOfVision);
-    const Quaternion& rotationMat = m_dynamicPosition.GetNextPosition();
-    auto p = Rotation(coordBefRot, rotationMat);
+    Coord3dCart coordBefRot = Coord3dCart::FromSpherical((coord.x-0.5)*m_horizontalAngleOfVision, PI()/2+(coord.y-0.5)*m_verticalAngleOfVision, m_mathMode);
+    const RotMat& rotationMat = m_dynamicPosition.GetNextRotMat();
     return Rotation(coordBefRot, rotationMat);
 }
 
 std::shared_ptr<Picture> LayoutFlatFixed::ReadNextPictureFromVideoImpl(void)
 {
     auto matptr = m_inputVideoPtr->GetNextPicture(0);
-    return std::make_shared<Picture>(matptr->clone());
+    return PicturePool::GetDefault()->Adopt(*matptr);
 }
 
 void LayoutFlatFixed::WritePictureToVideoImpl(std::shared_ptr<Picture> pict)
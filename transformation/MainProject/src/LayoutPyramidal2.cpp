@@ -19,7 +19,7 @@ unsigned int LayoutPyramidal2::IStartOffset(LayoutPyramidalBased::Faces f, unsig
         return GetRes(Faces::Left)+(GetRes(Faces::Base)-GetRes(Faces::Base)*(GetRes(Faces::Top)+GetRes(Faces::Base)+GetRes(Faces::Bottom)-j)/GetRes(Faces::Bottom))/2;
     case Faces::Black:
     case Faces::Last:
-        std::invalid_argument("IStartOffset: Last is not a valid face");
+        throw std::invalid_argument("IStartOffset: Last is not a valid face");
     }
 }
 
@@ -39,7 +39,7 @@ unsigned int LayoutPyramidal2::IEndOffset(LayoutPyramidalBased::Faces f, unsigne
         return IStartOffset(Faces::Right, j)-(GetRes(Faces::Base)-GetRes(Faces::Base)*(GetRes(Faces::Top)+GetRes(Faces::Base)+GetRes(Faces::Bottom)-j)/GetRes(Faces::Bottom))/2;
     case Faces::Black:
     case Faces::Last:
-        std::invalid_argument("IStartOffset: Last is not a valid face");
+        throw std::invalid_argument("IStartOffset: Last is not a valid face");
     }
 }
 
@@ -59,7 +59,7 @@ unsigned int LayoutPyramidal2::JStartOffset(LayoutPyramidalBased::Faces f, unsig
         return GetRes(Faces::Top)+GetRes(Faces::Base);
     case Faces::Black:
     case Faces::Last:
-        std::invalid_argument("IStartOffset: Last is not a valid face");
+        throw std::invalid_argument("IStartOffset: Last is not a valid face");
     }
 }
 
@@ -79,7 +79,7 @@ unsigned int LayoutPyramidal2::JEndOffset(LayoutPyramidalBased::Faces f, unsigne
         return GetRes(Faces::Top)+GetRes(Faces::Base)+GetRes(Faces::Bottom);
     case Faces::Black:
     case Faces::Last:
-        std::invalid_argument("IStartOffset: Last is not a valid face");
+        throw std::invalid_argument("IStartOffset: Last is not a valid face");
     }
 }
 
@@ -235,7 +235,7 @@ CoordF LayoutPyramidal2::FromNormalizedInfoTo2d(const Layout::NormalizedFaceInfo
     }
     else
     {
-        std::invalid_argument("FromNormalizedInfoTo2d: Last is not a valid face");
+        throw std::invalid_argument("FromNormalizedInfoTo2d: Last is not a valid face");
     }
 
 /*
@@ -290,7 +290,7 @@ std::shared_ptr<Picture> LayoutPyramidal2::ReadNextPictureFromVideoImpl(void)
           //std::cout << "Expected Width: "<< GetRes(f) << "; Height " << GetRes(f) << "; received width "<< facePictPtr->cols << " height "<< facePictPtr->rows << std::endl;
           if (!isInit)
           {
-              outputMat = cv::Mat( m_outHeight, m_outWidth, facePictPtr->type());
+              outputMat = PicturePool::GetDefault()->GetMat(m_outHeight, m_outWidth, facePictPtr->type());
               isInit = true;
           }
           cv::Mat facePictMat ( outputMat, roi);
@@ -300,9 +300,9 @@ std::shared_ptr<Picture> LayoutPyramidal2::ReadNextPictureFromVideoImpl(void)
     else
     {
       auto facePictPtr = m_inputVideoPtr->GetNextPicture(0);
-      facePictPtr->copyTo(outputMat);
+      outputMat = *facePictPtr; //the decoded picture is not shared: no need to copy it
     }
-    return std::make_shared<Picture>(outputMat);
+    return PicturePool::GetDefault()->Adopt(outputMat);
 }
 
 void LayoutPyramidal2::WritePictureToVideoImpl(std::shared_ptr<Picture> pict)
@@ -7,9 +7,21 @@ double LayoutPyramidalBased::UsePlanEquation(double x) const //Use the plan equa
     return -m_canonicTopPlan[3] - x * m_canonicTopPlan[0];
 }
 
-Layout::NormalizedFaceInfo LayoutPyramidalBased::From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const
+std::array<Plan, 6> LayoutPyramidalBased::ComputeFacePlans(const Plan& canonicTopPlan)
 {
-    Coord3dSpherical p = Rotation(sphericalCoord, m_rotQuaternion.Inv());
+    std::array<Plan, 6> facePlans;
+    facePlans[static_cast<unsigned>(Faces::Base)] = Plan(1,0,0,-1);
+    facePlans[static_cast<unsigned>(Faces::Top)] = Plan( canonicTopPlan[0], canonicTopPlan[1], canonicTopPlan[2], canonicTopPlan[3]);
+    facePlans[static_cast<unsigned>(Faces::Left)] = Plan( canonicTopPlan[0], -canonicTopPlan[2], canonicTopPlan[1], canonicTopPlan[3]);
+    facePlans[static_cast<unsigned>(Faces::Bottom)] = Plan( canonicTopPlan[0], -canonicTopPlan[1], -canonicTopPlan[2], canonicTopPlan[3]);
+    facePlans[static_cast<unsigned>(Faces::Right)] = Plan( canonicTopPlan[0], canonicTopPlan[2], -canonicTopPlan[1], canonicTopPlan[3]);
+    facePlans[static_cast<unsigned>(Faces::Black)] = Plan(0,0,0,0);
+    return facePlans;
+}
+
+Layout::NormalizedFaceInfo LayoutPyramidalBased::From3dToNormalizedFaceInfo(const Coord3dCart& coord) const
+{
+    Coord3dCart p = Rotation(coord, m_invRotMat);
 
     FaceToPlanFct<Faces> lambda = [this] (Faces f) {return this->FaceToPlan(f);};
     auto rtr = IntersectionCart(lambda, p);
@@ -101,5 +113,5 @@ Coord3dCart LayoutPyramidalBased::FromNormalizedInfoTo3d(const NormalizedFaceInf
     case Faces::Black:
         return Coord3dCart(0,0,0);
     }
-    return Rotation(v, m_rotQuaternion);
+    return Rotation(v, m_rotMat);
 }
@@ -3,141 +3,34 @@
 using namespace IMT;
 
 
-unsigned int LayoutRhombicdodeca::IStartOffset(Faces f) const
+void LayoutRhombicdodeca::InitFaceOffsets(void)
 {
-    switch (f)
+    //The face k is in the column k/2 and in the row k%2, centered in its cell
+    unsigned int colStart(0);
+    for (unsigned int k = 0; k < 12; ++k)
     {
-        case Faces::Face1:
-            return (m_colsMaxOffset[0]-GetRes(Faces::Face1))/2;
-        case Faces::Face2:
-            return (m_colsMaxOffset[0]-GetRes(Faces::Face2))/2;
-        case Faces::Face3:
-            return m_colsMaxOffset[0]+ (m_colsMaxOffset[1]-GetRes(Faces::Face3))/2;
-        case Faces::Face4:
-            return m_colsMaxOffset[0]+ (m_colsMaxOffset[1]-GetRes(Faces::Face4))/2;
-        case Faces::Face5:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + (m_colsMaxOffset[2]-GetRes(Faces::Face5))/2;
-        case Faces::Face6:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + (m_colsMaxOffset[2]-GetRes(Faces::Face6))/2;
-        case Faces::Face7:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + (m_colsMaxOffset[3]-GetRes(Faces::Face7))/2;
-        case Faces::Face8:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + (m_colsMaxOffset[3]-GetRes(Faces::Face8))/2;
-        case Faces::Face9:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3] + (m_colsMaxOffset[4]-GetRes(Faces::Face9))/2;
-        case Faces::Face10:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3] + (m_colsMaxOffset[4]-GetRes(Faces::Face10))/2;
-        case Faces::Face11:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3] + m_colsMaxOffset[4] + (m_colsMaxOffset[5]-GetRes(Faces::Face11))/2;
-        case Faces::Face12:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3] + m_colsMaxOffset[4] + (m_colsMaxOffset[5]-GetRes(Faces::Face12))/2;
-        case Faces::Black:
-            throw std::invalid_argument("IStartOffset: Black is not a valid face");
-        case Faces::Last:
-            throw std::invalid_argument("IStartOffset: Last is not a valid face");
-    }
-}
-unsigned int LayoutRhombicdodeca::IEndOffset(Faces f) const
-{
-    switch (f)
-    {
-        case Faces::Face1:
-            return m_colsMaxOffset[0]-(m_colsMaxOffset[0]-GetRes(Faces::Face1))/2;
-        case Faces::Face2:
-            return m_colsMaxOffset[0]-(m_colsMaxOffset[0]-GetRes(Faces::Face2))/2;
-        case Faces::Face3:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1]-(m_colsMaxOffset[1]-GetRes(Faces::Face3))/2;
-        case Faces::Face4:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1]-(m_colsMaxOffset[1]-GetRes(Faces::Face4))/2;
-        case Faces::Face5:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2]-(m_colsMaxOffset[2]-GetRes(Faces::Face5))/2;
-        case Faces::Face6:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2]-(m_colsMaxOffset[2]-GetRes(Faces::Face6))/2;
-        case Faces::Face7:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3]-(m_colsMaxOffset[3]-GetRes(Faces::Face7))/2;
-        case Faces::Face8:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3]-(m_colsMaxOffset[3]-GetRes(Faces::Face8))/2;
-        case Faces::Face9:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3] + m_colsMaxOffset[4]-(m_colsMaxOffset[4]-GetRes(Faces::Face9))/2;
-        case Faces::Face10:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3] + m_colsMaxOffset[4]-(m_colsMaxOffset[4]-GetRes(Faces::Face10))/2;
-        case Faces::Face11:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3] + m_colsMaxOffset[4] + m_colsMaxOffset[5]-(m_colsMaxOffset[5]-GetRes(Faces::Face11))/2;
-        case Faces::Face12:
-            return m_colsMaxOffset[0]+ m_colsMaxOffset[1] + m_colsMaxOffset[2] + m_colsMaxOffset[3] + m_colsMaxOffset[4] + m_colsMaxOffset[5]-(m_colsMaxOffset[5]-GetRes(Faces::Face12))/2;
-        case Faces::Black:
-            throw std::invalid_argument("IStartOffset: Black is not a valid face");
-        case Faces::Last:
-            throw std::invalid_argument("IStartOffset: Last is not a valid face");
-    }
-}
-unsigned int LayoutRhombicdodeca::JStartOffset(Faces f) const
-{
-    switch (f)
-    {
-        case Faces::Face1:
-            return (m_rowsMaxOffset[0]-GetRes(Faces::Face1))/2;
-        case Faces::Face2:
-            return m_rowsMaxOffset[0]+ (m_rowsMaxOffset[1]-GetRes(Faces::Face2))/2;
-        case Faces::Face3:
-            return (m_rowsMaxOffset[0]-GetRes(Faces::Face3))/2;;
-        case Faces::Face4:
-            return m_rowsMaxOffset[0]+ (m_rowsMaxOffset[1]-GetRes(Faces::Face4))/2;
-        case Faces::Face5:
-            return (m_rowsMaxOffset[0]-GetRes(Faces::Face5))/2;;
-        case Faces::Face6:
-            return m_rowsMaxOffset[0]+ (m_rowsMaxOffset[1]-GetRes(Faces::Face6))/2;
-        case Faces::Face7:
-            return (m_rowsMaxOffset[0]-GetRes(Faces::Face7))/2;;
-        case Faces::Face8:
-            return m_rowsMaxOffset[0]+ (m_rowsMaxOffset[1]-GetRes(Faces::Face8))/2;
-        case Faces::Face9:
-            return (m_rowsMaxOffset[0]-GetRes(Faces::Face9))/2;;
-        case Faces::Face10:
-            return m_rowsMaxOffset[0]+ (m_rowsMaxOffset[1]-GetRes(Faces::Face10))/2;
-        case Faces::Face11:
-            return (m_rowsMaxOffset[0]-GetRes(Faces::Face11))/2;;
-        case Faces::Face12:
-            return m_rowsMaxOffset[0]+ (m_rowsMaxOffset[1]-GetRes(Faces::Face12))/2;
-        case Faces::Black:
-            throw std::invalid_argument("IStartOffset: Black is not a valid face");
-        case Faces::Last:
-            throw std::invalid_argument("IStartOffset: Last is not a valid face");
+        Faces f = static_cast<Faces>(k);
+        const unsigned int& colWidth = m_colsMaxOffset[k/2];
+        const unsigned int rowStart = k%2 == 0 ? 0 : m_rowsMaxOffset[0];
+        const unsigned int& rowHeight = m_rowsMaxOffset[k%2];
+        m_faceOffsets[k][0] = colStart + (colWidth-GetRes(f))/2;
+        m_faceOffsets[k][1] = colStart + colWidth-(colWidth-GetRes(f))/2;
+        m_faceOffsets[k][2] = rowStart + (rowHeight-GetRes(f))/2;
+        m_faceOffsets[k][3] = rowStart + rowHeight-(rowHeight-GetRes(f))/2;
+        if (k%2 == 1)
+        {
+            colStart += colWidth;
+        }
     }
 }
-unsigned int LayoutRhombicdodeca::JEndOffset(Faces f) const
+
+const std::array<unsigned int, 4>& LayoutRhombicdodeca::GetFaceOffsets(Faces f) const
 {
-    switch (f)
+    if (f == Faces::Black || f == Faces::Last)
     {
-        case Faces::Face1:
-            return m_rowsMaxOffset[0]-(m_rowsMaxOffset[0]-GetRes(Faces::Face1))/2;
-        case Faces::Face2:
-            return m_rowsMaxOffset[0]+ m_rowsMaxOffset[1]-(m_rowsMaxOffset[1]-GetRes(Faces::Face2))/2;
-        case Faces::Face3:
-            return m_rowsMaxOffset[0]-(m_rowsMaxOffset[0]-GetRes(Faces::Face3))/2;
-        case Faces::Face4:
-            return m_rowsMaxOffset[0]+ m_rowsMaxOffset[1]-(m_rowsMaxOffset[1]-GetRes(Faces::Face4))/2;
-        case Faces::Face5:
-            return m_rowsMaxOffset[0]-(m_rowsMaxOffset[0]-GetRes(Faces::Face5))/2;
-        case Faces::Face6:
-            return m_rowsMaxOffset[0]+ m_rowsMaxOffset[1]-(m_rowsMaxOffset[1]-GetRes(Faces::Face6))/2;
-        case Faces::Face7:
-            return m_rowsMaxOffset[0]-(m_rowsMaxOffset[0]-GetRes(Faces::Face7))/2;
-        case Faces::Face8:
-            return m_rowsMaxOffset[0]+ m_rowsMaxOffset[1]-(m_rowsMaxOffset[1]-GetRes(Faces::Face8))/2;
-        case Faces::Face9:
-            return m_rowsMaxOffset[0]-(m_rowsMaxOffset[0]-GetRes(Faces::Face9))/2;
-        case Faces::Face10:
-            return m_rowsMaxOffset[0]+ m_rowsMaxOffset[1]-(m_rowsMaxOffset[1]-GetRes(Faces::Face10))/2;
-        case Faces::Face11:
-            return m_rowsMaxOffset[0]-(m_rowsMaxOffset[0]-GetRes(Faces::Face11))/2;
-        case Faces::Face12:
-            return m_rowsMaxOffset[0]+ m_rowsMaxOffset[1]-(m_rowsMaxOffset[1]-GetRes(Faces::Face12))/2;
-        case Faces::Black:
-            throw std::invalid_argument("IStartOffset: Black is not a valid face");
-        case Faces::Last:
-            throw std::invalid_argument("IStartOffset: Last is not a valid face");
+        throw std::invalid_argument("GetFaceOffsets: "+std::string(f == Faces::Black ? "Black" : "Last")+" is not a valid face");
     }
+    return m_faceOffsets[static_cast<unsigned>(f)];
 }
 
 Layout::NormalizedFaceInfo LayoutRhombicdodeca::From2dToNormalizedFaceInfo(const CoordI& pixel) const
@@ -196,19 +89,19 @@ std::shared_ptr<Picture> LayoutRhombicdodeca::ReadNextPictureFromVideoImpl(void)
           //std::cout << "Expected Width: "<< GetRes(f) << "; Height " << GetRes(f) << "; received width "<< facePictPtr->cols << " height "<< facePictPtr->rows << std::endl;
           if (!isInit)
           {
-              outputMat = cv::Mat( m_outHeight, m_outWidth, facePictPtr->type());
+              outputMat = PicturePool::GetDefault()->GetMat(m_outHeight, m_outWidth, facePictPtr->type());
               isInit = true;
           }
           cv::Mat facePictMat ( outputMat, roi);
           facePictPtr->copyTo(facePictMat);
       }
-      return std::make_shared<Picture>(outputMat);
     }
     else
     {
       auto facePictPtr = m_inputVideoPtr->GetNextPicture(0);
-      facePictPtr->copyTo(outputMat);
+      outputMat = *facePictPtr; //the decoded picture is not shared: no need to copy it
     }
+    return PicturePool::GetDefault()->Adopt(outputMat);
 }
 
 void LayoutRhombicdodeca::WritePictureToVideoImpl(std::shared_ptr<Picture> pict)
@@ -14,10 +14,10 @@ CoordF LayoutViewport::FromNormalizedInfoTo2d(const Layout::NormalizedFaceInfo&
     const CoordF& coord(ni.m_normalizedFaceCoordinate);
     return CoordF(coord.x*m_outWidth, (coord.y)*m_outHeight);
 }
-Layout::NormalizedFaceInfo LayoutViewport::From3dToNormalizedFaceInfo(const Coord3dSpherical& sphericalCoord) const
+Layout::NormalizedFaceInfo LayoutViewport::From3dToNormalizedFaceInfo(const Coord3dCart& coord) const
 {
-    const Quaternion& rotationMat = m_dynamicPosition.GetNextPosition();
-    Coord3dCart cardPosition = Rotation(sphericalCoord, rotationMat.Inv());
+    const RotMat& invRotationMat = m_dynamicPosition.GetNextInvRotMat();
+    Coord3dCart cardPosition = Rotation(coord, invRotationMat);
     double i(-1), j(-1);
     if (cardPosition.GetX() > 0)
     {
@@ -35,14 +35,14 @@ Coord3dCart LayoutViewport::FromNormalizedInfoTo3d(const Layout::NormalizedFaceI
     double v = (0.5-coord.y)*(2*m_maxVDist);
     Coord3dCart coordBefRot(1, u, v);
     coordBefRot /= coordBefRot.Norm();
-    const Quaternion& rotationMat = m_dynamicPosition.GetNextPosition();
+    const RotMat& rotationMat = m_dynamicPosition.GetNextRotMat();
     return Rotation(coordBefRot, rotationMat);
 }
 
 std::shared_ptr<Picture> LayoutViewport::ReadNextPictureFromVideoImpl(void)
 {
     auto matptr = m_inputVideoPtr->GetNextPicture(0);
-    return std::make_shared<Picture>(matptr->clone());
+    return PicturePool::GetDefault()->Adopt(*matptr);
 }
 
 void LayoutViewport::WritePictureToVideoImpl(std::shared_ptr<Picture> pict)
@@ -0,0 +1,116 @@
+/**
+ * Compute in one pass the quality inside the viewports of a set of users (head position traces)
+ */
+
+#include "MultiViewportQuality.hpp"
+#include "TaskPool.hpp"
+#include <stdexcept>
+
+using namespace IMT;
+
+MultiViewportQuality::MultiViewportQuality(const std::vector<std::string>& pathToTraces, std::shared_ptr<Layout> viewportGeometry, std::string pathToOutput, Picture::InterpolationTech interpol):
+  m_userPositions(), m_viewportGeometry(std::move(viewportGeometry)), m_localDirections(), m_output(pathToOutput), m_interpol(interpol), m_headerWritten(false)
+{
+  if (!m_output.is_open())
+  {
+    throw std::invalid_argument("Cannot open the viewport quality output file "+pathToOutput);
+  }
+  for (const auto& path: pathToTraces)
+  {
+    m_userPositions.emplace_back(path);
+  }
+  //The viewport geometry is the same for all users: we compute once the direction of each pixel, only the head rotation change from one user to the other
+  const unsigned int width = m_viewportGeometry->GetWidth();
+  const unsigned int height = m_viewportGeometry->GetHeight();
+  m_localDirections.resize(width*height);
+  TaskPool::GetDefault().ParallelFor(0, height, TaskPool::GetGrain(width), [&](size_t firstRow, size_t lastRow)
+  {
+    for (unsigned int j = firstRow; j < lastRow; ++j)
+    {
+      for (unsigned int i = 0; i < width; ++i)
+      {
+        m_localDirections[j*width+i] = m_viewportGeometry->From2dTo3d(CoordI(i,j));
+      }
+    }
+  });
+}
+
+void MultiViewportQuality::NextStep(double relatifTimestamp)
+{
+  for (auto& dp: m_userPositions)
+  {
+    dp.SetNextPosition(relatifTimestamp);
+  }
+}
+
+cv::Mat MultiViewportQuality::ExtractViewport(const std::vector<Coord3dCart>& directions, const Picture& pict, const Layout& layout) const
+{
+  const unsigned int width = m_viewportGeometry->GetWidth();
+  const unsigned int height = m_viewportGeometry->GetHeight();
+  cv::Mat viewport = cv::Mat::zeros(height, width, pict.GetMat().type());
+  for (unsigned int j = 0; j < height; ++j)
+  {
+    for (unsigned int i = 0; i < width; ++i)
+    {
+      const auto& dir = directions[j*width+i];
+      if (dir.Norm() != 0 && !std::isnan(dir.Norm()))
+      {//Keep the pixel black if the direction is not defined
+        auto coordPixel = layout.FromSphereTo2d(dir);
+        if (inInterval(coordPixel.x, 0, pict.GetMat().cols) && inInterval(coordPixel.y, 0, pict.GetMat().rows))
+        {
+          viewport.at<Pixel>(j, i) = pict.GetInterPixel(coordPixel, m_interpol);
+        }
+      }
+    }
+  }
+  return viewport;
+}
+
+void MultiViewportQuality::ComputeQuality(unsigned int frameId, const std::vector<std::shared_ptr<Picture>>& finalPicts, const std::vector<std::shared_ptr<Layout>>& finalLayouts)
+{
+  if (finalPicts.size() != finalLayouts.size())
+  {
+    throw std::invalid_argument("Viewport quality computation require one layout per final picture");
+  }
+  if (!m_headerWritten)
+  {
+    m_output << "frame user flow PSNR SSIM" << std::endl;
+    m_headerWritten = true;
+  }
+  if (finalPicts.size() < 2)
+  {//nothing to compare with the reference
+    return;
+  }
+  const unsigned int nbTested = finalPicts.size()-1;
+  const int nbUsers = m_userPositions.size();
+  //quality[2*(u*nbTested + f)] is the PSNR and quality[2*(u*nbTested + f)+1] the SSIM of the flow f+1 for the user u
+  std::vector<double> quality(2*nbUsers*nbTested, 0);
+  //one task per user
+  TaskPool::GetDefault().ParallelFor(0, nbUsers, 1, [&](size_t firstUser, size_t lastUser)
+  {
+    for (size_t u = firstUser; u < lastUser; ++u)
+    {
+      //The rotated directions are computed once per user and reused for the reference and each tested picture
+      const RotMat& rotation = m_userPositions[u].GetNextRotMat();
+      std::vector<Coord3dCart> directions(m_localDirections.size());
+      for (size_t p = 0; p < m_localDirections.size(); ++p)
+      {
+        directions[p] = Rotation(m_localDirections[p], rotation);
+      }
+      Picture refViewport(ExtractViewport(directions, *finalPicts[0], *finalLayouts[0]));
+      for (unsigned int f = 0; f < nbTested; ++f)
+      {
+        Picture viewport(ExtractViewport(directions, *finalPicts[f+1], *finalLayouts[f+1]));
+        quality[2*(u*nbTested + f)] = refViewport.GetPSNR(viewport);
+        quality[2*(u*nbTested + f)+1] = refViewport.GetSSIM(viewport);
+      }
+    }
+  });
+  for (int u = 0; u < nbUsers; ++u)
+  {
+    for (unsigned int f = 0; f < nbTested; ++f)
+    {
+      m_output << frameId << " " << u << " " << f+2 << " " << quality[2*(u*nbTested + f)] << " " << quality[2*(u*nbTested + f)+1] << std::endl;
+    }
+  }
+}
@@ -1,6 +1,8 @@
 #include "Picture.hpp"
 #include "Layout.hpp"
-#include "sphere_655362.hpp"
+#include "TaskPool.hpp"
+#include "ScratchArena.hpp"
+#include "Profiler.hpp"
 
 #include <cmath>
 
@@ -213,24 +215,38 @@ void Picture::ImgShowWithLimit(std::string txt, cv::Size s) const
     ImgShowResize(txt, cv::Size(width,height));
 }
 
+cv::Mat Picture::GetLumaPlane(const cv::Mat& img, ScratchArena* arena)
+{
+    cv::Mat luma = arena != nullptr ? arena->GetMat(img.rows, img.cols, CV_32F) : cv::Mat();
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    cv::Mat imgYUV = scratch.GetMat(img.rows, img.cols, img.type());
+    cv::Mat lumaByte = scratch.GetMat(img.rows, img.cols, CV_8U);
+    cv::cvtColor(img, imgYUV, cv::COLOR_BGR2YUV);
+    cv::extractChannel(imgYUV, lumaByte, 0);
+    lumaByte.convertTo(luma, CV_32F);
+    return luma;
+}
+
+double Picture::GetMSE(const cv::Mat& lumaRef, const cv::Mat& lumaArg)
+{
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    cv::Mat s1 = scratch.GetMat(lumaRef.rows, lumaRef.cols, lumaRef.type());
+    cv::subtract(lumaRef, lumaArg, s1);
+    s1 = s1.mul(s1);
+    return cv::mean(s1).val[0];
+}
+
 double Picture::GetMSE(const Picture& pic) const
 {
     if (pic.GetHeight()!= GetHeight() && pic.GetWidth() != GetWidth())
     {
         throw std::invalid_argument("MSE computation require pictures to have the same width and height");
     }
-    cv::Mat s1;
-    cv::Mat vRefYUV;
-    cv::Mat vArgYUV;
-    cv::cvtColor(m_pictMat, vRefYUV, cv::COLOR_BGR2YUV);
-    cv::cvtColor(pic.m_pictMat, vArgYUV, cv::COLOR_BGR2YUV);
-    cv::absdiff(vRefYUV, vArgYUV, s1);
-    s1.convertTo(s1, CV_32F);
-    s1 = s1.mul(s1);
-    cv::Scalar s = cv::sum(s1);
-
-    return cv::mean(s1).val[0];
-
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    return GetMSE(GetLumaPlane(m_pictMat, &scratch), GetLumaPlane(pic.m_pictMat, &scratch));
 }
 
 double Picture::GetPSNR(const Picture& pic) const
@@ -245,68 +261,84 @@ double Picture::GetPSNR(const Picture& pic) const
 void Picture::ApplyGaussianBlur(const cv::Mat& src, cv::Mat& dst, int ksize, double sigma) const
 {
     int invalid = (ksize-1)/2;
-    cv::Mat tmp(src.rows, src.cols, m_pictMat.type());
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    cv::Mat tmp = scratch.GetMat(src.rows, src.cols, src.type());
     cv::GaussianBlur(src, tmp, cv::Size(ksize,ksize), sigma);
     tmp(cv::Range(invalid, tmp.rows-invalid), cv::Range(invalid, tmp.cols-invalid)).copyTo(dst);
 }
 
+Picture::SSIMMoments Picture::GetMomentsFromArena(ScratchArena& arena, int rows, int cols, int type)
+{
+    SSIMMoments moments;
+    moments.I = arena.GetMat(rows, cols, type);
+    moments.mu = arena.GetMat(rows, cols, type);
+    moments.mu_2 = arena.GetMat(rows, cols, type);
+    moments.sigma_2 = arena.GetMat(rows, cols, type);
+    return moments;
+}
+
+void Picture::ComputeSSIMMoments(const cv::Mat& img, SSIMMoments& moments)
+{
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    cv::Mat imgYUV = scratch.GetMat(img.rows, img.cols, img.type());
+    cv::cvtColor(img, imgYUV, cv::COLOR_BGR2YUV);
+    imgYUV.convertTo(moments.I, CV_32F);            // cannot calculate on one byte large values
+
+    cv::GaussianBlur(moments.I, moments.mu, cv::Size(11, 11), 1.5);
+    moments.mu_2 = moments.mu.mul(moments.mu);
+
+    cv::Mat I_2 = scratch.GetMat(moments.I.rows, moments.I.cols, moments.I.type());
+    cv::multiply(moments.I, moments.I, I_2);
+    cv::GaussianBlur(I_2, moments.sigma_2, cv::Size(11, 11), 1.5);
+    moments.sigma_2 -= moments.mu_2;
+}
 
-std::tuple<double, double> Picture::ComputeSSIM(const cv::Mat& img1_ori, const cv::Mat& img2_ori) const
+Picture::SSIMMoments Picture::ComputeSSIMMoments(const cv::Mat& img, ScratchArena* arena)
 {
+    SSIMMoments moments = arena != nullptr ? GetMomentsFromArena(*arena, img.rows, img.cols, CV_32FC(img.channels())) : SSIMMoments();
+    ComputeSSIMMoments(img, moments);
+    return moments;
+}
 
-    if (img1_ori.rows!= img2_ori.rows && img1_ori.cols !=  img2_ori.cols)
-//    if (img1.rows!= img2.rows && img1.cols !=  img2.cols)
+std::tuple<double, double> Picture::ComputeSSIM(const SSIMMoments& moments1, const SSIMMoments& moments2)
+{
+    if (moments1.I.rows!= moments2.I.rows && moments1.I.cols != moments2.I.cols)
     {
         throw std::invalid_argument("SSIM computation require pictures to have the same width and height");
     }
 
-    /***************************** INITS **********************************/
-    int d = CV_32F;
-
-    cv::Mat img1YUV, img2YUV;
-    cv::cvtColor(img1_ori, img1YUV, cv::COLOR_BGR2YUV);
-    cv::cvtColor(img2_ori, img2YUV, cv::COLOR_BGR2YUV);
-    cv::Mat I1, I2;
-    img1YUV.convertTo(I1, d);            // cannot calculate on one byte large values
-    img2YUV.convertTo(I2, d);
-
-    cv::Mat I2_2   = I2.mul(I2);        // I2^2
-    cv::Mat I1_2   = I1.mul(I1);        // I1^2
-    cv::Mat I1_I2  = I1.mul(I2);        // I1 * I2
-
-    /*************************** END INITS **********************************/
-
-    cv::Mat mu1, mu2;                   // PRELIMINARY COMPUTING
-    cv::GaussianBlur(I1, mu1, cv::Size(11, 11), 1.5);
-    cv::GaussianBlur(I2, mu2, cv::Size(11, 11), 1.5);
-
-    cv::Mat mu1_2   =   mu1.mul(mu1);
-    cv::Mat mu2_2   =   mu2.mul(mu2);
-    cv::Mat mu1_mu2 =   mu1.mul(mu2);
-
-    cv::Mat sigma1_2, sigma2_2, sigma12;
-
-    cv::GaussianBlur(I1_2, sigma1_2, cv::Size(11, 11), 1.5);
-    sigma1_2 -= mu1_2;
-
-    cv::GaussianBlur(I2_2, sigma2_2, cv::Size(11, 11), 1.5);
-    sigma2_2 -= mu2_2;
-
+    //the temporaries are taken from the arena: the matrix expressions below are then evaluated in place
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    const int rows = moments1.I.rows;
+    const int cols = moments1.I.cols;
+    const int type = moments1.I.type();
+    cv::Mat mu1_mu2 = scratch.GetMat(rows, cols, type);
+    mu1_mu2 = moments1.mu.mul(moments2.mu);
+    cv::Mat I1_I2 = scratch.GetMat(rows, cols, type);
+    cv::multiply(moments1.I, moments2.I, I1_I2);
+    cv::Mat sigma12 = scratch.GetMat(rows, cols, type);
     cv::GaussianBlur(I1_I2, sigma12, cv::Size(11, 11), 1.5);
     sigma12 -= mu1_mu2;
 
     ///////////////////////////////// FORMULA ////////////////////////////////
-    cv::Mat t1, t2, t3, t4;
+    cv::Mat t1 = scratch.GetMat(rows, cols, type);
+    cv::Mat t2 = scratch.GetMat(rows, cols, type);
+    cv::Mat t3 = scratch.GetMat(rows, cols, type);
+    cv::Mat t4 = scratch.GetMat(rows, cols, type);
 
     t1 = 2 * mu1_mu2 + m_ssim_c1;
     t2 = 2 * sigma12 + m_ssim_c2;
     t3 = t1.mul(t2);                 // t3 = ((2*mu1_mu2 + C1).*(2*sigma12 + C2))
 
-    t1 = mu1_2 + mu2_2 + m_ssim_c1;
-    t4 = sigma1_2 + sigma2_2 + m_ssim_c2;
+    t1 = moments1.mu_2 + moments2.mu_2 + m_ssim_c1;
+    t4 = moments1.sigma_2 + moments2.sigma_2 + m_ssim_c2;
     t1 = t1.mul(t4);                 // t1 =((mu1_2 + mu2_2 + C1).*(sigma1_2 + sigma2_2 + C2))
 
-    cv::Mat ssim_map, mcs_map;
+    cv::Mat ssim_map = scratch.GetMat(rows, cols, type);
+    cv::Mat mcs_map = scratch.GetMat(rows, cols, type);
     cv::divide(t3, t1, ssim_map);        // ssim_map =  t3./t1;
     cv::divide(t2, t4, mcs_map);
 
@@ -315,68 +347,76 @@ std::tuple<double, double> Picture::ComputeSSIM(const cv::Mat& img1_ori, const c
     return std::make_tuple(mssim, mcs);
 }
 
+std::tuple<double, double> Picture::ComputeSSIM(const cv::Mat& img1, const cv::Mat& img2)
+{
+    if (img1.rows!= img2.rows && img1.cols !=  img2.cols)
+    {
+        throw std::invalid_argument("SSIM computation require pictures to have the same width and height");
+    }
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    return ComputeSSIM(ComputeSSIMMoments(img1, &scratch), ComputeSSIMMoments(img2, &scratch));
+}
+
 double Picture::GetSSIM(const Picture& pic) const
 {
     return std::get<0>(ComputeSSIM(m_pictMat, pic.m_pictMat));
 }
 
-double Picture::GetMSSSIM(const Picture& pic) const
+std::vector<Picture::SSIMMoments> Picture::ComputeMSSSIMPyramid(ScratchArena* arena) const
 {
-    if (pic.GetHeight()!= GetHeight() && pic.GetWidth() != GetWidth())
-    {
-        throw std::invalid_argument("MS-SSIM computation require pictures to have the same width and height");
-    }
     int h = GetHeight() + (GetHeight() % 16 != 0 ? 16-(GetHeight() % 16):0);
     int w = GetHeight() + (GetWidth() % 16 != 0 ? 16-(GetWidth() % 16):0);
 
-
-    double mssim[m_nlevs];
-    double mcs[m_nlevs];
-
-    cv::Mat im1[m_nlevs];
-    cv::Mat im2[m_nlevs];
-
-    cv::Mat tmp1, tmp2;
-
-    cv::resize(m_pictMat, tmp1, cv::Size(w, h), 0, 0, cv::INTER_LINEAR);
-    cv::resize(pic.m_pictMat, tmp2, cv::Size(w, h), 0, 0, cv::INTER_LINEAR);
-    if (m_pictMat.type() != CV_32F)
-    {
-         tmp1.convertTo(im1[0], CV_32F);
-    }
-    else
-    {
-        im1[0] = tmp1;
+    std::vector<SSIMMoments> pyramid(m_nlevs);
+    if (arena != nullptr)
+    {//the moments are taken from the arena before the scope of the temporaries
+        for (int l = 0, lh = h, lw = w; l < m_nlevs; ++l, lh /= 2, lw /= 2)
+        {
+            pyramid[l] = GetMomentsFromArena(*arena, lh, lw, CV_32FC(m_pictMat.channels()));
+        }
     }
-    if (pic.m_pictMat.type() != CV_32F)
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    cv::Mat tmp = scratch.GetMat(h, w, m_pictMat.type());
+    cv::Mat im;
+    cv::resize(m_pictMat, tmp, cv::Size(w, h), 0, 0, cv::INTER_LINEAR);
+    if (m_pictMat.type() != CV_32F)
     {
-         tmp2.convertTo(im2[0], CV_32F);
+         im = scratch.GetMat(h, w, CV_32FC(m_pictMat.channels()));
+         tmp.convertTo(im, CV_32F);
     }
     else
     {
-        im2[0] = tmp2;
+        im = tmp;
     }
 
     for (int l=0; l<m_nlevs; l++) {
-        // [mssim_array(l) ssim_map_array{l} mcs_array(l) cs_map_array{l}] = ssim_index_new(im1, im2, K, window);
-        auto res = ComputeSSIM(im1[l], im2[l]);
-        mssim[l] = std::get<0>(res);
-        mcs[l] = std::get<1>(res);
+        ComputeSSIMMoments(im, pyramid[l]);
 
         if (l < m_nlevs-1) {
             w /= 2;
             h /= 2;
-            im1[l+1] = cv::Mat(h,w,CV_32F);
-            im2[l+1] = cv::Mat(h,w,CV_32F);
-
-            // filtered_im1 = filter2(downsample_filter, im1, 'valid');
-            // im1 = filtered_im1(1:2:M-1, 1:2:N-1);
-            cv::resize(im1[l], im1[l+1], cv::Size(w,h), 0, 0, cv::INTER_LINEAR);
-            // filtered_im2 = filter2(downsample_filter, im2, 'valid');
-            // im2 = filtered_im2(1:2:M-1, 1:2:N-1);
-            cv::resize(im2[l], im2[l+1], cv::Size(w,h), 0, 0, cv::INTER_LINEAR);
+            // filtered_im = filter2(downsample_filter, im, 'valid');
+            // im = filtered_im(1:2:M-1, 1:2:N-1);
+            cv::Mat next = scratch.GetMat(h, w, im.type());
+            cv::resize(im, next, cv::Size(w,h), 0, 0, cv::INTER_LINEAR);
+            im = next;
         }
     }
+    return pyramid;
+}
+
+double Picture::ComputeMSSSIM(const std::vector<SSIMMoments>& pyramid1, const std::vector<SSIMMoments>& pyramid2)
+{
+    double mssim[m_nlevs];
+    double mcs[m_nlevs];
+    for (int l=0; l<m_nlevs; l++) {
+        // [mssim_array(l) ssim_map_array{l} mcs_array(l) cs_map_array{l}] = ssim_index_new(im1, im2, K, window);
+        auto res = ComputeSSIM(pyramid1[l], pyramid2[l]);
+        mssim[l] = std::get<0>(res);
+        mcs[l] = std::get<1>(res);
+    }
 
     // overall_mssim = prod(mcs_array(1:level-1).^weight(1:level-1))*mssim_array(level);
     double msssim = pow(mssim[m_nlevs-1] ,m_mssimWeight[m_nlevs-1]);
@@ -387,6 +427,16 @@ double Picture::GetMSSSIM(const Picture& pic) const
     return msssim;
 }
 
+double Picture::GetMSSSIM(const Picture& pic) const
+{
+    if (pic.GetHeight()!= GetHeight() && pic.GetWidth() != GetWidth())
+    {
+        throw std::invalid_argument("MS-SSIM computation require pictures to have the same width and height");
+    }
+    ScratchArena& scratch = ScratchArena::GetThreadLocal();
+    ScratchArena::Scope scope(scratch);
+    return ComputeMSSSIM(ComputeMSSSIMPyramid(&scratch), pic.ComputeMSSSIMPyramid(&scratch));
+}
 
 double Picture::GetWSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic) const
 {
@@ -394,71 +444,91 @@ double Picture::GetWSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& la
   {
       throw std::invalid_argument("MSE computation require pictures to have the same width and height");
   }
-  cv::Mat tmp1(cv::Mat::zeros(GetHeight(), GetWidth(), m_pictMat.type()));
+  ScratchArena& scratch = ScratchArena::GetThreadLocal();
+  ScratchArena::Scope scope(scratch);
+  cv::Mat tmp1 = scratch.GetMat(GetHeight(), GetWidth(), m_pictMat.type());
   cv::subtract(m_pictMat, pic.m_pictMat, tmp1);
   cv::multiply(tmp1, tmp1, tmp1);
-  cv::Mat tmp(cv::Mat::zeros(GetHeight(), GetWidth(), CV_64F));
+  cv::Mat tmp = scratch.GetMat(GetHeight(), GetWidth(), CV_64FC(m_pictMat.channels()));
   tmp1.convertTo(tmp, CV_64F);
-  double totalSurface = 0;
-  double maxSurface = 0;
-  #pragma omp parallel for collapse(2) shared(tmp, pic, layoutThisPict, layoutArgPic) schedule(dynamic) reduction(+:totalSurface)
-  for (unsigned int i = 0; i < pic.GetHeight(); ++i)
-  {
-    for (unsigned int j = 0; j < pic.GetWidth(); ++j)
+  double maxSurface = TaskPool::GetDefault().ParallelReduce(0, pic.GetHeight(), TaskPool::GetGrain(pic.GetWidth()), 0.0,
+    [&](size_t firstRow, size_t lastRow)
     {
-      auto surface = (layoutThisPict.GetSurfacePixel(CoordI(i,j)) + layoutArgPic.GetSurfacePixel(CoordI(i,j)))/2.0;
-      // std::cout << tmp.at<cv::Vec3d>(i, j) << " ; " << tmp.at<cv::Vec3d>(i, j) * surface << std::endl;
-      tmp.at<cv::Vec3d>(i, j) = tmp.at<cv::Vec3d>(i, j) * surface;
-      // std::cout << tmp.at<cv::Vec3d>(i, j) << std::endl;
-      totalSurface += surface;
-      maxSurface = std::max(maxSurface, surface);
-    }
-  }
+      double chunkMaxSurface = 0;
+      for (unsigned int i = firstRow; i < lastRow; ++i)
+      {
+        for (unsigned int j = 0; j < pic.GetWidth(); ++j)
+        {
+          auto surface = (layoutThisPict.GetSurfacePixel(CoordI(i,j)) + layoutArgPic.GetSurfacePixel(CoordI(i,j)))/2.0;
+          tmp.at<cv::Vec3d>(i, j) = tmp.at<cv::Vec3d>(i, j) * surface;
+          chunkMaxSurface = std::max(chunkMaxSurface, surface);
+        }
+      }
+      return chunkMaxSurface;
+    },
+    [](double a, double b) {return std::max(a, b);});
 
   auto mse = cv::mean(tmp).val[0] / maxSurface;
   return mse != 0 ? 10.0*std::log10(255*255/mse) : 100.0;
 }
 
-double Picture::GetSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic, InterpolationTech it) const
+
+cv::Mat Picture::SampleOnSphere(Layout& layoutThisPict, InterpolationTech it, unsigned long nbPoints, ScratchArena* arena) const
 {
-  cv::Mat vRef(nbOfUniformPointOneSphere, 1, m_pictMat.type());
-  cv::Mat vArg(nbOfUniformPointOneSphere, 1, m_pictMat.type());
-  #pragma omp parallel for shared(vRef, vArg, pic, layoutThisPict, layoutArgPic) schedule(dynamic)
-  for (unsigned long p = 0; p < nbOfUniformPointOneSphere; ++p)
+  cv::Mat vYUV = arena != nullptr ? arena->GetMat(nbPoints, 1, m_pictMat.type()) : cv::Mat();
+  auto pointSet = SpherePointSet::Get(nbPoints);
+  const VectorBatch& points = pointSet->GetCartesianPoints();
+  ScratchArena& scratch = ScratchArena::GetThreadLocal();
+  ScratchArena::Scope scope(scratch);
+  cv::Mat v = scratch.GetMat(nbPoints, 1, m_pictMat.type());
+  std::atomic<unsigned long> nbInterpolated(0);
+  //The points are mapped by chunks with the batch mapping of the layout
+  TaskPool::GetDefault().ParallelFor(0, nbPoints, TaskPool::GetGrain(1), [&](size_t start, size_t end)
   {
-    Coord3dSpherical pointOnTheSphere(1, uniformPointOneSphere[2*p + 1]*PI()/180.f, uniformPointOneSphere[2*p]*PI()/180.f +PI()/2);
-    CoordI pixelCoordOnRefPic = layoutThisPict.FromSphereTo2d(pointOnTheSphere);
-    CoordI pixelCoordOnArgPic = layoutArgPic.FromSphereTo2d(pointOnTheSphere);
-
-    if (inInterval(pixelCoordOnRefPic.x, 0, this->GetMat().cols) && inInterval(pixelCoordOnRefPic.y, 0,  this->GetMat().rows))
+    const unsigned long count = end-start;
+    unsigned long chunkNbInterpolated = 0;
+    std::vector<CoordF> coords(count);
+    layoutThisPict.FromSphereTo2dBatch(points, start, count, coords.data());
+    for (unsigned long k = 0; k < count; ++k)
     {
-      vRef.at<Pixel>(p, 0) = GetInterPixel(pixelCoordOnRefPic, it);
-    }
-    else
-    {
-      vRef.at<Pixel>(p, 0) = Pixel(0,0,0);
-    }
+      CoordI pixelCoord = coords[k];
+      unsigned long p = start+k;
 
-    if (inInterval(pixelCoordOnArgPic.x, 0, pic.GetMat().cols) && inInterval(pixelCoordOnArgPic.y, 0,  pic.GetMat().rows))
-    {
-      vArg.at<Pixel>(p, 0) = pic.GetInterPixel(pixelCoordOnArgPic, it);
-    }
-    else
-    {
-      vArg.at<Pixel>(p, 0) = Pixel(0,0,0);
+      if (inInterval(pixelCoord.x, 0, m_pictMat.cols) && inInterval(pixelCoord.y, 0,  m_pictMat.rows))
+      {
+        v.at<Pixel>(p, 0) = GetInterPixel(pixelCoord, it);
+        ++chunkNbInterpolated;
+      }
+      else
+      {
+        v.at<Pixel>(p, 0) = Pixel(0,0,0);
+      }
     }
-  }
+    nbInterpolated += chunkNbInterpolated;
+  });
+  Profiler::AddCount("samplesInterpolated", nbInterpolated);
 
-  cv::Mat s1;
-  cv::Mat vRefYUV;
-  cv::Mat vArgYUV;
-  cv::cvtColor(vRef, vRefYUV, cv::COLOR_BGR2YCrCb);
-  cv::cvtColor(vArg, vArgYUV, cv::COLOR_BGR2YCrCb);
+  cv::cvtColor(v, vYUV, cv::COLOR_BGR2YCrCb);
+  return vYUV;
+}
 
-  cv::absdiff(vRefYUV, vArgYUV, s1);
-  s1.convertTo(s1, CV_32F);
+double Picture::GetSPSNR(const cv::Mat& samplesRef, const cv::Mat& samplesArg)
+{
+  ScratchArena& scratch = ScratchArena::GetThreadLocal();
+  ScratchArena::Scope scope(scratch);
+  cv::Mat diff = scratch.GetMat(samplesRef.rows, samplesRef.cols, samplesRef.type());
+  cv::absdiff(samplesRef, samplesArg, diff);
+  cv::Mat s1 = scratch.GetMat(samplesRef.rows, samplesRef.cols, CV_32FC(samplesRef.channels()));
+  diff.convertTo(s1, CV_32F);
   s1 = s1.mul(s1);
 
   auto mse = cv::mean(s1).val[0]; //mean square error on componant Y
   return mse != 0 ? 10.0*std::log10((255*255)/mse) : 100.0;
 }
+
+double Picture::GetSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic, InterpolationTech it, unsigned long nbPoints) const
+{
+  ScratchArena& scratch = ScratchArena::GetThreadLocal();
+  ScratchArena::Scope scope(scratch);
+  return GetSPSNR(SampleOnSphere(layoutThisPict, it, nbPoints, &scratch), pic.SampleOnSphere(layoutArgPic, it, nbPoints, &scratch));
+}
@@ -0,0 +1,88 @@
+/**
+ * Pool of recycled picture buffers: the frames of a video all have the same few sizes, their buffers are reused from one frame to the next
+ */
+
+#include "PicturePool.hpp"
+
+using namespace IMT;
+
+size_t PicturePool::s_defaultMaxFreeBuffers = 16;
+
+PicturePool::PicturePool(size_t maxFreeBuffers): m_maxFreeBuffers(maxFreeBuffers), m_mutex(), m_freeBuffers(), m_nbAllocations(0)
+{
+}
+
+cv::Mat PicturePool::GetMat(int rows, int cols, int type)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_freeBuffers.find(BufferKey(rows, cols, type));
+    if (it != m_freeBuffers.end() && !it->second.empty())
+    {
+      cv::Mat mat = it->second.back();
+      it->second.pop_back();
+      return mat;
+    }
+  }
+  //the allocation is done by OpenCV: the buffer has the alignment of the OpenCV allocator
+  ++m_nbAllocations;
+  return cv::Mat(rows, cols, type);
+}
+
+std::shared_ptr<Picture> PicturePool::GetCopy(const cv::Mat& mat)
+{
+  cv::Mat copy = GetMat(mat.rows, mat.cols, mat.type());
+  mat.copyTo(copy);
+  return Adopt(std::move(copy));
+}
+
+std::shared_ptr<Picture> PicturePool::Adopt(cv::Mat mat)
+{
+  std::weak_ptr<PicturePool> weakPool = shared_from_this();
+  return std::shared_ptr<Picture>(new Picture(std::move(mat)), [weakPool](Picture* pict)
+  {
+    cv::Mat mat = pict->GetMat();
+    delete pict;
+    if (auto pool = weakPool.lock())
+    {
+      pool->Release(mat);
+    }
+  });
+}
+
+void PicturePool::Release(const cv::Mat& mat)
+{
+  //a buffer still referenced elsewhere (copy of the matrix header, sub-matrix) or not owned by OpenCV is never reused
+  if (mat.u == nullptr || mat.u->refcount != 1 || mat.data != mat.datastart || !mat.isContinuous())
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto& freeBuffers = m_freeBuffers[BufferKey(mat.rows, mat.cols, mat.type())];
+  if (freeBuffers.size() < m_maxFreeBuffers)
+  {
+    freeBuffers.push_back(mat);
+  }
+}
+
+size_t PicturePool::GetNbFreeBuffers(void) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t nbFreeBuffers = 0;
+  for (const auto& kv: m_freeBuffers)
+  {
+    nbFreeBuffers += kv.second.size();
+  }
+  return nbFreeBuffers;
+}
+
+void PicturePool::SetDefaultMaxFreeBuffers(size_t maxFreeBuffers)
+{
+  s_defaultMaxFreeBuffers = maxFreeBuffers;
+}
+
+std::shared_ptr<PicturePool> PicturePool::GetDefault(void)
+{
+  static std::shared_ptr<PicturePool> pool = std::make_shared<PicturePool>(s_defaultMaxFreeBuffers);
+  return pool;
+}
@@ -0,0 +1,239 @@
+/**
+ * Per frame timers and counters of the processing stages, written as a JSON or CSV profile at the end of a run
+ */
+
+#include "Profiler.hpp"
+
+#include <set>
+#include <algorithm>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "SlidingWindow.hpp"
+
+using namespace IMT;
+
+namespace
+{
+  thread_local int t_frameId = -1;
+  thread_local IMT::Profiler* t_profiler = nullptr;
+
+  const double c_percentiles[] = {50, 90, 99};
+
+  std::string QuoteJSON(const std::string& s)
+  {
+    std::string quoted = "\"";
+    for (auto c: s)
+    {
+      if (c == '"' || c == '\\')
+      {
+        quoted += '\\';
+      }
+      quoted += c;
+    }
+    return quoted + "\"";
+  }
+
+  /** Statistics over the frames of the values of a measure */
+  SlidingWindow Aggregate(const std::map<int, double>& values)
+  {
+    SlidingWindow window(std::max(size_t(1), values.size()));
+    for (const auto& kv: values)
+    {
+      window.Push(kv.second);
+    }
+    return window;
+  }
+
+  double Total(const std::map<int, double>& values)
+  {
+    double total = 0;
+    for (const auto& kv: values)
+    {
+      total += kv.second;
+    }
+    return total;
+  }
+}
+
+void Profiler::Add(Kind kind, int frameId, const std::string& name, double value)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  (kind == Kind::TIMER ? m_timers : m_counters)[name][frameId] += value;
+}
+
+double Profiler::GetTotal(Kind kind, const std::string& name) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto& measures = GetMeasures(kind);
+  auto it = measures.find(name);
+  return it == measures.end() ? 0 : Total(it->second);
+}
+
+void Profiler::Clear(void)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_timers.clear();
+  m_counters.clear();
+}
+
+void Profiler::WriteJSON(std::ostream& os) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto precision = os.precision(12);
+  const Kind kinds[] = {Kind::TIMER, Kind::COUNTER};
+  const char* kindNames[] = {"timers", "counters"};
+  std::set<int> frameIds;
+  for (auto kind: kinds)
+  {
+    for (const auto& measure: GetMeasures(kind))
+    {
+      for (const auto& kv: measure.second)
+      {
+        frameIds.insert(kv.first);
+      }
+    }
+  }
+  os << "{\n  \"frames\": [";
+  bool firstFrame = true;
+  for (auto frameId: frameIds)
+  {
+    os << (firstFrame ? "\n" : ",\n") << "    {\"frame\": " << frameId;
+    firstFrame = false;
+    for (unsigned int k = 0; k < 2; ++k)
+    {
+      os << ", " << QuoteJSON(kindNames[k]) << ": {";
+      bool first = true;
+      for (const auto& measure: GetMeasures(kinds[k]))
+      {
+        auto it = measure.second.find(frameId);
+        if (it != measure.second.end())
+        {
+          os << (first ? "" : ", ") << QuoteJSON(measure.first) << ": " << it->second;
+          first = false;
+        }
+      }
+      os << "}";
+    }
+    os << "}";
+  }
+  os << "\n  ],\n  \"summary\": {";
+  for (unsigned int k = 0; k < 2; ++k)
+  {
+    os << (k == 0 ? "\n" : ",\n") << "    " << QuoteJSON(kindNames[k]) << ": {";
+    bool first = true;
+    for (const auto& measure: GetMeasures(kinds[k]))
+    {
+      auto window = Aggregate(measure.second);
+      os << (first ? "\n" : ",\n") << "      " << QuoteJSON(measure.first) << ": {\"frames\": " << measure.second.size()
+         << ", \"total\": " << Total(measure.second) << ", \"mean\": " << window.GetMean() << ", \"min\": " << window.GetMin();
+      for (auto p: c_percentiles)
+      {
+        os << ", \"p" << p << "\": " << window.GetPercentile(p);
+      }
+      os << ", \"max\": " << window.GetMax() << "}";
+      first = false;
+    }
+    os << "\n    }";
+  }
+  os << "\n  }\n}" << std::endl;
+  os.precision(precision);
+}
+
+void Profiler::WriteCSV(std::ostream& framesOs, std::ostream& summaryOs) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto framesPrecision = framesOs.precision(12);
+  const auto summaryPrecision = summaryOs.precision(12);
+  const Kind kinds[] = {Kind::TIMER, Kind::COUNTER};
+  const char* kindNames[] = {"timer", "counter"};
+  framesOs << "frame kind name value" << std::endl;
+  summaryOs << "kind name frames total mean min";
+  for (auto p: c_percentiles)
+  {
+    summaryOs << " p" << p;
+  }
+  summaryOs << " max" << std::endl;
+  for (unsigned int k = 0; k < 2; ++k)
+  {
+    for (const auto& measure: GetMeasures(kinds[k]))
+    {
+      for (const auto& kv: measure.second)
+      {
+        framesOs << kv.first << " " << kindNames[k] << " " << measure.first << " " << kv.second << std::endl;
+      }
+      auto window = Aggregate(measure.second);
+      summaryOs << kindNames[k] << " " << measure.first << " " << measure.second.size() << " " << Total(measure.second)
+                << " " << window.GetMean() << " " << window.GetMin();
+      for (auto p: c_percentiles)
+      {
+        summaryOs << " " << window.GetPercentile(p);
+      }
+      summaryOs << " " << window.GetMax() << std::endl;
+    }
+  }
+  framesOs.precision(framesPrecision);
+  summaryOs.precision(summaryPrecision);
+}
+
+void Profiler::Write(const std::string& path) const
+{
+  const std::string jsonExtension = ".json";
+  if (path.size() >= jsonExtension.size() && path.compare(path.size()-jsonExtension.size(), jsonExtension.size(), jsonExtension) == 0)
+  {
+    std::ofstream output(path);
+    if (!output)
+    {
+      throw std::invalid_argument("Cannot open the profile output "+path);
+    }
+    WriteJSON(output);
+    return;
+  }
+  size_t lastindex = path.find_last_of(".");
+  std::string summaryPath = lastindex == std::string::npos || lastindex < path.find_last_of("/") + 1 ?
+    path+"_summary" : path.substr(0, lastindex)+"_summary"+path.substr(lastindex);
+  std::ofstream framesOutput(path);
+  std::ofstream summaryOutput(summaryPath);
+  if (!framesOutput || !summaryOutput)
+  {
+    throw std::invalid_argument("Cannot open the profile outputs "+path+" and "+summaryPath);
+  }
+  WriteCSV(framesOutput, summaryOutput);
+}
+
+std::pair<int, Profiler*> Profiler::SetCurrent(int frameId, Profiler* profiler)
+{
+  auto previous = std::make_pair(t_frameId, t_profiler);
+  t_frameId = frameId;
+  t_profiler = profiler;
+  return previous;
+}
+
+Profiler& Profiler::GetDefault(void)
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler& Profiler::GetCurrent(void)
+{
+  return t_profiler != nullptr ? *t_profiler : GetDefault();
+}
+
+void Profiler::AddTime(const std::string& name, double seconds)
+{
+  if (t_frameId >= 0 && GetCurrent().IsEnabled())
+  {
+    GetCurrent().Add(Kind::TIMER, t_frameId, name, seconds);
+  }
+}
+
+void Profiler::AddCount(const std::string& name, double value)
+{
+  if (t_frameId >= 0 && GetCurrent().IsEnabled())
+  {
+    GetCurrent().Add(Kind::COUNTER, t_frameId, name, value);
+  }
+}
@@ -0,0 +1,108 @@
+/**
+ * Online sliding-window aggregation of the per-frame quality measures
+ */
+
+#include "QualityWindowAggregator.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+using namespace IMT;
+
+QualityWindowAggregator::QualityWindowAggregator(std::string pathToOutput, std::vector<std::string> metricNames, std::vector<double> windowDurations, std::vector<unsigned int> windowSizes, std::vector<double> percentiles, OutputFormat format):
+  m_metricNames(std::move(metricNames)), m_windowDurations(std::move(windowDurations)), m_percentiles(std::move(percentiles)), m_format(format),
+  m_output(pathToOutput, format == OutputFormat::BINARY ? std::ios::out | std::ios::binary : std::ios::out), m_windows()
+{
+  if (!m_output.is_open())
+  {
+    throw std::invalid_argument("Cannot open the quality window output file "+pathToOutput);
+  }
+  if (m_windowDurations.size() != windowSizes.size())
+  {
+    throw std::invalid_argument("Quality window aggregation require one size per window duration");
+  }
+  for (auto ws: windowSizes)
+  {
+    for (unsigned int m = 0; m < m_metricNames.size(); ++m)
+    {
+      m_windows.emplace_back(ws);
+    }
+  }
+  WriteHeader();
+}
+
+void QualityWindowAggregator::WriteHeader(void)
+{
+  if (m_format == OutputFormat::CSV)
+  {
+    m_output << "frame,window,metric,mean,min,max";
+    for (auto p: m_percentiles)
+    {
+      m_output << ",p" << p;
+    }
+    m_output << std::endl;
+  }
+  else
+  {
+    m_output.write("QWIN", 4);
+    WriteBinary(std::uint32_t(1));
+    WriteBinary(std::uint32_t(m_metricNames.size()));
+    WriteBinary(std::uint32_t(m_windowDurations.size()));
+    WriteBinary(std::uint32_t(m_percentiles.size()));
+    for (const auto& name: m_metricNames)
+    {
+      WriteBinary(std::uint32_t(name.size()));
+      m_output.write(name.data(), name.size());
+    }
+    for (auto d: m_windowDurations)
+    {
+      WriteBinary(d);
+    }
+    for (auto p: m_percentiles)
+    {
+      WriteBinary(p);
+    }
+  }
+}
+
+void QualityWindowAggregator::AddFrame(unsigned int frameId, const std::vector<double>& metricValues)
+{
+  const unsigned int nbMetrics = m_metricNames.size();
+  if (metricValues.size() != nbMetrics)
+  {
+    throw std::invalid_argument("Quality window aggregation require one value per metric");
+  }
+  for (unsigned int w = 0; w < m_windowDurations.size(); ++w)
+  {
+    for (unsigned int m = 0; m < nbMetrics; ++m)
+    {
+      auto& window = m_windows[w*nbMetrics + m];
+      if (!window.Push(metricValues[m]) || !window.IsFull())
+      {//Only complete windows are written, and only when they receive a new (finite) value
+        continue;
+      }
+      if (m_format == OutputFormat::CSV)
+      {
+        m_output << frameId << "," << m_windowDurations[w] << "," << m_metricNames[m] << "," << window.GetMean() << "," << window.GetMin() << "," << window.GetMax();
+        for (auto p: m_percentiles)
+        {
+          m_output << "," << window.GetPercentile(p);
+        }
+        m_output << "\n";
+      }
+      else
+      {
+        WriteBinary(std::uint32_t(frameId));
+        WriteBinary(std::uint32_t(w));
+        WriteBinary(std::uint32_t(m));
+        WriteBinary(window.GetMean());
+        WriteBinary(window.GetMin());
+        WriteBinary(window.GetMax());
+        for (auto p: m_percentiles)
+        {
+          WriteBinary(window.GetPercentile(p));
+        }
+      }
+    }
+  }
+}
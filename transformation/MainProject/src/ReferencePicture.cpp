@@ -0,0 +1,88 @@
+/**
+ * Reference picture whose preprocessing is computed once per frame and shared by all the tested flows
+ */
+
+#include "ReferencePicture.hpp"
+#include "ScratchArena.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace IMT;
+
+void ReferencePicture::CheckSize(const Picture& pic, const std::string& measure) const
+{
+  if (pic.GetHeight()!= m_pict->GetHeight() && pic.GetWidth() != m_pict->GetWidth())
+  {
+    throw std::invalid_argument(measure+" computation require pictures to have the same width and height");
+  }
+}
+
+double ReferencePicture::GetPSNR(const Picture& pic) const
+{
+  CheckSize(pic, "MSE");
+  cv::Mat luma;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_luma.empty())
+    {
+      m_luma = Picture::GetLumaPlane(m_pict->GetMat());
+    }
+    luma = m_luma;
+  }
+  ScratchArena& scratch = ScratchArena::GetThreadLocal();
+  ScratchArena::Scope scope(scratch);
+  auto mse = Picture::GetMSE(luma, Picture::GetLumaPlane(pic.GetMat(), &scratch));
+  return mse != 0 ? 10.0*std::log10((255*255)/mse) : 100.0;
+}
+
+double ReferencePicture::GetSSIM(const Picture& pic) const
+{
+  CheckSize(pic, "SSIM");
+  std::shared_ptr<Picture::SSIMMoments> moments;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_ssimMoments == nullptr)
+    {
+      m_ssimMoments = std::make_shared<Picture::SSIMMoments>(Picture::ComputeSSIMMoments(m_pict->GetMat()));
+    }
+    moments = m_ssimMoments;
+  }
+  ScratchArena& scratch = ScratchArena::GetThreadLocal();
+  ScratchArena::Scope scope(scratch);
+  return std::get<0>(Picture::ComputeSSIM(*moments, Picture::ComputeSSIMMoments(pic.GetMat(), &scratch)));
+}
+
+double ReferencePicture::GetMSSSIM(const Picture& pic) const
+{
+  CheckSize(pic, "MS-SSIM");
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_msssimPyramid.empty())
+    {
+      m_msssimPyramid = m_pict->ComputeMSSSIMPyramid();
+    }
+  }
+  //the pyramid is never modified once computed
+  ScratchArena& scratch = ScratchArena::GetThreadLocal();
+  ScratchArena::Scope scope(scratch);
+  return Picture::ComputeMSSSIM(m_msssimPyramid, pic.ComputeMSSSIMPyramid(&scratch));
+}
+
+double ReferencePicture::GetSPSNR(const Picture& pic, Layout& layoutThisPict, Layout& layoutArgPic, Picture::InterpolationTech it, unsigned long nbPoints) const
+{
+  cv::Mat samplesRef;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto key = std::make_tuple(static_cast<const Layout*>(&layoutThisPict), static_cast<int>(it), nbPoints);
+    auto cached = m_sphereSamples.find(key);
+    if (cached == m_sphereSamples.end())
+    {
+      cached = m_sphereSamples.emplace(key, m_pict->SampleOnSphere(layoutThisPict, it, nbPoints)).first;
+    }
+    samplesRef = cached->second;
+  }
+  ScratchArena& scratch = ScratchArena::GetThreadLocal();
+  ScratchArena::Scope scope(scratch);
+  return Picture::GetSPSNR(samplesRef, pic.SampleOnSphere(layoutArgPic, it, nbPoints, &scratch));
+}
@@ -0,0 +1,54 @@
+/**
+ * Per thread arena of reusable matrices for the temporaries of the quality measures
+ */
+
+#include "ScratchArena.hpp"
+
+#include <utility>
+
+using namespace IMT;
+
+constexpr size_t ScratchArena::m_maxFreeSlots;
+
+cv::Mat ScratchArena::GetMat(int rows, int cols, int type)
+{
+  //look for a free slot of the right size: the same sequence of temporaries is requested for each frame
+  size_t slot = m_slots.size();
+  for (size_t k = m_nbUsed; k < m_slots.size(); ++k)
+  {
+    if (m_slots[k].rows == rows && m_slots[k].cols == cols && m_slots[k].type() == type)
+    {
+      slot = k;
+      break;
+    }
+  }
+  if (slot == m_slots.size())
+  {
+    if (m_slots.size()-m_nbUsed >= m_maxFreeSlots)
+    {//too many free slots of other sizes: one of them is reallocated
+      slot = m_nbUsed;
+    }
+    else
+    {
+      m_slots.emplace_back();
+    }
+  }
+  std::swap(m_slots[slot], m_slots[m_nbUsed]);
+  cv::Mat& mat = m_slots[m_nbUsed++];
+  if (mat.u != nullptr && mat.u->refcount != 1)
+  {//a previous user kept a reference to the buffer after the end of its scope: it cannot be overwritten
+    mat = cv::Mat();
+  }
+  if (mat.empty() || mat.rows != rows || mat.cols != cols || mat.type() != type)
+  {
+    mat.create(rows, cols, type);
+    ++m_nbAllocations;
+  }
+  return mat;
+}
+
+ScratchArena& ScratchArena::GetThreadLocal(void)
+{
+  thread_local ScratchArena arena;
+  return arena;
+}
@@ -0,0 +1,110 @@
+/**
+ * Set of points uniformly distributed on the unit sphere (Fibonacci lattice) generated at runtime
+ */
+
+#include "SpherePointSet.hpp"
+
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace IMT;
+
+constexpr unsigned long SpherePointSet::DefaultNbPoints;
+
+namespace {
+std::mutex s_mutex;
+std::map<unsigned long, std::shared_ptr<const SpherePointSet>> s_loadedPointSets;
+std::string s_cacheDirectory;
+}
+
+SpherePointSet::SpherePointSet(unsigned long nbPoints): m_theta(nbPoints), m_phi(nbPoints), m_points()
+{
+  if (nbPoints == 0)
+  {
+    throw std::invalid_argument("A sphere point set require at least one point");
+  }
+  //Fibonacci lattice: the points are on a spiral with a constant step in z and a golden angle step in longitude
+  const double goldenAngle = PI()*(3.0-std::sqrt(5.0));
+  for (unsigned long p = 0; p < nbPoints; ++p)
+  {
+    double z = 1.0 - (2.0*p+1.0)/nbPoints;
+    double theta = std::fmod(goldenAngle*p, 2*PI());
+    m_theta[p] = theta > PI() ? theta - 2*PI() : theta;
+    m_phi[p] = std::acos(z);
+  }
+  m_points = VectorBatch::FromSpherical(m_theta, m_phi);
+}
+
+void SpherePointSet::SetCacheDirectory(std::string cacheDirectory)
+{
+  std::lock_guard<std::mutex> lock(s_mutex);
+  s_cacheDirectory = std::move(cacheDirectory);
+}
+
+std::shared_ptr<const SpherePointSet> SpherePointSet::Get(unsigned long nbPoints)
+{
+  std::lock_guard<std::mutex> lock(s_mutex);
+  auto it = s_loadedPointSets.find(nbPoints);
+  if (it != s_loadedPointSets.end())
+  {
+    return it->second;
+  }
+  std::shared_ptr<const SpherePointSet> pointSet(nullptr);
+  std::string path;
+  if (!s_cacheDirectory.empty())
+  {
+    path = s_cacheDirectory+"/sphereFibonacci_"+std::to_string(nbPoints)+".bin";
+    pointSet = ReadFromCache(path, nbPoints);
+  }
+  if (pointSet == nullptr)
+  {
+    auto generated = std::make_shared<SpherePointSet>(nbPoints);
+    if (!path.empty())
+    {
+      generated->WriteToCache(path);
+    }
+    pointSet = generated;
+  }
+  s_loadedPointSets[nbPoints] = pointSet;
+  return pointSet;
+}
+
+std::shared_ptr<const SpherePointSet> SpherePointSet::ReadFromCache(const std::string& path, unsigned long nbPoints)
+{
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs.is_open())
+  {
+    return nullptr;
+  }
+  std::uint64_t nbPointsInFile(0);
+  ifs.read(reinterpret_cast<char*>(&nbPointsInFile), sizeof(nbPointsInFile));
+  if (!ifs || nbPointsInFile != nbPoints)
+  {
+    return nullptr;
+  }
+  std::vector<double> theta(nbPoints);
+  std::vector<double> phi(nbPoints);
+  ifs.read(reinterpret_cast<char*>(theta.data()), nbPoints*sizeof(double));
+  ifs.read(reinterpret_cast<char*>(phi.data()), nbPoints*sizeof(double));
+  if (!ifs)
+  {
+    return nullptr;
+  }
+  return std::shared_ptr<const SpherePointSet>(new SpherePointSet(std::move(theta), std::move(phi)));
+}
+
+void SpherePointSet::WriteToCache(const std::string& path) const
+{
+  std::ofstream ofs(path, std::ios::binary);
+  if (!ofs.is_open())
+  {
+    return;
+  }
+  std::uint64_t nbPoints = GetNbPoints();
+  ofs.write(reinterpret_cast<const char*>(&nbPoints), sizeof(nbPoints));
+  ofs.write(reinterpret_cast<const char*>(m_theta.data()), nbPoints*sizeof(double));
+  ofs.write(reinterpret_cast<const char*>(m_phi.data()), nbPoints*sizeof(double));
+}
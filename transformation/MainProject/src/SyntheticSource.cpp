@@ -0,0 +1,84 @@
+/**
+ * Procedurally generated input frames, used instead of the input videos to measure the throughput of the projections
+ */
+
+#include "SyntheticSource.hpp"
+#include "PicturePool.hpp"
+
+#include <stdexcept>
+
+using namespace IMT;
+
+namespace
+{
+  //horizontal move of the pattern between two frames (in pixel): the frames are different but cost nothing to generate
+  constexpr int c_shiftPerFrame = 8;
+  constexpr int c_checkerboardSquare = 64;
+}
+
+SyntheticSource::SyntheticSource(Content content, unsigned int width, unsigned int height): m_pattern(height, width, CV_8UC3)
+{
+  if (width == 0 || height == 0)
+  {
+    throw std::invalid_argument("Synthetic input with an empty resolution "+std::to_string(width)+"x"+std::to_string(height));
+  }
+  switch (content)
+  {
+    case Content::GRADIENT:
+      for (int j = 0; j < m_pattern.rows; ++j)
+      {
+        for (int i = 0; i < m_pattern.cols; ++i)
+        {
+          m_pattern.at<Pixel>(j, i) = Pixel(255*i/m_pattern.cols, 255*j/m_pattern.rows, 255-255*(i+j)/(m_pattern.cols+m_pattern.rows));
+        }
+      }
+      break;
+    case Content::CHECKERBOARD:
+      for (int j = 0; j < m_pattern.rows; ++j)
+      {
+        for (int i = 0; i < m_pattern.cols; ++i)
+        {
+          unsigned char v = ((i/c_checkerboardSquare + j/c_checkerboardSquare)%2 == 0) ? 255 : 0;
+          m_pattern.at<Pixel>(j, i) = Pixel(v, v, v);
+        }
+      }
+      break;
+    case Content::NOISE:
+    {
+      //fixed seed of a local generator: two runs of the benchmark process the same frames and the global OpenCV generator is left untouched
+      cv::RNG rng(0x1234);
+      rng.fill(m_pattern, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+      break;
+    }
+  }
+}
+
+std::shared_ptr<Picture> SyntheticSource::GetFrame(int frameId) const
+{
+  const int shift = (frameId*c_shiftPerFrame)%m_pattern.cols;
+  cv::Mat mat = PicturePool::GetDefault()->GetMat(m_pattern.rows, m_pattern.cols, m_pattern.type());
+  //circular shift: the last shift columns of the pattern go to the left of the frame
+  if (shift != 0)
+  {
+    m_pattern.colRange(m_pattern.cols-shift, m_pattern.cols).copyTo(mat.colRange(0, shift));
+  }
+  m_pattern.colRange(0, m_pattern.cols-shift).copyTo(mat.colRange(shift, m_pattern.cols));
+  return PicturePool::GetDefault()->Adopt(std::move(mat));
+}
+
+SyntheticSource::Content SyntheticSource::ParseContent(const std::string& contentName)
+{
+  if (contentName == "gradient")
+  {
+    return Content::GRADIENT;
+  }
+  if (contentName == "checkerboard")
+  {
+    return Content::CHECKERBOARD;
+  }
+  if (contentName == "noise")
+  {
+    return Content::NOISE;
+  }
+  throw std::invalid_argument("Synthetic content "+contentName+" not recognized (gradient, checkerboard or noise)");
+}
@@ -0,0 +1,250 @@
+/**
+ * Persistent thread pool with work stealing, shared by the parallel loops of the program
+ */
+
+#include "TaskPool.hpp"
+
+#include <exception>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace IMT;
+
+namespace
+{
+  //pool and queue index of the current thread if it is a worker
+  thread_local TaskPool* t_pool = nullptr;
+  thread_local unsigned int t_workerId = 0;
+
+  struct LoopState
+  {
+    LoopState(size_t begin, size_t end, size_t grain, const TaskPool::RangeFunction& body):
+      m_body(body), m_begin(begin), m_end(end), m_grain(grain), m_nbChunks((end-begin+grain-1)/grain),
+      m_nextChunk(0), m_failed(false), m_mutex(), m_allDone(), m_nbDoneChunks(0), m_error(nullptr) {}
+    const TaskPool::RangeFunction m_body;
+    const size_t m_begin;
+    const size_t m_end;
+    const size_t m_grain;
+    const size_t m_nbChunks;
+    std::atomic<size_t> m_nextChunk;
+    std::atomic<bool> m_failed;
+    std::mutex m_mutex;
+    std::condition_variable m_allDone;
+    size_t m_nbDoneChunks;
+    std::exception_ptr m_error;
+
+    /** Process the chunks until there is none left. Once all the chunks are claimed, the state is not used anymore by the calling thread of ParallelFor */
+    void RunChunks(void)
+    {
+      size_t chunk;
+      while ((chunk = m_nextChunk++) < m_nbChunks)
+      {
+        if (!m_failed)
+        {
+          try
+          {
+            const size_t first = m_begin+chunk*m_grain;
+            m_body(first, std::min(first+m_grain, m_end));
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_error == nullptr)
+            {
+              m_error = std::current_exception();
+            }
+            m_failed = true;
+          }
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (++m_nbDoneChunks == m_nbChunks)
+        {
+          m_allDone.notify_all();
+        }
+      }
+    }
+  };
+}
+
+unsigned int TaskPool::s_defaultNbThreads = 0;
+bool TaskPool::s_defaultPinThreads = false;
+size_t TaskPool::s_defaultGrainSize = 4096;
+
+TaskPool::TaskPool(unsigned int nbThreads, bool pinThreads): m_queues(), m_workers(), m_mutex(), m_hasTask(), m_nbPendingTasks(0), m_nextQueue(0), m_stop(false),
+  m_nbUnpinnedWorkers(0), m_nbFailedTasks(0)
+{
+  if (nbThreads == 0)
+  {
+    nbThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (unsigned int i = 0; i < nbThreads; ++i)
+  {
+    m_queues.emplace_back(new WorkerQueue());
+  }
+  for (unsigned int i = 0; i < nbThreads; ++i)
+  {
+    m_workers.emplace_back(&TaskPool::WorkerLoop, this, i);
+  }
+  if (pinThreads)
+  {
+#ifdef __linux__
+    const unsigned int nbCpus = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < nbThreads; ++i)
+    {
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      CPU_SET(i % nbCpus, &cpuSet);
+      if (pthread_setaffinity_np(m_workers[i].native_handle(), sizeof(cpu_set_t), &cpuSet) != 0)
+      {
+        ++m_nbUnpinnedWorkers;
+      }
+    }
+#else
+    m_nbUnpinnedWorkers = nbThreads;
+#endif
+  }
+}
+
+TaskPool::~TaskPool(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_hasTask.notify_all();
+  }
+  for (auto& w: m_workers)
+  {
+    w.join();
+  }
+}
+
+void TaskPool::Submit(Task task)
+{
+  const unsigned int queueId = t_pool == this ? t_workerId : (m_nextQueue++ % m_queues.size());
+  {
+    std::lock_guard<std::mutex> lock(m_queues[queueId]->m_mutex);
+    m_queues[queueId]->m_tasks.push_back(std::move(task));
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_nbPendingTasks;
+  m_hasTask.notify_one();
+}
+
+bool TaskPool::TakeTask(unsigned int workerId, Task& task)
+{
+  {
+    WorkerQueue& own = *m_queues[workerId];
+    std::lock_guard<std::mutex> lock(own.m_mutex);
+    if (!own.m_tasks.empty())
+    {
+      task = std::move(own.m_tasks.back());
+      own.m_tasks.pop_back();
+      --m_nbPendingTasks;
+      return true;
+    }
+  }
+  for (size_t k = 1; k < m_queues.size(); ++k)
+  {
+    WorkerQueue& victim = *m_queues[(workerId+k) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(victim.m_mutex);
+    if (!victim.m_tasks.empty())
+    {
+      task = std::move(victim.m_tasks.front());
+      victim.m_tasks.pop_front();
+      --m_nbPendingTasks;
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskPool::WorkerLoop(unsigned int workerId)
+{
+  t_pool = this;
+  t_workerId = workerId;
+  while (true)
+  {
+    Task task;
+    if (TakeTask(workerId, task))
+    {
+      try
+      {
+        task();
+      }
+      catch (...)
+      {
+        ++m_nbFailedTasks;
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_hasTask.wait(lock, [this]{return m_stop || m_nbPendingTasks > 0;});
+    if (m_stop)
+    {
+      return;
+    }
+  }
+}
+
+void TaskPool::ParallelFor(size_t begin, size_t end, size_t grain, const RangeFunction& body, unsigned int maxThreads)
+{
+  if (begin >= end)
+  {
+    return;
+  }
+  grain = std::max(grain, size_t(1));
+  const size_t nbChunks = (end-begin+grain-1)/grain;
+  size_t nbThreads = std::min(nbChunks, size_t(m_workers.size()+1));
+  if (maxThreads != 0)
+  {
+    nbThreads = std::min(nbThreads, size_t(maxThreads));
+  }
+  if (nbThreads <= 1)
+  {
+    body(begin, end);
+    return;
+  }
+  //the helpers keep the state alive: a helper that starts after the end of the loop finds no chunk left and returns
+  auto state = std::make_shared<LoopState>(begin, end, grain, body);
+  for (size_t i = 1; i < nbThreads; ++i)
+  {
+    Submit([state]{state->RunChunks();});
+  }
+  state->RunChunks();
+  std::unique_lock<std::mutex> lock(state->m_mutex);
+  state->m_allDone.wait(lock, [&state]{return state->m_nbDoneChunks == state->m_nbChunks;});
+  if (state->m_error != nullptr)
+  {
+    std::rethrow_exception(state->m_error);
+  }
+}
+
+void TaskPool::SetDefaultNbThreads(unsigned int nbThreads)
+{
+  s_defaultNbThreads = nbThreads;
+}
+
+void TaskPool::SetDefaultThreadPinning(bool pinThreads)
+{
+  s_defaultPinThreads = pinThreads;
+}
+
+void TaskPool::SetDefaultGrainSize(size_t grainSize)
+{
+  s_defaultGrainSize = grainSize;
+}
+
+size_t TaskPool::GetGrain(size_t itemSize)
+{
+  return std::max(size_t(1), s_defaultGrainSize/std::max(itemSize, size_t(1)));
+}
+
+TaskPool& TaskPool::GetDefault(void)
+{
+  static TaskPool pool(s_defaultNbThreads, s_defaultPinThreads);
+  return pool;
+}
@@ -0,0 +1,1026 @@
+/**
+ * One transformation job: the flows, the input and output videos and the quality measures described by a configuration (same keys as the ini file)
+ */
+
+#include "TransJob.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <exception>
+
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/foreach.hpp>
+
+#include <opencv2/opencv.hpp>
+
+#include "ReferencePicture.hpp"
+#include "ConfigParser.hpp"
+#include "TaskPool.hpp"
+#include "PicturePool.hpp"
+#include "Profiler.hpp"
+#include "VideoWriter.hpp"
+#include "VideoReader.hpp"
+
+#define DEBUG 0
+#if DEBUG
+#define PRINT_DEBUG(x) {std::ostringstream line; line << x; Log(line.str());}
+#else
+#define PRINT_DEBUG(x) {}
+#endif // DEBUG
+
+using namespace IMT;
+namespace pt = boost::property_tree;
+
+TransJob::TransJob(const Config& config, std::ostream* log, bool configureProcess) try: m_config(config), m_nullLog(nullptr), m_log(log != nullptr ? *log : m_nullLog),
+  m_layoutFlowSections(), m_layoutFlowVect(), m_qualityNames(), m_pathToOutputVideo(), m_pathToOutputQuality(), m_processingStep(1), m_displayFinalPict(false),
+  m_nbFrames(0), m_startFrame(0), m_fps(0), m_spsnrNbPoints(SpherePointSet::DefaultNbPoints), m_pathToProfile(), m_profiler(std::make_shared<Profiler>()), m_useSyntheticInput(false),
+  m_pipelineQueueSize(2), m_hasDynamicFinalLayout(false), m_isInputSeeked(false), m_shardVect(), m_syntheticSourceVect(), m_multiViewportQuality(nullptr), m_qualityWriterVect(),
+  m_faceQualityMapVect(), m_faceQualityWriterVect(), m_qualityWindowVect(), m_qualityCallback(), m_outputCallback(), m_nbProcessedFrames(0),
+  m_lastEndTime(), m_averageDuration(0)
+{
+  std::vector<std::string> pathToInputVideos; //contains the path to the input videos. index i from layoutFlow i
+  //Parse the layoutFlow line from the configuration configuration file
+  try {
+    pt::ptree ptree_json;
+    std::stringstream ss(m_config.get<std::string>("Global.layoutFlow"));
+    pt::json_parser::read_json(ss, ptree_json);
+    BOOST_FOREACH(boost::property_tree::ptree::value_type &v, ptree_json.get_child(""))
+    {
+        std::vector<std::string> lfsv;
+        bool first = true;
+        BOOST_FOREACH(boost::property_tree::ptree::value_type & u, v.second)
+        {
+            if (first)
+            {
+                first = false;
+                pathToInputVideos.push_back(u.second.data());
+            }
+            else
+            {
+                lfsv.push_back(u.second.data());
+            }
+        }
+        if (lfsv.size()>0)
+        {
+            m_layoutFlowSections.push_back(std::move(lfsv));
+        }
+    }
+  }
+  catch (std::exception &e)
+  {
+      throw std::invalid_argument(std::string("Error while parsing the Global.layoutFlow: ")+e.what());
+  }
+
+  //Name of the computed metrics, in the order they are written in the quality files
+  auto qualityToCompute = GetJSONList("Global.qualityToComputeList");
+  for (auto qualityName: {"MS-SSIM", "SSIM", "PSNR", "S-PSNR-NN", "S-PSNR-I", "WS-PSNR"})
+  {
+      if (std::find(qualityToCompute.begin(), qualityToCompute.end(), qualityName) != qualityToCompute.end())
+      {
+          m_qualityNames.push_back(qualityName);
+      }
+  }
+
+  //Parse the rest of the Global Section from the configuration file
+  m_pathToOutputVideo = m_config.get<std::string>("Global.videoOutputName");
+  auto outputVideoCodecOpt = m_config.get_optional<std::string>("Global.videoOutputCodec");
+  std::string outputVideoCodec = "libx265";
+  if (outputVideoCodecOpt && outputVideoCodecOpt.get().size() > 0)
+  {
+    outputVideoCodec = outputVideoCodecOpt.get();
+  }
+  auto processingStepOpt = m_config.get_optional<int>("Global.processingStep");
+  if (processingStepOpt && processingStepOpt.get() > 1)
+  {
+      m_processingStep = processingStepOpt.get();
+  }
+  std::string pathToOutputQuality = m_config.get<std::string>("Global.qualityOutputName");
+  m_pathToOutputQuality = pathToOutputQuality;
+  m_displayFinalPict = m_config.get<bool>("Global.displayFinalPict");
+  m_nbFrames = m_config.get<unsigned int>("Global.nbFrames");
+  m_startFrame = m_config.get<unsigned int>("Global.startFrame");
+  auto videoOutputBitRate = m_config.get<unsigned int>("Global.videoOutputBitRate")*1000;
+  m_fps = m_config.get<double>("Global.fps");
+  auto interpolTechOpt = m_config.get_optional<std::string>("Global.interpolation");
+  Picture::InterpolationTech interpol = Picture::InterpolationTech::BILINEAR;
+  if (interpolTechOpt && interpolTechOpt.get().size() > 0)
+  {
+    if (interpolTechOpt.get() == "NEAREST_NEIGHTBOOR")
+    {
+        interpol = Picture::InterpolationTech::NEAREST_NEIGHTBOOR;
+    }
+    else if (interpolTechOpt.get() == "BILINEAR")
+    {
+        interpol = Picture::InterpolationTech::BILINEAR;
+    }
+    else if (interpolTechOpt.get() == "BICUBIC")
+    {
+        interpol = Picture::InterpolationTech::BICUBIC;
+    }
+    else
+    {
+        m_log << "Interpolation " << interpolTechOpt.get() << " not recognized; BILINEAR interpolation will be used instead" << std::endl;
+    }
+  }
+
+  //Scalar type of the geometry used to map the pixels from one layout to the next one
+  auto geometryPrecisionOpt = m_config.get_optional<std::string>("Global.geometryPrecision");
+  Layout::GeometryPrecision geometryPrecision = Layout::GeometryPrecision::Double;
+  if (geometryPrecisionOpt && geometryPrecisionOpt.get().size() > 0)
+  {
+    if (geometryPrecisionOpt.get() == "float32")
+    {
+        geometryPrecision = Layout::GeometryPrecision::Float32;
+    }
+    else if (geometryPrecisionOpt.get() != "double")
+    {
+        m_log << "Geometry precision " << geometryPrecisionOpt.get() << " not recognized; double precision will be used instead" << std::endl;
+    }
+  }
+
+  //Trigonometry used by the projections: standard library or polynomial approximations (FastMath.hpp)
+  auto mathModeOpt = m_config.get_optional<std::string>("Global.mathMode");
+  MathMode mathMode = MathMode::Exact;
+  if (mathModeOpt && mathModeOpt.get().size() > 0)
+  {
+    if (mathModeOpt.get() == "fast")
+    {
+        mathMode = MathMode::Fast;
+    }
+    else if (mathModeOpt.get() != "exact")
+    {
+        m_log << "Math mode " << mathModeOpt.get() << " not recognized; exact math will be used instead" << std::endl;
+    }
+  }
+
+  //Task pool, codec threads and picture pool: has to be configured before the first layout is initialised
+  if (configureProcess)
+  {
+    ConfigureProcess(m_config);
+  }
+  m_log << "Task pool: " << TaskPool::GetDefault().GetNbThreads() << " thread(s)" << std::endl;
+  if (TaskPool::GetDefault().GetNbUnpinnedWorkers() > 0)
+  {
+    m_log << "Task pool: " << TaskPool::GetDefault().GetNbUnpinnedWorkers() << " thread(s) could not be pinned to their CPU" << std::endl;
+  }
+  //Per frame timers and counters of the processing stages (disabled if empty)
+  auto profileOutputOpt = m_config.get_optional<std::string>("Global.profileOutput");
+  m_pathToProfile = profileOutputOpt ? profileOutputOpt.get() : "";
+  //Procedurally generated input frames instead of the input videos and no encoding: throughput benchmark of the flows (disabled if empty)
+  auto syntheticInputOpt = m_config.get_optional<std::string>("Global.syntheticInput");
+  m_useSyntheticInput = syntheticInputOpt && syntheticInputOpt.get().size() > 0;
+  SyntheticSource::Content syntheticContent = SyntheticSource::Content::GRADIENT;
+  if (m_useSyntheticInput)
+  {//throw std::invalid_argument (with the valid names) if the content is unknown
+    syntheticContent = SyntheticSource::ParseContent(syntheticInputOpt.get());
+  }
+  //the throughput of the synthetic benchmark is computed from the stage timers
+  m_profiler->SetEnabled(!m_pathToProfile.empty() || m_useSyntheticInput);
+
+  //Maximum number of threads of the shared task pool used by the projections of each flow (0 or missing: no limit)
+  std::vector<unsigned int> flowMaxThreads(m_layoutFlowSections.size(), 0);
+  auto flowMaxThreadsList = GetJSONList("Global.flowMaxThreads");
+  for (unsigned int flowId = 0; flowId < flowMaxThreadsList.size() && flowId < flowMaxThreads.size(); ++flowId)
+  {
+      flowMaxThreads[flowId] = std::stoul(flowMaxThreadsList[flowId]);
+  }
+
+  //Density of the uniform sampling of the sphere used by the S-PSNR
+  auto spsnrNbPointsOpt = m_config.get_optional<unsigned long>("Global.spsnrNbPoints");
+  if (spsnrNbPointsOpt && spsnrNbPointsOpt.get() > 0)
+  {
+      m_spsnrNbPoints = spsnrNbPointsOpt.get();
+  }
+  auto spherePointCacheOpt = m_config.get_optional<std::string>("Global.spherePointCacheDirectory");
+  if (spherePointCacheOpt && spherePointCacheOpt.get().size() > 0)
+  {
+      SpherePointSet::SetCacheDirectory(spherePointCacheOpt.get());
+  }
+
+  //Parse the optional multi-viewport quality evaluation (one viewport per head position trace)
+  auto pathToViewportTraces = GetJSONList("Global.viewportTraces");
+  if (!pathToViewportTraces.empty())
+  {
+      std::string viewportSection = m_config.get<std::string>("Global.viewportLayout");
+      std::string pathToViewportQuality = m_config.get<std::string>("Global.viewportQualityOutputName");
+      m_log << "Viewport quality path for " << pathToViewportTraces.size() << " users: " << pathToViewportQuality << std::endl;
+      m_multiViewportQuality = std::make_shared<MultiViewportQuality>(pathToViewportTraces, InitialiseViewportGeometry(viewportSection, m_config), pathToViewportQuality, interpol);
+  }
+
+  //Populate the m_layoutFlowVect. Will read the configuration file to get information about each layout named in the LayoutFlowSections
+  unsigned j = 0;
+  for(auto& lfsv: m_layoutFlowSections)
+  {
+      LayoutStatus layoutStatus = LayoutStatus::Input;
+      m_layoutFlowVect.push_back(std::vector<std::shared_ptr<Layout>>());
+      CoordI refResolution ( 0, 0 );
+      unsigned k = 0;
+      for(auto& lfs: lfsv)
+      {
+          m_layoutFlowVect.back().push_back(InitialiseLayout(lfs, m_config, layoutStatus, refResolution.x, refResolution.y));
+          m_layoutFlowVect.back().back()->Init();
+          m_layoutFlowVect.back().back()->SetInterpolationTech(interpol);
+          m_layoutFlowVect.back().back()->SetGeometryPrecision(geometryPrecision);
+          m_layoutFlowVect.back().back()->SetMathMode(mathMode);
+          m_layoutFlowVect.back().back()->SetMaxThreads(flowMaxThreads[j]);
+          refResolution = m_layoutFlowVect.back().back()->GetReferenceResolution();
+          ++k;
+          if (layoutStatus == LayoutStatus::Input)
+          {
+            layoutStatus = LayoutStatus::Intermediate;
+          }
+          if (k == lfsv.size()-1)
+          {
+            layoutStatus = LayoutStatus::Output;
+          }
+      }
+      ++j;
+  }
+
+  //Accuracy report of the float32 geometry: largest position error of ToLayout for each step of each flow
+  if (geometryPrecision == Layout::GeometryPrecision::Float32)
+  {
+      j = 0;
+      for(auto& lfsv: m_layoutFlowSections)
+      {
+          for (unsigned k = 1; k < lfsv.size(); ++k)
+          {
+              m_log << "Float32 geometry max error for flow " << j+1 << " (" << lfsv[k-1] << " -> " << lfsv[k] << "): "
+                    << m_layoutFlowVect[j][k-1]->GetGeometryPrecisionError(*m_layoutFlowVect[j][k]) << " pixel(s)" << std::endl;
+          }
+          ++j;
+      }
+  }
+
+  //Frame range sharding: the frames are split in GOP-aligned ranges processed by parallel jobs, their outputs are concatenated at the end of Run
+  auto nbShardsOpt = m_config.get_optional<unsigned int>("Global.nbShards");
+  if (nbShardsOpt && nbShardsOpt.get() > 1)
+  {
+      //the shards measure the time from their own first frame and cannot share a state between frames
+      bool hasDynamicLayout = false;
+      for (auto& lf: m_layoutFlowVect)
+      {
+          for (auto& l: lf)
+          {
+              hasDynamicLayout = hasDynamicLayout || l->IsDynamic();
+          }
+      }
+      std::string notSupported = m_useSyntheticInput ? "the synthetic input" : m_displayFinalPict ? "displayFinalPict" : m_multiViewportQuality != nullptr ? "the viewport quality" :
+                                 !GetJSONList("Global.qualityWindows").empty() ? "the quality windows" : hasDynamicLayout ? "the dynamic layouts" : "";
+      if (notSupported.empty())
+      {//same GOP as the output videos: each shard starts with a new GOP
+          m_shardVect = ComputeShards(m_startFrame, m_nbFrames, m_processingStep, int(m_fps/(2*m_processingStep)), nbShardsOpt.get());
+      }
+      else
+      {
+          m_log << "Sharding not supported with " << notSupported << "; the frames will be processed by one job" << std::endl;
+      }
+  }
+  if (m_shardVect.size() > 1)
+  {//the videos and the quality files are opened by the job of each shard
+      m_log << "Frames processed by " << m_shardVect.size() << " shards" << std::endl;
+      return;
+  }
+  m_shardVect.clear();
+
+  //Initilise input video for each first layout in the m_layoutFlowVect
+  j = 0;
+  for (auto& inputPath:pathToInputVideos)
+  {
+    if (j >= m_layoutFlowVect.size())
+    {
+      break;
+    }
+    if (m_useSyntheticInput)
+    {//the synthetic frames have the resolution of the input layout (refWidth x refHeight)
+      const auto& l = m_layoutFlowVect[j][0];
+      m_log << "Synthetic input for flow " << j+1 << " (instead of " << inputPath << "): " << l->GetWidth() << "x" << l->GetHeight() << std::endl;
+      m_syntheticSourceVect.push_back(std::make_shared<SyntheticSource>(syntheticContent, l->GetWidth(), l->GetHeight()));
+      ++j;
+      continue;
+    }
+    PRINT_DEBUG("Start init input video for flow "<<j+1)
+    m_layoutFlowVect[j][0]->InitInputVideo(inputPath, m_nbFrames);
+    PRINT_DEBUG("Done init input video for flow "<<j+1)
+    ++j;
+  }
+  //The frames before startFrame are not decoded if all the input videos can seek
+  if (m_startFrame > 0 && !m_useSyntheticInput)
+  {
+    unsigned int nbSeeked = 0;
+    for (auto& lf: m_layoutFlowVect)
+    {
+      nbSeeked += lf[0]->SeekInputVideo(m_startFrame) ? 1 : 0;
+    }
+    m_isInputSeeked = nbSeeked == m_layoutFlowVect.size();
+    if (!m_isInputSeeked && nbSeeked > 0)
+    {//the input videos are read from the start and the frames before startFrame are skipped
+      for (auto& lf: m_layoutFlowVect)
+      {
+        lf[0]->SeekInputVideo(0);
+      }
+    }
+    m_log << (m_isInputSeeked ? "Input videos seeked to the frame " : "Input videos cannot seek: the frames are decoded and skipped until the frame ") << m_startFrame << std::endl;
+  }
+
+  //The synthetic benchmark ends with a null encoder: only the projections and the quality measures are measured
+  if (m_useSyntheticInput && !m_pathToOutputVideo.empty())
+  {
+      m_log << "Synthetic input: the output videos are not encoded" << std::endl;
+      m_pathToOutputVideo = "";
+  }
+  //Init ouput video for each last video in the m_layoutFlowVect
+  if (!m_pathToOutputVideo.empty())
+  {
+      size_t lastindex = m_pathToOutputVideo.find_last_of(".");
+      std::string pathToOutputVideoExtension = m_pathToOutputVideo.substr(lastindex, m_pathToOutputVideo.size());
+      std::string pathToOutputVideo = m_pathToOutputVideo.substr(0, lastindex);
+      unsigned int j = 0;
+      for(auto& lfsv: m_layoutFlowSections)
+      {
+          const auto& l = m_layoutFlowVect[j].back();
+          std::string path = pathToOutputVideo+std::to_string(j+1)+lfsv.back()+pathToOutputVideoExtension;
+          m_log << "Output video path for flow "<< j+1 <<": " << path << std::endl;
+
+          auto bitrate = GetBitrateVector(lfsv.back(), m_config, videoOutputBitRate);
+          l->InitOutputVideo(path, outputVideoCodec, m_fps/m_processingStep, int(m_fps/(2*m_processingStep)), bitrate);
+          ++j;
+      }
+  }
+  //Parse the optional sliding-window aggregation of the quality measures
+  std::vector<double> qualityWindowDurations;
+  std::vector<double> qualityWindowPercentiles;
+  for (const auto& d: GetJSONList("Global.qualityWindows"))
+  {
+      qualityWindowDurations.push_back(std::stod(d));
+  }
+  if (!qualityWindowDurations.empty())
+  {
+      for (const auto& p: GetJSONList("Global.qualityWindowPercentiles"))
+      {
+          qualityWindowPercentiles.push_back(std::stod(p));
+      }
+  }
+  auto qualityWindowFormat = QualityWindowAggregator::OutputFormat::CSV;
+  auto qualityWindowFormatOpt = m_config.get_optional<std::string>("Global.qualityWindowFormat");
+  if (qualityWindowFormatOpt && qualityWindowFormatOpt.get() == "binary")
+  {
+      qualityWindowFormat = QualityWindowAggregator::OutputFormat::BINARY;
+  }
+  else if (qualityWindowFormatOpt && qualityWindowFormatOpt.get().size() > 0 && qualityWindowFormatOpt.get() != "csv")
+  {
+      m_log << "Quality window format " << qualityWindowFormatOpt.get() << " not recognized; csv will be used instead" << std::endl;
+  }
+
+  //If true, the PSNR and WS-PSNR of each face (or tile) of the final layouts are also computed
+  auto qualityPerFaceOpt = m_config.get_optional<bool>("Global.qualityPerFace");
+  bool qualityPerFace = qualityPerFaceOpt && qualityPerFaceOpt.get();
+
+  //Init the quality ouput files
+  if (!pathToOutputQuality.empty())
+  {
+      size_t lastindex = pathToOutputQuality.find_last_of(".");
+      std::string pathToOutputQualityExtension = pathToOutputQuality.substr(lastindex, pathToOutputQuality.size());
+      pathToOutputQuality = pathToOutputQuality.substr(0, lastindex);
+      unsigned int j = 0;
+      for(auto& lfsv: m_layoutFlowSections)
+      {
+          if (j != 0)
+          {
+              const auto& l = m_layoutFlowVect[j].back();
+              std::string path = pathToOutputQuality+std::to_string(j+1)+lfsv.back()+pathToOutputQualityExtension;
+              m_log << "Quality path for flow "<< j+1 <<": " << path << std::endl;
+              m_qualityWriterVect.push_back(std::make_shared<std::ofstream>(path));
+              if (!m_qualityNames.empty())
+              {//header line: name of the metrics
+                  for (unsigned int q = 0; q < m_qualityNames.size(); ++q)
+                  {
+                      *m_qualityWriterVect.back() << (q == 0 ? "" : " ") << m_qualityNames[q];
+                  }
+                  *m_qualityWriterVect.back() << std::endl;
+              }
+              if (!qualityWindowDurations.empty() && !m_qualityNames.empty())
+              {
+                  std::vector<unsigned int> windowSizes;
+                  for (auto d: qualityWindowDurations)
+                  {//number of processed frames in the window
+                      windowSizes.push_back(std::max(1, int(std::round(d*m_fps/m_processingStep))));
+                  }
+                  std::string windowPath = pathToOutputQuality+std::to_string(j+1)+lfsv.back()+"_windows"+(qualityWindowFormat == QualityWindowAggregator::OutputFormat::BINARY ? ".bin" : ".csv");
+                  m_log << "Quality window path for flow "<< j+1 <<": " << windowPath << std::endl;
+                  m_qualityWindowVect.push_back(std::make_shared<QualityWindowAggregator>(windowPath, m_qualityNames, qualityWindowDurations, windowSizes, qualityWindowPercentiles, qualityWindowFormat));
+              }
+              if (qualityPerFace)
+              {
+                  std::shared_ptr<FaceQualityMap> faceQualityMap(nullptr);
+                  std::shared_ptr<std::ofstream> faceQualityWriter(nullptr);
+                  try
+                  {
+                      faceQualityMap = std::make_shared<FaceQualityMap>(*m_layoutFlowVect[0].back(), *l);
+                      std::string facePath = pathToOutputQuality+std::to_string(j+1)+lfsv.back()+"_faces"+pathToOutputQualityExtension;
+                      m_log << "Per face quality path for flow "<< j+1 <<": " << facePath << std::endl;
+                      faceQualityWriter = std::make_shared<std::ofstream>(facePath);
+                      *faceQualityWriter << "frame metric";
+                      for (unsigned int f = 0; f < l->GetNbFaces(); ++f)
+                      {
+                          *faceQualityWriter << " " << l->GetFaceName(f);
+                      }
+                      *faceQualityWriter << std::endl;
+                  }
+                  catch (std::exception& e)
+                  {
+                      m_log << "Per face quality not computed for flow " << j+1 << ": " << e.what() << std::endl;
+                      faceQualityMap = nullptr;
+                      faceQualityWriter = nullptr;
+                  }
+                  m_faceQualityMapVect.push_back(faceQualityMap);
+                  m_faceQualityWriterVect.push_back(faceQualityWriter);
+              }
+          }
+          ++j;
+      }
+  }
+
+  //Frame pipeline: maximum number of frames waiting between two stages (0 = the stages are run sequentially)
+  auto pipelineQueueSizeOpt = m_config.get_optional<unsigned int>("Global.pipelineQueueSize");
+  m_pipelineQueueSize = pipelineQueueSizeOpt ? pipelineQueueSizeOpt.get() : 2;
+  if (m_displayFinalPict && m_pipelineQueueSize != 0)
+  {
+      m_log << "Pipeline disabled: the final pictures are displayed" << std::endl;
+      m_pipelineQueueSize = 0;
+  }
+  //The measures use the geometry of the final layouts: the projection of a dynamic layout has to wait for the measure of the previous frame
+  for(auto& lf: m_layoutFlowVect)
+  {
+      m_hasDynamicFinalLayout = m_hasDynamicFinalLayout || lf.back()->IsDynamic();
+  }
+}
+catch (const pt::ptree_error& e)
+{//missing key or value that cannot be converted
+  throw std::invalid_argument(std::string("Error while parsing the configuration: ")+e.what());
+}
+
+void TransJob::ConfigureProcess(const Config& config)
+{
+  try
+  {
+    //Task pool shared by all the parallel loops (projections, quality measures)
+    auto nbThreadsOpt = config.get_optional<unsigned int>("Global.nbThreads");
+    TaskPool::SetDefaultNbThreads(nbThreadsOpt ? nbThreadsOpt.get() : 0);
+    auto threadPinningOpt = config.get_optional<bool>("Global.threadPinning");
+    TaskPool::SetDefaultThreadPinning(threadPinningOpt && threadPinningOpt.get());
+    auto taskGrainSizeOpt = config.get_optional<unsigned long>("Global.taskGrainSize");
+    if (taskGrainSizeOpt)
+    {
+      TaskPool::SetDefaultGrainSize(taskGrainSizeOpt.get());
+    }
+    //Threads of the libav decoders and encoders (0: libav default)
+    auto codecThreadsOpt = config.get_optional<int>("Global.codecThreads");
+    if (codecThreadsOpt)
+    {
+      LibAv::VideoReader::SetNbCodecThreads(codecThreadsOpt.get());
+      LibAv::VideoWriter::SetNbCodecThreads(codecThreadsOpt.get());
+    }
+    //Buffers of the decoded and projected pictures are recycled from one frame to the next
+    auto picturePoolSizeOpt = config.get_optional<unsigned long>("Global.picturePoolSize");
+    if (picturePoolSizeOpt)
+    {
+      PicturePool::SetDefaultMaxFreeBuffers(picturePoolSizeOpt.get());
+    }
+  }
+  catch (const pt::ptree_error& e)
+  {
+    throw std::invalid_argument(std::string("Error while parsing the process settings: ")+e.what());
+  }
+  LibAv::VideoReader::SetMatAllocator([](int rows, int cols, int type) {return PicturePool::GetDefault()->GetMat(rows, cols, type);});
+}
+
+const std::vector<std::string>& TransJob::GetProcessSettingKeys(void)
+{
+  static const std::vector<std::string> keys = {"nbThreads", "threadPinning", "taskGrainSize", "codecThreads", "picturePoolSize"};
+  return keys;
+}
+
+TransJob::Config TransJob::ReadIni(const std::string& pathToIni)
+{
+  Config config;
+  pt::ini_parser::read_ini(pathToIni, config);
+  return config;
+}
+
+void TransJob::Run(void)
+{
+  m_lastEndTime = std::chrono::high_resolution_clock::now();
+  auto runStartTime = m_lastEndTime;
+  if (!m_shardVect.empty())
+  {
+    RunShards();
+  }
+  else
+  {
+    FramePipeline pipeline(m_layoutFlowVect.size(), m_pipelineQueueSize, m_hasDynamicFinalLayout, *m_profiler);
+    pipeline.Run(m_nbFrames+m_startFrame, [this](int count) {return Decode(count);},
+                 [this](unsigned int j, int count, std::shared_ptr<Picture> pict) {return Project(j, count, std::move(pict));},
+                 [this](int count, const FramePipeline::FramePictures& outputPicts) {Measure(count, outputPicts);},
+                 [this](int count, const FramePipeline::FramePictures& outputPicts) {Encode(count, outputPicts);});
+  }
+  double runDuration = std::chrono::duration<double>(std::chrono::high_resolution_clock::now()-runStartTime).count();
+  if (!m_pathToProfile.empty())
+  {
+      m_profiler->Write(m_pathToProfile);
+      m_log << "Profile written in " << m_pathToProfile << std::endl;
+  }
+  if (m_useSyntheticInput && m_nbProcessedFrames > 0)
+  {
+      PrintSyntheticThroughput(runDuration);
+  }
+}
+
+namespace
+{
+  /** Remove the files when it goes out of scope: the temporary files of the shards are removed on every exit path */
+  class FileRemover
+  {
+  public:
+    explicit FileRemover(std::vector<std::string> paths): m_paths(std::move(paths)) {}
+    ~FileRemover(void)
+    {
+      for (const auto& path: m_paths)
+      {
+        std::remove(path.c_str());
+      }
+    }
+    FileRemover(const FileRemover&) = delete;
+    FileRemover& operator=(const FileRemover&) = delete;
+  private:
+    std::vector<std::string> m_paths;
+  };
+}
+
+void TransJob::RunShards(void)
+{
+  //output files of the shards (the files that are not written are ignored by the remover)
+  std::vector<std::string> shardFiles;
+  for (unsigned int k = 0; k < m_shardVect.size(); ++k)
+  {
+    for (unsigned int j = 0; j < m_layoutFlowVect.size(); ++j)
+    {
+      if (!m_pathToOutputVideo.empty())
+      {
+        shardFiles.push_back(GetFlowPath(GetShardPath(m_pathToOutputVideo, k), j, ""));
+      }
+      if (!m_pathToOutputQuality.empty())
+      {
+        shardFiles.push_back(GetFlowPath(GetShardPath(m_pathToOutputQuality, k), j, ""));
+        shardFiles.push_back(GetFlowPath(GetShardPath(m_pathToOutputQuality, k), j, "_faces"));
+      }
+    }
+  }
+  //declared before the jobs: the files are removed after the jobs closed them, even if a shard fails
+  FileRemover shardFileRemover(std::move(shardFiles));
+
+  //the jobs of the shards use the process wide settings of this job
+  std::vector<std::unique_ptr<TransJob>> shardJobVect;
+  for (unsigned int k = 0; k < m_shardVect.size(); ++k)
+  {
+    Config shardConfig = m_config;
+    shardConfig.put("Global.startFrame", m_shardVect[k].first);
+    shardConfig.put("Global.nbFrames", m_shardVect[k].second);
+    shardConfig.put("Global.nbShards", 1);
+    shardConfig.put("Global.profileOutput", "");
+    shardConfig.put("Global.videoOutputName", GetShardPath(m_pathToOutputVideo, k));
+    shardConfig.put("Global.qualityOutputName", GetShardPath(m_pathToOutputQuality, k));
+    m_log << "Shard " << k+1 << ": frames [" << m_shardVect[k].first << ", " << m_shardVect[k].first+m_shardVect[k].second << ")" << std::endl;
+    shardJobVect.emplace_back(new TransJob(shardConfig, nullptr, false));
+    shardJobVect.back()->SetQualityCallback(m_qualityCallback);
+    shardJobVect.back()->SetOutputCallback(m_outputCallback);
+    //the measures of all the shards are written in the profile of this job by Run
+    shardJobVect.back()->m_profiler = m_profiler;
+  }
+
+  //the projections of all the shards share the task pool
+  std::vector<std::exception_ptr> errorVect(shardJobVect.size(), nullptr);
+  std::vector<std::thread> shardThreads;
+  for (unsigned int k = 0; k < shardJobVect.size(); ++k)
+  {
+    shardThreads.emplace_back([&shardJobVect, &errorVect, k]()
+    {
+      try
+      {
+        shardJobVect[k]->Run();
+      }
+      catch (...)
+      {
+        errorVect[k] = std::current_exception();
+      }
+    });
+  }
+  for (auto& shardThread: shardThreads)
+  {
+    shardThread.join();
+  }
+  for (const auto& error: errorVect)
+  {
+    if (error != nullptr)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+  for (const auto& shardJob: shardJobVect)
+  {
+    m_nbProcessedFrames += shardJob->GetNbProcessedFrames();
+  }
+  //the destructors of the jobs close the videos and the quality files of the shards
+  shardJobVect.clear();
+
+  //Stitch the outputs of the shards: the videos are concatenated without re-encoding (each shard starts with a new GOP)
+  for (unsigned int j = 0; j < m_layoutFlowVect.size(); ++j)
+  {
+    if (!m_pathToOutputVideo.empty())
+    {
+      std::vector<std::string> shardPaths;
+      for (unsigned int k = 0; k < m_shardVect.size(); ++k)
+      {
+        shardPaths.push_back(GetFlowPath(GetShardPath(m_pathToOutputVideo, k), j, ""));
+      }
+      std::string path = GetFlowPath(m_pathToOutputVideo, j, "");
+      LibAv::VideoWriter::Concatenate(shardPaths, path);
+      m_log << "Output video of flow " << j+1 << " concatenated in " << path << std::endl;
+    }
+    if (!m_pathToOutputQuality.empty() && j != 0)
+    {//header lines: name of the metrics in the quality file, name of the faces in the per face quality file
+      ConcatenateShardFiles(j, "", m_qualityNames.empty() ? 0 : 1);
+      ConcatenateShardFiles(j, "_faces", 1);
+    }
+  }
+}
+
+void TransJob::ConcatenateShardFiles(unsigned int j, const std::string& suffix, unsigned int nbHeaderLines) const
+{
+  //the file is not written by the shards (e.g. no per face quality for this layout)
+  if (!std::ifstream(GetFlowPath(GetShardPath(m_pathToOutputQuality, 0), j, suffix)).good())
+  {
+    return;
+  }
+  std::vector<std::string> shardPaths;
+  for (unsigned int k = 0; k < m_shardVect.size(); ++k)
+  {
+    shardPaths.push_back(GetFlowPath(GetShardPath(m_pathToOutputQuality, k), j, suffix));
+  }
+  ConcatenateFiles(shardPaths, GetFlowPath(m_pathToOutputQuality, j, suffix), nbHeaderLines);
+}
+
+void TransJob::ConcatenateFiles(const std::vector<std::string>& inputPaths, const std::string& outputPath, unsigned int nbHeaderLines)
+{
+  std::ofstream output(outputPath);
+  if (!output.is_open())
+  {
+    throw std::invalid_argument("ConcatenateFiles: cannot open "+outputPath);
+  }
+  for (unsigned int k = 0; k < inputPaths.size(); ++k)
+  {
+    std::ifstream input(inputPaths[k]);
+    std::string line;
+    for (unsigned int lineId = 0; std::getline(input, line); ++lineId)
+    {
+      if (k == 0 || lineId >= nbHeaderLines)
+      {
+        output << line << std::endl;
+      }
+    }
+  }
+}
+
+std::string TransJob::GetFlowPath(const std::string& path, unsigned int j, const std::string& suffix) const
+{
+  size_t lastindex = path.find_last_of(".");
+  std::string extension = lastindex != std::string::npos ? path.substr(lastindex) : "";
+  return path.substr(0, lastindex)+std::to_string(j+1)+m_layoutFlowSections[j].back()+suffix+extension;
+}
+
+std::string TransJob::GetShardPath(const std::string& path, unsigned int k)
+{
+  if (path.empty())
+  {
+    return path;
+  }
+  //a dot in a directory name is not an extension
+  size_t lastindex = path.find_last_of(".");
+  if (lastindex != std::string::npos && path.find('/', lastindex) != std::string::npos)
+  {
+    lastindex = std::string::npos;
+  }
+  std::string extension = lastindex != std::string::npos ? path.substr(lastindex) : "";
+  return path.substr(0, lastindex)+"_shard"+std::to_string(k+1)+"_"+extension;
+}
+
+std::vector<std::pair<unsigned int, unsigned int>> TransJob::ComputeShards(unsigned int startFrame, unsigned int nbFrames, unsigned int processingStep, unsigned int gopSize, unsigned int nbShards)
+{
+  processingStep = std::max(1u, processingStep);
+  gopSize = std::max(1u, gopSize);
+  //number of output frames and of GOPs of the output videos
+  const unsigned int nbOutputFrames = (nbFrames+processingStep-1)/processingStep;
+  const unsigned int nbGops = (nbOutputFrames+gopSize-1)/gopSize;
+  std::vector<std::pair<unsigned int, unsigned int>> shardVect;
+  if (nbGops == 0)
+  {
+    return shardVect;
+  }
+  nbShards = std::min(std::max(1u, nbShards), nbGops);
+  for (unsigned int k = 0; k < nbShards; ++k)
+  {//the GOPs are shared as evenly as possible between the shards
+    const unsigned int first = (k*nbGops/nbShards)*gopSize;
+    const unsigned int last = std::min(nbOutputFrames, ((k+1)*nbGops/nbShards)*gopSize);
+    const unsigned int firstFrame = startFrame+first*processingStep;
+    const unsigned int endFrame = last == nbOutputFrames ? startFrame+nbFrames : startFrame+last*processingStep;
+    shardVect.emplace_back(firstFrame, endFrame-firstFrame);
+  }
+  return shardVect;
+}
+
+FramePipeline::FramePictures TransJob::ProcessFrame(int frameId, const FramePipeline::FramePictures& inputPicts)
+{
+  if (!m_shardVect.empty())
+  {
+    throw std::invalid_argument("ProcessFrame: the frames of this job are processed by shards (Global.nbShards)");
+  }
+  if (inputPicts.size() != m_layoutFlowVect.size())
+  {
+    throw std::invalid_argument("ProcessFrame: "+std::to_string(inputPicts.size())+" input picture(s) for "+std::to_string(m_layoutFlowVect.size())+" flow(s)");
+  }
+  if (m_nbProcessedFrames == 0)
+  {
+    m_lastEndTime = std::chrono::high_resolution_clock::now();
+  }
+  Profiler::FrameScope frameScope(frameId, *m_profiler);
+  FramePipeline::FramePictures outputPicts;
+  for (unsigned int j = 0; j < inputPicts.size(); ++j)
+  {
+    Profiler::ScopedTimer timer("projection/flow"+std::to_string(j));
+    outputPicts.push_back(Project(j, frameId, inputPicts[j]));
+  }
+  Profiler::Time("measure", [&]{Measure(frameId, outputPicts);});
+  Profiler::Time("encode", [&]{Encode(frameId, outputPicts);});
+  return outputPicts;
+}
+
+FramePipeline::FramePictures TransJob::Decode(int count)
+{
+  if (m_isInputSeeked && count < int(m_startFrame))
+  {//the input videos start at startFrame
+    return FramePipeline::FramePictures();
+  }
+  bool isProcessed = count >= int(m_startFrame) && (count - int(m_startFrame))%m_processingStep == 0;
+  Log((count >= int(m_startFrame) ? "Read image " : "Skip image ")+std::to_string(count));
+  FramePipeline::FramePictures picts;
+  if (m_useSyntheticInput)
+  {//the skipped frames are not generated
+    for (unsigned int j = 0; isProcessed && j < m_syntheticSourceVect.size(); ++j)
+    {
+      picts.push_back(m_syntheticSourceVect[j]->GetFrame(count));
+    }
+    return picts;
+  }
+  double conversionTime = 0;
+  for(auto& lf: m_layoutFlowVect)
+  {//the conversion time is measured by each reader: the other jobs of the process are not counted
+    auto reader = lf[0]->GetInputVideo();
+    const double conversionStart = reader ? reader->GetConversionTime() : 0;
+    std::shared_ptr<Picture> pict = lf[0]->ReadNextPictureFromVideo();
+    conversionTime += reader ? reader->GetConversionTime()-conversionStart : 0;
+    if (isProcessed)
+    {//start processing when count >= startFrame
+      picts.push_back(pict);
+    }
+  }
+  Profiler::AddTime("decode/colorConversion", conversionTime);
+  return picts;
+}
+
+std::shared_ptr<Picture> TransJob::Project(unsigned int j, int count, std::shared_ptr<Picture> pict)
+{
+  auto& lf = m_layoutFlowVect[j];
+  auto pictOut = pict;
+  std::ostringstream flowDescription;
+  flowDescription << "Flow " << j << ": " << m_layoutFlowSections[j][0];
+  for (unsigned int i = 1; i < lf.size(); ++i)
+  {
+      flowDescription << " -> " << m_layoutFlowSections[j][i];
+      lf[i]->NextStep(double(count-int(m_startFrame))/m_fps);
+      pictOut = lf[i]->FromLayout(*pictOut, *lf[i-1]);
+  }
+  Log(flowDescription.str());
+  return pictOut;
+}
+
+double TransJob::ComputeQuality(const std::string& qualityName, const ReferencePicture& refPict, const Picture& pictOut, Layout& layoutOut)
+{
+  Layout& layoutRef = *m_layoutFlowVect[0].back();
+  return Profiler::Time("metric/"+qualityName, [&]() -> double
+  {
+    if (qualityName == "MS-SSIM")
+    {
+      return refPict.GetMSSSIM(pictOut);
+    }
+    if (qualityName == "SSIM")
+    {
+      return refPict.GetSSIM(pictOut);
+    }
+    if (qualityName == "PSNR")
+    {
+      return refPict.GetPSNR(pictOut);
+    }
+    if (qualityName == "S-PSNR-NN")
+    {
+      return refPict.GetSPSNR(pictOut, layoutRef, layoutOut, Picture::InterpolationTech::NEAREST_NEIGHTBOOR, m_spsnrNbPoints);
+    }
+    if (qualityName == "S-PSNR-I")
+    {
+      return refPict.GetSPSNR(pictOut, layoutRef, layoutOut, Picture::InterpolationTech::BICUBIC, m_spsnrNbPoints);
+    }
+    if (qualityName == "WS-PSNR")
+    {
+      return refPict.GetWSPSNR(pictOut, layoutRef, layoutOut);
+    }
+    throw std::invalid_argument("Quality "+qualityName+" not supported");
+  });
+}
+
+void TransJob::Measure(int count, const FramePipeline::FramePictures& outputPicts)
+{
+  //preprocessing of the reference shared by all the tested flows
+  std::shared_ptr<Picture> firstPict = outputPicts[0];
+  std::shared_ptr<ReferencePicture> refPict = std::make_shared<ReferencePicture>(firstPict);
+  std::vector<std::shared_ptr<Layout>> finalLayoutVect;
+  for (unsigned int j = 0; j < outputPicts.size(); ++j)
+  {
+    auto& lf = m_layoutFlowVect[j];
+    const auto& pictOut = outputPicts[j];
+    finalLayoutVect.push_back(lf.back());
+    if (m_displayFinalPict)
+    {
+        pictOut->ImgShowWithLimit("Output"+std::to_string(j)+": "+m_layoutFlowSections[j][lf.size()-1], cv::Size(1200,900));
+    }
+    if ((!m_qualityWriterVect.empty() || m_qualityCallback) && !m_qualityNames.empty() && j != 0)
+    {
+        std::ostringstream qualityLine;
+        qualityLine << "Flow " << j << ": ";
+        std::vector<double> frameQuality;
+        for (const auto& qualityName: m_qualityNames)
+        {
+          double quality = ComputeQuality(qualityName, *refPict, *pictOut, *lf.back());
+          qualityLine << (frameQuality.empty() ? "" : " ") << qualityName << " = " << quality << ";";
+          frameQuality.push_back(quality);
+        }
+        Log(qualityLine.str());
+        if (!m_qualityWriterVect.empty())
+        {
+          auto& qualityWriter = *m_qualityWriterVect[j-1];
+          for (unsigned int q = 0; q < frameQuality.size(); ++q)
+          {
+            qualityWriter << (q == 0 ? "" : " ") << frameQuality[q];
+          }
+          qualityWriter << std::endl;
+        }
+        if (!m_qualityWindowVect.empty())
+        {
+            m_qualityWindowVect[j-1]->AddFrame(count, frameQuality);
+        }
+        if (m_qualityCallback)
+        {
+            m_qualityCallback(count, j, m_qualityNames, frameQuality);
+        }
+    }
+    if (!m_faceQualityMapVect.empty() && j != 0 && m_faceQualityMapVect[j-1] != nullptr)
+    {
+        std::vector<double> facePsnr, faceWspsnr;
+        std::tie(facePsnr, faceWspsnr) = Profiler::Time("metric/perFace", [&]{return m_faceQualityMapVect[j-1]->ComputeQuality(*firstPict, *pictOut);});
+        auto& faceWriter = *m_faceQualityWriterVect[j-1];
+        faceWriter << count << " PSNR";
+        for (auto v: facePsnr)
+        {
+            faceWriter << " " << v;
+        }
+        faceWriter << std::endl << count << " WS-PSNR";
+        for (auto v: faceWspsnr)
+        {
+            faceWriter << " " << v;
+        }
+        faceWriter << std::endl;
+    }
+  }
+
+  if (m_multiViewportQuality != nullptr)
+  {
+      Log("Viewport quality for "+std::to_string(m_multiViewportQuality->GetNbUsers())+" users");
+      m_multiViewportQuality->NextStep(double(count-int(m_startFrame))/m_fps);
+      Profiler::Time("metric/viewport", [&]{m_multiViewportQuality->ComputeQuality(count, outputPicts, finalLayoutVect);});
+  }
+
+  if (m_displayFinalPict)
+  {
+    cv::waitKey(0);
+    cv::destroyAllWindows();
+  }
+}
+
+void TransJob::Encode(int count, const FramePipeline::FramePictures& outputPicts)
+{
+  if (!m_pathToOutputVideo.empty())
+  {
+    double conversionTime = 0;
+    unsigned long long nbBytes = 0;
+    for (unsigned int j = 0; j < outputPicts.size(); ++j)
+    {//the statistics are measured by each writer: the other jobs of the process are not counted
+      PRINT_DEBUG("Send picture to encoder "<<j+1)
+      auto writer = m_layoutFlowVect[j].back()->GetOutputVideo();
+      const double conversionStart = writer ? writer->GetConversionTime() : 0;
+      const unsigned long long nbBytesStart = writer ? writer->GetEncodedBytes() : 0;
+      m_layoutFlowVect[j].back()->WritePictureToVideo(outputPicts[j]);
+      conversionTime += writer ? writer->GetConversionTime()-conversionStart : 0;
+      nbBytes += writer ? writer->GetEncodedBytes()-nbBytesStart : 0;
+    }
+    Profiler::AddTime("encode/colorConversion", conversionTime);
+    Profiler::AddCount("bytesEncoded", nbBytes);
+  }
+  if (m_outputCallback)
+  {
+    m_outputCallback(count, outputPicts);
+  }
+
+  //with the pipeline the elapsed time is the time between two output frames
+  auto endTime = std::chrono::high_resolution_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>( endTime - m_lastEndTime ).count();
+  m_lastEndTime = endTime;
+  m_averageDuration = (m_averageDuration*m_nbProcessedFrames + duration)/(m_nbProcessedFrames+1);
+  ++m_nbProcessedFrames;
+  const int nbFramesToProcess = (m_nbFrames+m_processingStep-1)/m_processingStep;
+  std::ostringstream timeLine;
+  timeLine << "Elapsed time for picture " << count << ": "<< print_time(long(float(duration)/1000.f)) << " "
+    "estimated remaining time = " << print_time(long(std::max(0, nbFramesToProcess-m_nbProcessedFrames)*m_averageDuration/1000.f)) << " ";
+  Log(timeLine.str());
+}
+
+void TransJob::Log(const std::string& line)
+{
+  std::lock_guard<std::mutex> lock(m_logMutex);
+  m_log << line << std::endl;
+}
+
+void TransJob::PrintSyntheticThroughput(double runDuration)
+{
+  //time spent by each stage summed over the frames: with the pipeline the stages run concurrently, the slowest one limits the total throughput
+  auto printThroughput = [&](const std::string& stageName, const std::string& timerName, double nbPixelsPerFrame)
+  {
+    double stageDuration = m_profiler->GetTotal(Profiler::Kind::TIMER, timerName);
+    if (stageDuration > 0)
+    {
+      m_log << stageName << ": " << m_nbProcessedFrames/stageDuration << " frames/s, " << m_nbProcessedFrames*nbPixelsPerFrame/stageDuration << " pixels/s" << std::endl;
+    }
+  };
+  double nbInputPixels = 0;
+  double nbOutputPixels = 0;
+  for (unsigned int j = 0; j < m_layoutFlowVect.size(); ++j)
+  {
+    nbInputPixels += double(m_layoutFlowVect[j][0]->GetWidth())*m_layoutFlowVect[j][0]->GetHeight();
+    nbOutputPixels += double(m_layoutFlowVect[j].back()->GetWidth())*m_layoutFlowVect[j].back()->GetHeight();
+  }
+  m_log << "Synthetic throughput (" << m_nbProcessedFrames << " frames):" << std::endl;
+  m_log << "Total: " << m_nbProcessedFrames/runDuration << " frames/s, " << m_nbProcessedFrames*nbOutputPixels/runDuration << " output pixels/s" << std::endl;
+  printThroughput("Synthetic input", "decode", nbInputPixels);
+  for (unsigned int j = 0; j < m_layoutFlowVect.size(); ++j)
+  {
+    const auto& l = m_layoutFlowVect[j].back();
+    printThroughput("Projection flow "+std::to_string(j+1)+" ("+m_layoutFlowSections[j].back()+")", "projection/flow"+std::to_string(j), double(l->GetWidth())*l->GetHeight());
+  }
+  printThroughput("Quality measures", "measure", nbOutputPixels);
+}
+
+std::vector<std::string> TransJob::GetJSONList(const std::string& key) const
+{
+  std::vector<std::string> values;
+  auto valueOpt = m_config.get_optional<std::string>(key);
+  if (!valueOpt || valueOpt.get().empty())
+  {
+    return values;
+  }
+  try {
+    pt::ptree ptree_json;
+    std::stringstream ss(valueOpt.get());
+    pt::json_parser::read_json(ss, ptree_json);
+    BOOST_FOREACH(boost::property_tree::ptree::value_type &v, ptree_json.get_child(""))
+    {
+        values.push_back(v.second.data());
+    }
+  }
+  catch (std::exception &e)
+  {
+      throw std::invalid_argument("Error while parsing the "+key+": "+e.what());
+  }
+  return values;
+}
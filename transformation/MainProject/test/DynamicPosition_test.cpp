@@ -0,0 +1,70 @@
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "dynamicPosition.hpp"
+
+using namespace IMT;
+
+class DynamicPositionTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {//the position changes at the timestamps 0, 1 and 2
+    pathToTrace = "/tmp/trans_DynamicPosition_test_"+std::to_string(getpid())+".txt";
+    positions = {Quaternion::FromEuler(0.3, -0.2, 0.1), Quaternion::FromEuler(-1.2, 0.5, 0.7), Quaternion::FromEuler(2.5, 0.1, -0.4)};
+    std::ofstream trace(pathToTrace);
+    trace << std::setprecision(17);
+    for (unsigned int k = 0; k < positions.size(); ++k)
+    {
+      const auto& q = positions[k];
+      trace << k << " " << 30*k << " " << q.GetW() << " " << q.GetV().GetX() << " " << q.GetV().GetY() << " " << q.GetV().GetZ() << std::endl;
+    }
+  }
+
+  virtual void TearDown()
+  {
+    std::remove(pathToTrace.c_str());
+  }
+
+  /** The cached matrices rotate as the current quaternion (and as its inverse) */
+  static void ExpectRotMatMatchesQuaternion(const DynamicPosition& dynamicPosition)
+  {
+    const Quaternion& q = dynamicPosition.GetNextPosition();
+    for (const auto& v: {Coord3dCart(1, 0, 0), Coord3dCart(0, 1, 0), Coord3dCart(0, 0, 1), Coord3dCart(0.5, -2, 1.5)})
+    {
+      EXPECT_LT((Rotation(v, dynamicPosition.GetNextRotMat()) - Rotation(v, q)).Norm(), 1e-12);
+      EXPECT_LT((Rotation(Rotation(v, q), dynamicPosition.GetNextInvRotMat()) - v).Norm(), 1e-12);
+    }
+  }
+
+  std::string pathToTrace;
+  std::vector<Quaternion> positions;
+};
+
+
+TEST_F(DynamicPositionTest, staticPosition)
+{
+  DynamicPosition dynamicPosition(positions[1]);
+  ExpectRotMatMatchesQuaternion(dynamicPosition);
+  dynamicPosition.SetNextPosition(5);
+  ASSERT_EQ(positions[1], dynamicPosition.GetNextPosition());
+  ExpectRotMatMatchesQuaternion(dynamicPosition);
+}
+
+TEST_F(DynamicPositionTest, positionChanges)
+{
+  DynamicPosition dynamicPosition(pathToTrace);
+  for (unsigned int k = 0; k < positions.size(); ++k)
+  {
+    dynamicPosition.SetNextPosition(k+0.5);
+    ASSERT_LT((dynamicPosition.GetNextPosition() - positions[k]).Norm(), 1e-12);
+    ExpectRotMatMatchesQuaternion(dynamicPosition);
+  }
+  //end of the trace: the last position stays
+  dynamicPosition.SetNextPosition(10);
+  ASSERT_LT((dynamicPosition.GetNextPosition() - positions.back()).Norm(), 1e-12);
+  ExpectRotMatMatchesQuaternion(dynamicPosition);
+}
@@ -0,0 +1,84 @@
+#include <cmath>
+#include <vector>
+#include "gtest/gtest.h"
+#include "LayoutCubeMap.hpp"
+#include "LayoutRhombicdodeca.hpp"
+
+using namespace IMT;
+
+namespace
+{
+  /** Give access to the face selections of the cube and of the rhombic dodecahedron */
+  class LayoutCubeMapExposed: public LayoutCubeMap
+  {
+  public:
+    LayoutCubeMapExposed(void): LayoutCubeMap(10, false, std::make_shared<VectorialTrans>()) {}
+    using LayoutCubeMapBased::IntersectionCube;
+    using LayoutCubeMapBased::FromFaceToPlan;
+  };
+
+  class LayoutRhombicdodecaExposed: public LayoutRhombicdodeca
+  {
+  public:
+    LayoutRhombicdodecaExposed(void): LayoutRhombicdodeca(10, false, std::make_shared<VectorialTrans>()) {}
+    using LayoutRhombicdodecaBased::IntersectionRhombicdodeca;
+    using LayoutRhombicdodecaBased::FaceToPlan;
+  };
+
+  /** Directions with their coordinates in values: with 0 and +-1 they are the centers, the edges and the corners of the cube faces */
+  std::vector<Coord3dCart> GetDirections(const std::vector<double>& values)
+  {
+    std::vector<Coord3dCart> directions;
+    for (auto x: values)
+    {
+      for (auto y: values)
+      {
+        for (auto z: values)
+        {
+          if (x != 0 || y != 0 || z != 0)
+          {
+            directions.push_back(Coord3dCart(x, y, z));
+          }
+        }
+      }
+    }
+    //directions that are not on an edge
+    for (int k = 0; k < 1000; ++k)
+    {
+      directions.push_back(Coord3dCart(std::cos(0.7*k)*std::sin(0.013*k+0.1), std::sin(0.7*k)*std::sin(0.013*k+0.1), std::cos(0.013*k+0.1)));
+    }
+    return directions;
+  }
+}
+
+TEST(FaceIntersectionTest, cubeMatchesIntersectionCart)
+{
+  LayoutCubeMapExposed layout;
+  FaceToPlanFct<LayoutCubeMapBased::Faces> faceToPlan = [&layout] (LayoutCubeMapBased::Faces f) {return layout.FromFaceToPlan(f);};
+  for (const auto& direction: GetDirections({-1, -0.5, 0, 0.5, 1}))
+  {
+    auto expected = IntersectionCart(faceToPlan, direction);
+    auto result = LayoutCubeMapExposed::IntersectionCube(direction/direction.Norm());
+    ASSERT_EQ(std::get<1>(expected), std::get<1>(result)) << direction;
+    EXPECT_NEAR(0, (std::get<0>(expected)-std::get<0>(result)).Norm(), 1e-12) << direction;
+    //the float32 geometry selects the same face
+    auto resultF32 = LayoutCubeMapExposed::IntersectionCube(Coord3dCartF32(direction/direction.Norm()));
+    ASSERT_EQ(std::get<1>(expected), std::get<1>(resultF32)) << direction;
+  }
+}
+
+TEST(FaceIntersectionTest, rhombicdodecaMatchesIntersectionCart)
+{
+  LayoutRhombicdodecaExposed layout;
+  FaceToPlanFct<LayoutRhombicdodecaBased::Faces> faceToPlan = [&layout] (LayoutRhombicdodecaBased::Faces f) {return layout.FaceToPlan(f);};
+  //the rhombic dodecahedron has its faces centered on (+-1,0,0), (0,0,+-1) and (+-1/2,+-sqrt(2)/2,+-1/2): its edges and vertices use these coordinates
+  const double s = std::sqrt(2.0)/2;
+  for (const auto& direction: GetDirections({-1, -s, -0.5, 0, 0.5, s, 1}))
+  {
+    Coord3dCart unitDirection = direction/direction.Norm();
+    auto expected = IntersectionCart(faceToPlan, unitDirection);
+    auto result = LayoutRhombicdodecaExposed::IntersectionRhombicdodeca(unitDirection);
+    ASSERT_EQ(std::get<1>(expected), std::get<1>(result)) << direction;
+    EXPECT_NEAR(0, (std::get<0>(expected)-std::get<0>(result)).Norm(), 1e-12) << direction;
+  }
+}
@@ -0,0 +1,68 @@
+#include <cmath>
+#include "gtest/gtest.h"
+#include "FaceQualityMap.hpp"
+#include "LayoutEquirectangular.hpp"
+#include "LayoutEquirectangularTiles.hpp"
+
+using namespace IMT;
+
+class FaceQualityMapTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {//2x1 grid of full scale tiles: the tile 0 is the left half of the picture (with the shared column), the tile 1 the right half
+    layoutRef = std::make_shared<LayoutEquirectangular>(200, 100, Quaternion(1), std::make_shared<VectorialTrans>());
+    layoutRef->Init();
+    LayoutEquirectangularTiles::ScaleTilesMap scaleTiles(2, std::vector<double>(1, 1));
+    LayoutEquirectangularTiles::TileRatios tileRatios(std::vector<double>(2, 0.5), std::vector<double>(1, 1));
+    layoutTiles = std::make_shared<LayoutEquirectangularTiles>(2, 1, scaleTiles, tileRatios, Quaternion(1), std::make_tuple(200u, 100u), true, false, std::make_shared<VectorialTrans>());
+    layoutTiles->Init();
+  }
+
+  virtual void TearDown()
+  {}
+
+  /** Gray picture with the value faceValues[f] on the pixels of the face f of the tiled layout */
+  Picture GetPicture(const std::vector<unsigned char>& faceValues) const
+  {
+    cv::Mat mat(100, 200, CV_8UC3);
+    for (int j = 0; j < mat.rows; ++j)
+    {
+      for (int i = 0; i < mat.cols; ++i)
+      {
+        unsigned char v = faceValues[layoutTiles->GetFaceId(CoordI(i, j))];
+        mat.at<Pixel>(j, i) = Pixel(v, v, v);
+      }
+    }
+    return Picture(mat);
+  }
+
+  std::shared_ptr<Layout> layoutRef;
+  std::shared_ptr<Layout> layoutTiles;
+};
+
+
+TEST_F(FaceQualityMapTest, knownFaceError)
+{
+  FaceQualityMap faceQualityMap(*layoutRef, *layoutTiles);
+  ASSERT_EQ(2u, faceQualityMap.GetNbFaces());
+  //luma error of 10 on each pixel of the tile 0, no error on the tile 1
+  std::vector<double> psnr, wspsnr;
+  std::tie(psnr, wspsnr) = faceQualityMap.ComputeQuality(GetPicture({100, 100}), GetPicture({110, 100}));
+  ASSERT_EQ(2u, psnr.size());
+  ASSERT_EQ(2u, wspsnr.size());
+  //MSE = 100 whatever the weights of the pixels
+  ASSERT_NEAR(10*std::log10(255.0*255.0/100), psnr[0], 1e-6);
+  ASSERT_NEAR(10*std::log10(255.0*255.0/100), wspsnr[0], 1e-6);
+  ASSERT_DOUBLE_EQ(100, psnr[1]);
+  ASSERT_DOUBLE_EQ(100, wspsnr[1]);
+}
+
+TEST_F(FaceQualityMapTest, sizeMismatch)
+{
+  auto smallLayout = std::make_shared<LayoutEquirectangular>(100, 50, Quaternion(1), std::make_shared<VectorialTrans>());
+  smallLayout->Init();
+  ASSERT_THROW(FaceQualityMap(*smallLayout, *layoutTiles), std::invalid_argument);
+  FaceQualityMap faceQualityMap(*layoutRef, *layoutTiles);
+  ASSERT_THROW(faceQualityMap.ComputeQuality(GetPicture({100, 100}), Picture(cv::Mat(50, 100, CV_8UC3))), std::invalid_argument);
+}
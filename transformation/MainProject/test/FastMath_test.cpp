@@ -0,0 +1,82 @@
+#include <limits.h>
+#include <cmath>
+#include <vector>
+#include "gtest/gtest.h"
+#include "FastMath.hpp"
+#include "Common.hpp"
+
+using namespace IMT;
+
+class FastMathTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+};
+
+
+TEST_F(FastMathTest, atan2)
+{
+  for (int i = -50; i <= 50; ++i)
+  {
+    for (int j = -50; j <= 50; ++j)
+    {
+      double y = i*0.37;
+      double x = j*0.23;
+      ASSERT_NEAR(std::atan2(y, x), FastMath::Atan2(y, x), 1e-8);
+      ASSERT_NEAR(std::atan2(y, x), FastMath::Atan2(float(y), float(x)), 3e-7);
+    }
+  }
+}
+
+TEST_F(FastMathTest, sinCos)
+{
+  for (int i = -2000; i <= 2000; ++i)
+  {
+    double x = i*0.0123;
+    double s, c;
+    FastMath::SinCos(x, s, c);
+    ASSERT_NEAR(std::sin(x), s, 1e-8);
+    ASSERT_NEAR(std::cos(x), c, 1e-8);
+    float sf, cf;
+    FastMath::SinCos(float(x), sf, cf);
+    ASSERT_NEAR(std::sin(double(float(x))), sf, 1e-7);
+    ASSERT_NEAR(std::cos(double(float(x))), cf, 1e-7);
+  }
+}
+
+TEST_F(FastMathTest, tanAcos)
+{
+  for (int i = -100; i <= 100; ++i)
+  {
+    double x = i*PI()/400; //[-pi/4, pi/4]
+    ASSERT_NEAR(std::tan(x), FastMath::Tan(x), 1e-8);
+    ASSERT_NEAR(std::atan(x), FastMath::Atan(x), 1e-8);
+    double a = i*0.01; //[-1, 1]
+    ASSERT_NEAR(std::acos(a), FastMath::Acos(a), 1e-8);
+    ASSERT_NEAR(std::acos(a), FastMath::Acos(float(a)), 1e-6);
+  }
+}
+
+TEST_F(FastMathTest, arrayAndMode)
+{
+  std::vector<float> y(1000), x(1000), out(1000);
+  for (size_t i = 0; i < y.size(); ++i)
+  {
+    y[i] = std::sin(0.1f*i);
+    x[i] = std::cos(0.3f*i);
+  }
+  FastMath::Atan2(y.data(), x.data(), out.data(), y.size());
+  for (size_t i = 0; i < y.size(); ++i)
+  {
+    ASSERT_EQ(FastMath::Atan2(y[i], x[i]), out[i]);
+  }
+  VectorCartesian v(0.3, -0.4, 0.5);
+  ASSERT_NEAR(v.GetTheta(), v.GetTheta(MathMode::Fast), 1e-8);
+  ASSERT_NEAR(v.GetPhi(), v.GetPhi(MathMode::Fast), 1e-8);
+  ASSERT_EQ(v.GetTheta(), v.GetTheta(MathMode::Exact));
+  ASSERT_LT((VectorCartesian::FromSpherical(1.2, 0.7) - VectorCartesian::FromSpherical(1.2, 0.7, MathMode::Fast)).Norm(), 1e-8);
+}
@@ -0,0 +1,97 @@
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include "gtest/gtest.h"
+#include "BoundedQueue.hpp"
+#include "FramePipeline.hpp"
+
+using namespace IMT;
+
+class FramePipelineTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+
+  //Run the pipeline on 20 frames (every third frame is skipped) and check that each stage receives the frames in order
+  void CheckOrder(size_t queueSize, bool lockstepMeasure)
+  {
+    const unsigned int nbFlows = 3;
+    FramePipeline pipeline(nbFlows, queueSize, lockstepMeasure);
+    std::mutex mutex;
+    std::vector<std::vector<int>> projected(nbFlows);
+    std::vector<int> measured, encoded;
+    pipeline.Run(20,
+      [&](int frameId) {return frameId%3 == 2 ? FramePipeline::FramePictures() : FramePipeline::FramePictures(nbFlows, nullptr);},
+      [&](unsigned int flowId, int frameId, std::shared_ptr<Picture> pict)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lockstepMeasure)
+        {//all the previous frames are measured
+          EXPECT_EQ(projected[flowId].size(), measured.size());
+        }
+        projected[flowId].push_back(frameId);
+        return pict;
+      },
+      [&](int frameId, const FramePipeline::FramePictures& picts) {EXPECT_EQ(nbFlows, picts.size()); std::lock_guard<std::mutex> lock(mutex); measured.push_back(frameId);},
+      [&](int frameId, const FramePipeline::FramePictures&) {std::lock_guard<std::mutex> lock(mutex); encoded.push_back(frameId);});
+    std::vector<int> expected;
+    for (int i = 0; i < 20; ++i)
+    {
+      if (i%3 != 2) {expected.push_back(i);}
+    }
+    for (auto& p: projected)
+    {
+      ASSERT_EQ(expected, p);
+    }
+    ASSERT_EQ(expected, measured);
+    ASSERT_EQ(expected, encoded);
+  }
+};
+
+
+TEST_F(FramePipelineTest, boundedQueue)
+{
+  BoundedQueue<int> q(2);
+  ASSERT_TRUE(q.Push(1));
+  ASSERT_TRUE(q.Push(2));
+  std::thread producer([&q]{q.Push(3); q.Close();}); //blocked until a value is popped
+  std::vector<int> popped;
+  int v;
+  while (q.Pop(v))
+  {//ends when the producer closed the queue
+    popped.push_back(v);
+  }
+  producer.join();
+  ASSERT_EQ(std::vector<int>({1, 2, 3}), popped);
+  ASSERT_FALSE(q.Pop(v));
+  ASSERT_FALSE(q.Push(4));
+  ASSERT_THROW(BoundedQueue<int>(0), std::invalid_argument);
+}
+
+TEST_F(FramePipelineTest, frameOrder)
+{
+  CheckOrder(0, false);
+  CheckOrder(1, false);
+  CheckOrder(4, false);
+  CheckOrder(2, true);
+}
+
+TEST_F(FramePipelineTest, exceptionPropagated)
+{
+  FramePipeline pipeline(2, 2, false);
+  int nbEncoded = 0;
+  ASSERT_THROW(pipeline.Run(100,
+      [](int) {return FramePipeline::FramePictures(2, nullptr);},
+      [](unsigned int flowId, int frameId, std::shared_ptr<Picture> pict)
+      {
+        if (flowId == 1 && frameId == 10) {throw std::runtime_error("projection error");}
+        return pict;
+      },
+      [](int, const FramePipeline::FramePictures&) {},
+      [&nbEncoded](int, const FramePipeline::FramePictures&) {++nbEncoded;}), std::runtime_error);
+  ASSERT_LE(nbEncoded, 10);
+}
@@ -0,0 +1,104 @@
+#include <string>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "JobServer.hpp"
+
+using namespace IMT;
+
+class JobServerTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {//one socket per test process: the tests can run concurrently
+    path = "/tmp/trans_JobServer_test_"+std::to_string(getpid())+".sock";
+  }
+
+  virtual void TearDown() {}
+
+  std::string path;
+};
+
+
+TEST_F(JobServerTest, parseJobConfig)
+{
+  auto config = JobServer::ParseJobConfig("{\"Global\": {\"nbFrames\": 2, \"syntheticInput\": \"gradient\", \"layoutFlow\": [[\"input.mp4\", \"Equirectangular\", \"CubeMap\"]]},"
+                                          " \"Equirectangular\": {\"type\": \"equirectangular\", \"relativeResolution\": true, \"width\": 0.5}}");
+  ASSERT_EQ(2u, config.get<unsigned int>("Global.nbFrames"));
+  ASSERT_EQ("gradient", config.get<std::string>("Global.syntheticInput"));
+  ASSERT_TRUE(config.get<bool>("Equirectangular.relativeResolution"));
+  ASSERT_DOUBLE_EQ(0.5, config.get<double>("Equirectangular.width"));
+  //the JSON lists are stored as strings, as in the ini file
+  ASSERT_EQ("[[\"input.mp4\",\"Equirectangular\",\"CubeMap\"]]", config.get<std::string>("Global.layoutFlow"));
+}
+
+TEST_F(JobServerTest, invalidJobConfig)
+{
+  ASSERT_THROW(JobServer::ParseJobConfig("{\"Global\": {\"nbFrames\": 2}"), std::invalid_argument);
+  //the values have to be inside a section
+  ASSERT_THROW(JobServer::ParseJobConfig("{\"nbFrames\": 2}"), std::invalid_argument);
+  ASSERT_THROW(JobServer::ParseJobConfig("[{\"nbFrames\": 2}]"), std::invalid_argument);
+}
+
+TEST_F(JobServerTest, invalidAddress)
+{
+  ASSERT_THROW(JobServer("localhost:8080", 1), std::invalid_argument);
+  ASSERT_THROW(JobServer("tcp:http", 1), std::invalid_argument);
+  ASSERT_THROW(JobServer("tcp:70000", 1), std::invalid_argument);
+  ASSERT_THROW(JobServer("unix:", 1), std::invalid_argument);
+}
+
+TEST_F(JobServerTest, processSettingRejected)
+{
+  EXPECT_THROW(JobServer::ParseJobConfig("{\"Global\": {\"nbFrames\": 2, \"nbThreads\": 4}}"), std::invalid_argument);
+  EXPECT_THROW(JobServer::ParseJobConfig("{\"Global\": {\"picturePoolSize\": 0}}"), std::invalid_argument);
+  EXPECT_NO_THROW(JobServer::ParseJobConfig("{\"Equirectangular\": {\"nbThreads\": 4}}"));
+}
+
+TEST_F(JobServerTest, stopServer)
+{
+  JobServer server("unix:"+path, 2);
+  std::thread serveThread([&server] () {server.Serve();});
+  server.Stop();
+  serveThread.join();
+}
+
+TEST_F(JobServerTest, errorEvent)
+{
+  JobServer server("unix:"+path, 1);
+  std::thread serveThread([&server] () {server.Serve();});
+
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+  std::string answer;
+  //two connections one after the other: the thread of the first one is joined when the second one is accepted
+  for (int c = 0; c < 2; ++c)
+  {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    EXPECT_EQ(0, connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+    const std::string job = "{\"Global\": \"not a section\"}\n";
+    if (send(fd, job.data(), job.size(), MSG_NOSIGNAL) == ssize_t(job.size()))
+    {//the job is accepted then fails: two lines
+      std::string connectionAnswer;
+      char buffer[256];
+      ssize_t n;
+      while (std::count(connectionAnswer.begin(), connectionAnswer.end(), '\n') < 2 && (n = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+      {
+        connectionAnswer.append(buffer, n);
+      }
+      answer += connectionAnswer;
+    }
+    close(fd);
+  }
+  //always stopped and joined, even if a check failed
+  server.Stop();
+  serveThread.join();
+  EXPECT_EQ(0u, answer.find("{\"job\": 1, \"event\": \"accepted\"}\n{\"job\": 1, \"event\": \"error\", \"message\": "));
+  EXPECT_NE(std::string::npos, answer.find("{\"job\": 2, \"event\": \"accepted\"}\n{\"job\": 2, \"event\": \"error\", \"message\": "));
+}
@@ -0,0 +1,48 @@
+#include "gtest/gtest.h"
+#include "LayoutCubeMap.hpp"
+#include "LayoutCubeMap2.hpp"
+
+using namespace IMT;
+
+namespace
+{
+  //Faces with different resolutions (Front, Back, Left, Right, Top, Bottom): the faces are centered in their cell and the layout has black pixels
+  const std::array<std::array<unsigned int, 2>,6> pixelEdges = {{ {{40, 30}}, {{20, 20}}, {{36, 36}}, {{24, 28}}, {{30, 40}}, {{15, 13}} }};
+  const std::string facesPosition = "{\"face1\": \"left\", \"face1Rotation\": \"0\", \"face2\": \"front\", \"face2Rotation\": \"0\", \"face3\": \"right\", \"face3Rotation\": \"0\","
+                                    " \"face4\": \"bottom\", \"face4Rotation\": \"-90\", \"face5\": \"back\", \"face5Rotation\": \"90\", \"face6\": \"top\", \"face6Rotation\": \"180\"}";
+
+  /** The face id read in the face raster is the face found by testing the offsets of each face, for each pixel of the layout and the pixels just outside */
+  template<class T>
+  void ExpectRasterMatchesOffsets(const T& layout)
+  {
+    unsigned int nbBlack = 0;
+    for (unsigned int j = 0; j <= layout.GetHeight(); ++j)
+    {
+      for (unsigned int i = 0; i <= layout.GetWidth(); ++i)
+      {
+        auto f = layout.From2dToFaceByOffsets(i, j);
+        ASSERT_EQ(static_cast<int>(f), layout.GetFaceId(CoordI(i, j))) << "pixel (" << i << ", " << j << ")";
+        nbBlack += f == LayoutCubeMapBased::Faces::Black ? 1 : 0;
+      }
+    }
+    EXPECT_GT(nbBlack, 0u);
+  }
+}
+
+TEST(LayoutCubeMapTest, faceRasterCubeMap)
+{
+  auto layout = LayoutCubeMap::GenerateLayout(Quaternion(1), false, std::make_shared<VectorialTrans>(), facesPosition, pixelEdges, false);
+  ExpectRasterMatchesOffsets(*layout);
+}
+
+TEST(LayoutCubeMapTest, faceRasterEquiAngularCubeMap)
+{
+  auto layout = LayoutCubeMap::GenerateLayout(Quaternion(1), false, std::make_shared<VectorialTrans>(), facesPosition, pixelEdges, true);
+  ExpectRasterMatchesOffsets(*layout);
+}
+
+TEST(LayoutCubeMapTest, faceRasterCubeMap2)
+{
+  auto layout = LayoutCubeMap2::GenerateLayout(Quaternion(1), false, std::make_shared<VectorialTrans>(), pixelEdges);
+  ExpectRasterMatchesOffsets(*layout);
+}
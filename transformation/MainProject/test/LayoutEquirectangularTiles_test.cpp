@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+#include "LayoutEquirectangularTiles.hpp"
+
+using namespace IMT;
+
+namespace
+{
+  /** Give access to the mapping functions to compare them with the linear scans of the tiles */
+  class LayoutEquirectangularTilesExposed: public LayoutEquirectangularTiles
+  {
+  public:
+    using LayoutEquirectangularTiles::LayoutEquirectangularTiles;
+    using LayoutEquirectangularTiles::From2dToNormalizedFaceInfo;
+    using LayoutEquirectangularTiles::From3dToNormalizedFaceInfo;
+    using LayoutEquirectangularTiles::FromNormalizedInfoTo2d;
+  };
+
+  /** Linear scan of the tiles in order: first tile whose rectangle (end included) contains the pixel, -1 if none */
+  int ScanTileOfPixel(const LayoutEquirectangularTilesExposed& layout, const CoordI& pixel)
+  {
+    for (unsigned int t = 0; t < layout.GetNbFaces(); ++t)
+    {
+      CoordF start = layout.FromNormalizedInfoTo2d(Layout::NormalizedFaceInfo(CoordF(0, 0), t));
+      CoordF end = layout.FromNormalizedInfoTo2d(Layout::NormalizedFaceInfo(CoordF(1, 1), t));
+      if (start.x <= pixel.x && pixel.x <= end.x && start.y <= pixel.y && pixel.y <= end.y)
+      {
+        return t;
+      }
+    }
+    return -1;
+  }
+
+  /** Linear scan of the cumulated ratios: tile (column or row) containing the normalized angle v and the normalized coordinate in this tile.
+   *  The columns end before their last ratio (strict comparison), the rows include it. */
+  std::pair<unsigned int, double> ScanTileOfAngle(const std::vector<double>& ratios, double v, bool includeEnd)
+  {
+    double sum = 0;
+    for (unsigned int k = 0; k < ratios.size(); ++k)
+    {
+      sum += ratios[k];
+      if (includeEnd ? sum >= v : sum > v)
+      {
+        sum -= ratios[k];
+        return std::make_pair(k, (v-sum)/ratios[k]);
+      }
+    }
+    return std::make_pair(0u, 0.0);
+  }
+}
+
+class LayoutEquirectangularTilesTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+};
+
+
+TEST_F(LayoutEquirectangularTilesTest, nonSquareGrid)
+{
+  //4x2 grid on a 400x200 picture: each tile is 100x100 at full scale, the tile (0,0) is kept at full scale, the others are downscaled by 2
+  LayoutEquirectangularTiles::ScaleTilesMap scaleTiles(4, std::vector<double>(2, 0.5));
+  scaleTiles[0][0] = 1;
+  LayoutEquirectangularTiles::TileRatios tileRatios(std::vector<double>(4, 0.25), std::vector<double>(2, 0.5));
+  LayoutEquirectangularTiles layout(4, 2, scaleTiles, tileRatios, Quaternion(1), std::make_tuple(400u, 200u), true, false, std::make_shared<VectorialTrans>());
+  layout.Init();
+
+  ASSERT_EQ(4u, layout.GetNbHTiles());
+  ASSERT_EQ(2u, layout.GetNbVTiles());
+  ASSERT_EQ(8u, layout.GetNbFaces());
+  ASSERT_EQ("tile_2_1", layout.GetFaceName(5));
+  //columns 100+50+50+50 pixels, rows 100+50 pixels
+  ASSERT_EQ(250u, layout.GetWidth());
+  ASSERT_EQ(150u, layout.GetHeight());
+  //the reference resolution is the resolution of the full scale tile extended to the whole sphere
+  auto refRes = layout.GetReferenceResolution();
+  ASSERT_EQ(400, refRes.x);
+  ASSERT_EQ(200, refRes.y);
+  auto staticRefRes = LayoutEquirectangularTiles::GetReferenceResolution(layout.GetWidth(), layout.GetHeight(), scaleTiles);
+  ASSERT_EQ(400, staticRefRes.x);
+  ASSERT_EQ(200, staticRefRes.y);
+}
+
+TEST_F(LayoutEquirectangularTilesTest, gridMismatch)
+{
+  LayoutEquirectangularTiles::ScaleTilesMap scaleTiles(4, std::vector<double>(2, 1));
+  LayoutEquirectangularTiles::TileRatios tileRatios(std::vector<double>(4, 0.25), std::vector<double>(3, 1.0/3));
+  ASSERT_THROW(LayoutEquirectangularTiles(4, 2, scaleTiles, tileRatios, Quaternion(1), std::make_tuple(400u, 200u), true, false, std::make_shared<VectorialTrans>()), std::invalid_argument);
+}
+
+TEST_F(LayoutEquirectangularTilesTest, lookupTablesMatchScan)
+{
+  //non-uniform 4x3 grid with different scales: the tiles are centered in their column and row
+  const std::vector<double> hRatios = {0.1, 0.35, 0.05, 0.5};
+  const std::vector<double> vRatios = {0.2, 0.3, 0.5};
+  LayoutEquirectangularTiles::ScaleTilesMap scaleTiles = {{1, 0.5, 0.25}, {0.5, 1, 0.75}, {0.25, 0.25, 1}, {1, 0.5, 0.5}};
+  LayoutEquirectangularTilesExposed layout(4, 3, scaleTiles, LayoutEquirectangularTiles::TileRatios(hRatios, vRatios), Quaternion(1), std::make_tuple(400u, 200u), true, false, std::make_shared<VectorialTrans>());
+  layout.Init();
+
+  //pixels: the shared borders (end included) and the gaps between the centered tiles
+  for (unsigned int j = 0; j <= layout.GetHeight(); ++j)
+  {
+    for (unsigned int i = 0; i <= layout.GetWidth(); ++i)
+    {
+      ASSERT_EQ(ScanTileOfPixel(layout, CoordI(i, j)), layout.From2dToNormalizedFaceInfo(CoordI(i, j)).m_faceId) << "pixel (" << i << ", " << j << ")";
+    }
+  }
+
+  //directions: dense sampling of the sphere, the angle bins and the tile borders (without the poles, where the longitude is not defined)
+  const unsigned int nbTheta = 2000;
+  const unsigned int nbPhi = 1001;
+  for (unsigned int b = 1; b < nbPhi; ++b)
+  {
+    for (unsigned int a = 0; a < nbTheta; ++a)
+    {
+      Coord3dCart coord = Coord3dCart::FromSpherical(2*PI()*a/nbTheta-PI(), PI()*b/nbPhi);
+      double i = 0.5+coord.GetTheta()/(2.0*PI());
+      double j = coord.GetPhi()/PI();
+      auto col = ScanTileOfAngle(hRatios, i, false);
+      auto row = ScanTileOfAngle(vRatios, j, true);
+      auto ni = layout.From3dToNormalizedFaceInfo(coord);
+      ASSERT_EQ(int(col.first*vRatios.size()+row.first), ni.m_faceId) << "theta " << coord.GetTheta() << " phi " << coord.GetPhi();
+      ASSERT_DOUBLE_EQ(col.second, ni.m_normalizedFaceCoordinate.x);
+      ASSERT_DOUBLE_EQ(row.second, ni.m_normalizedFaceCoordinate.y);
+    }
+  }
+}
@@ -0,0 +1,53 @@
+#include <cmath>
+#include "gtest/gtest.h"
+#include "LayoutEquirectangular.hpp"
+#include "LayoutCubeMap.hpp"
+
+using namespace IMT;
+
+class LayoutGeometryPrecisionTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    equirectangular = std::make_shared<LayoutEquirectangular>(200, 100, Quaternion::FromEuler(0.3, 0.2, 0.1), std::make_shared<VectorialTrans>());
+    equirectangular->Init();
+  }
+
+  virtual void TearDown()
+  {}
+
+  std::shared_ptr<LayoutEquirectangular> equirectangular;
+};
+
+
+TEST_F(LayoutGeometryPrecisionTest, roundTripF32)
+{
+  //pixel -> sphere -> pixel with the float32 geometry stays close to the same round trip with the double geometry (the row 0 is the pole: no longitude)
+  for (int j = 1; j < 100; j += 3)
+  {
+    for (int i = 1; i < 199; i += 3)
+    {
+      CoordF coordDouble = equirectangular->FromSphereTo2d(equirectangular->From2dTo3d(CoordI(i, j)));
+      CoordF coordFloat = equirectangular->FromSphereTo2dF32(equirectangular->From2dTo3dF32(CoordI(i, j)));
+      EXPECT_NEAR(coordDouble.x, coordFloat.x, 1e-2);
+      EXPECT_NEAR(coordDouble.y, coordFloat.y, 1e-2);
+    }
+  }
+}
+
+TEST_F(LayoutGeometryPrecisionTest, precisionError)
+{
+  LayoutEquirectangular destLayout(100, 50, Quaternion::FromEuler(-0.5, 0.1, 0), std::make_shared<VectorialTrans>());
+  destLayout.Init();
+  double error = equirectangular->GetGeometryPrecisionError(destLayout);
+  EXPECT_GE(error, 0);
+  EXPECT_LT(error, 0.05);
+}
+
+TEST_F(LayoutGeometryPrecisionTest, wrapsHorizontally)
+{
+  EXPECT_TRUE(equirectangular->WrapsHorizontally());
+  LayoutCubeMap cubeMap(64, false, std::make_shared<VectorialTrans>());
+  EXPECT_FALSE(cubeMap.WrapsHorizontally());
+}
@@ -0,0 +1,48 @@
+#include <cmath>
+#include "gtest/gtest.h"
+#include "LayoutPyramidal.hpp"
+
+using namespace IMT;
+
+class LayoutPyramidalTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    rotation = Quaternion::FromEuler(0.8, -0.3, 0.2);
+    layout = std::make_shared<LayoutPyramidal>(2.5, Quaternion(1), false, std::make_shared<VectorialTrans>(), 40);
+    layout->Init();
+    rotatedLayout = std::make_shared<LayoutPyramidal>(2.5, rotation, false, std::make_shared<VectorialTrans>(), 40);
+    rotatedLayout->Init();
+  }
+
+  virtual void TearDown()
+  {}
+
+  Quaternion rotation;
+  std::shared_ptr<Layout> layout;
+  std::shared_ptr<Layout> rotatedLayout;
+};
+
+
+TEST_F(LayoutPyramidalTest, rotationMatchesQuaternion)
+{
+  //the cached rotation matrix of the rotated layout moves the points of the canonical layout as the quaternion
+  for (int j = 0; j < 40; j += 3)
+  {
+    for (int i = 0; i < 120; i += 3)
+    {
+      Coord3dCart point = layout->From2dTo3d(CoordI(i, j));
+      EXPECT_LT((rotatedLayout->From2dTo3d(CoordI(i, j)) - Rotation(point, rotation)).Norm(), 1e-9);
+    }
+  }
+  //and its inverse brings the rotated directions back (generic directions: the top of the pyramid is at several positions of the layout)
+  for (int k = 0; k < 500; ++k)
+  {
+    Coord3dCart point(std::cos(0.7*k)*std::sin(0.006*k+0.01), std::sin(0.7*k)*std::sin(0.006*k+0.01), std::cos(0.006*k+0.01));
+    CoordF coord = layout->FromSphereTo2d(point);
+    CoordF rotatedCoord = rotatedLayout->FromSphereTo2d(Rotation(point, rotation));
+    EXPECT_NEAR(coord.x, rotatedCoord.x, 1e-6);
+    EXPECT_NEAR(coord.y, rotatedCoord.y, 1e-6);
+  }
+}
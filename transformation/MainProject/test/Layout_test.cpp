@@ -79,10 +79,10 @@ std::tuple<std::shared_ptr<Layout>,std::shared_ptr<Layout>, CoordF> GetLayout<La
 }
 
 template<>
-std::tuple<std::shared_ptr<Layout>,std::shared_ptr<Layout>, CoordF> GetLayout<LayoutEquirectangularTiles<2,2>>(unsigned int w, unsigned int h, double vectRatio)
+std::tuple<std::shared_ptr<Layout>,std::shared_ptr<Layout>, CoordF> GetLayout<LayoutEquirectangularTiles>(unsigned int w, unsigned int h, double vectRatio)
 {
-  std::shared_ptr<Layout> equirect = std::make_shared<LayoutEquirectangularTiles<2,2>>(LayoutEquirectangularTiles<2,2>::ScaleTilesMap({{ {{1, 1}}, {{1, 1}} }}), std::make_tuple(std::array<double, 2>({{0.5, 0.5}}), std::array<double, 2>({{0.5, 0.5}})),  Quaternion(1),  std::make_tuple(w,h), false, false, 0);
-  std::shared_ptr<Layout> equirectOffet = std::make_shared<LayoutEquirectangularTiles<2,2>>(LayoutEquirectangularTiles<2,2>::ScaleTilesMap({{ {{1, 1}}, {{1, 1}}}}), std::make_tuple(std::array<double, 2>({{0.5, 0.5}}), std::array<double, 2>({{0.5, 0.5}})),  Quaternion(1),  std::make_tuple(w,h), false, false, vectRatio);
+  std::shared_ptr<Layout> equirect = std::make_shared<LayoutEquirectangularTiles>(2, 2, LayoutEquirectangularTiles::ScaleTilesMap({{1, 1}, {1, 1}}), std::make_tuple(std::vector<double>({0.5, 0.5}), std::vector<double>({0.5, 0.5})),  Quaternion(1),  std::make_tuple(w,h), false, false, 0);
+  std::shared_ptr<Layout> equirectOffet = std::make_shared<LayoutEquirectangularTiles>(2, 2, LayoutEquirectangularTiles::ScaleTilesMap({{1, 1}, {1, 1}}), std::make_tuple(std::vector<double>({0.5, 0.5}), std::vector<double>({0.5, 0.5})),  Quaternion(1),  std::make_tuple(w,h), false, false, vectRatio);
   return std::make_tuple(equirect, equirectOffet, CoordF(w/2, h/2));
 }
 
@@ -98,7 +98,7 @@ static bool
            || std::abs(x.x-x.y) < std::numeric_limits<float>::min());
 }
 
-typedef ::testing::Types<LayoutEquirectangular, LayoutCubeMap2, LayoutCubeMap, LayoutPyramidal, LayoutPyramidal2, LayoutEquirectangularTiles<2,2>> MyTypes;
+typedef ::testing::Types<LayoutEquirectangular, LayoutCubeMap2, LayoutCubeMap, LayoutPyramidal, LayoutPyramidal2, LayoutEquirectangularTiles> MyTypes;
 TYPED_TEST_CASE(LayoutTest, MyTypes);
 
 TYPED_TEST(LayoutTest, withoutOffset)
@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "MultiViewportQuality.hpp"
+#include "LayoutEquirectangular.hpp"
+#include "LayoutFlatFixed.hpp"
+
+using namespace IMT;
+
+class MultiViewportQualityTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {//one static user looking at the center of the equirectangular picture, one user looking behind
+    const std::string prefix = "/tmp/trans_MultiViewportQuality_test_"+std::to_string(getpid());
+    pathToTraces = {prefix+"_user1.txt", prefix+"_user2.txt"};
+    pathToOutput = prefix+"_quality.txt";
+    std::ofstream(pathToTraces[0]) << "0 0 1 0 0 0" << std::endl << "10 250 1 0 0 0" << std::endl;
+    std::ofstream(pathToTraces[1]) << "0 0 0 0 0 1" << std::endl << "10 250 0 0 0 1" << std::endl;
+    viewportGeometry = std::make_shared<LayoutFlatFixed>(DynamicPosition(Quaternion::FromEuler(0, 0, 0)), 64, 48, PI()/2, PI()/3);
+    viewportGeometry->Init();
+    for (unsigned int f = 0; f < 3; ++f)
+    {
+      finalLayouts.push_back(std::make_shared<LayoutEquirectangular>(200, 100, Quaternion(1), std::make_shared<VectorialTrans>()));
+      finalLayouts.back()->Init();
+    }
+  }
+
+  virtual void TearDown()
+  {
+    for (const auto& path: pathToTraces)
+    {
+      std::remove(path.c_str());
+    }
+    std::remove(pathToOutput.c_str());
+  }
+
+  /** Uniform gray picture: the extracted viewports are uniform whatever the interpolation */
+  std::shared_ptr<Picture> GetGrayPicture(unsigned char value) const
+  {
+    return std::make_shared<Picture>(cv::Mat(100, 200, CV_8UC3, cv::Scalar(value, value, value)));
+  }
+
+  std::vector<std::string> pathToTraces;
+  std::string pathToOutput;
+  std::shared_ptr<Layout> viewportGeometry;
+  std::vector<std::shared_ptr<Layout>> finalLayouts;
+};
+
+
+TEST_F(MultiViewportQualityTest, knownDistortion)
+{
+  {
+    MultiViewportQuality multiViewportQuality(pathToTraces, viewportGeometry, pathToOutput, Picture::InterpolationTech::BILINEAR);
+    ASSERT_EQ(2u, multiViewportQuality.GetNbUsers());
+    multiViewportQuality.NextStep(0);
+    //flow 2 is identical to the reference, flow 3 has a luma error of 10 on each pixel
+    multiViewportQuality.ComputeQuality(0, {GetGrayPicture(100), GetGrayPicture(100), GetGrayPicture(110)}, finalLayouts);
+  }
+  std::ifstream output(pathToOutput);
+  std::string line;
+  ASSERT_TRUE(std::getline(output, line));
+  ASSERT_EQ("frame user flow PSNR SSIM", line);
+  unsigned int nbLines = 0;
+  while (std::getline(output, line))
+  {
+    std::istringstream ss(line);
+    unsigned int frameId, user, flow;
+    double psnr, ssim;
+    ss >> frameId >> user >> flow >> psnr >> ssim;
+    ASSERT_EQ(0u, frameId);
+    ASSERT_EQ(nbLines/2, user);
+    ASSERT_EQ(2+nbLines%2, flow);
+    if (flow == 2)
+    {//max score: PSNR of identical pictures and SSIM of 1
+      ASSERT_DOUBLE_EQ(100, psnr);
+      ASSERT_NEAR(1, ssim, 1e-6);
+    }
+    else
+    {//MSE = 100
+      ASSERT_NEAR(10*std::log10(255.0*255.0/100), psnr, 1e-3);
+      ASSERT_LT(ssim, 1);
+      ASSERT_GT(ssim, 0.9);
+    }
+    ++nbLines;
+  }
+  ASSERT_EQ(4u, nbLines);
+}
+
+TEST_F(MultiViewportQualityTest, oneLayoutPerPicture)
+{
+  MultiViewportQuality multiViewportQuality(pathToTraces, viewportGeometry, pathToOutput, Picture::InterpolationTech::BILINEAR);
+  multiViewportQuality.NextStep(0);
+  ASSERT_THROW(multiViewportQuality.ComputeQuality(0, {GetGrayPicture(100), GetGrayPicture(100)}, finalLayouts), std::invalid_argument);
+}
@@ -0,0 +1,98 @@
+#include <memory>
+#include "gtest/gtest.h"
+#include "PicturePool.hpp"
+#include "ScratchArena.hpp"
+
+using namespace IMT;
+
+class PicturePoolTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+};
+
+
+TEST_F(PicturePoolTest, buffersRecycled)
+{
+  auto pool = std::make_shared<PicturePool>(4);
+  const unsigned char* data = nullptr;
+  for (int frame = 0; frame < 10; ++frame)
+  {
+    auto pict = pool->Get(16, 32, CV_8UC3);
+    ASSERT_EQ(32, pict->GetWidth());
+    ASSERT_EQ(16, pict->GetHeight());
+    if (data != nullptr)
+    {//same buffer for each frame
+      ASSERT_EQ(data, pict->GetMat().data);
+    }
+    data = pict->GetMat().data;
+  }
+  ASSERT_EQ(size_t(1), pool->GetNbAllocations());
+  ASSERT_EQ(size_t(1), pool->GetNbFreeBuffers());
+  //another size: another buffer
+  pool->Get(8, 8, CV_8UC3);
+  ASSERT_EQ(size_t(2), pool->GetNbAllocations());
+  ASSERT_EQ(size_t(2), pool->GetNbFreeBuffers());
+}
+
+TEST_F(PicturePoolTest, sharedBufferNotRecycled)
+{
+  auto pool = std::make_shared<PicturePool>(4);
+  cv::Mat kept;
+  {
+    auto pict = pool->Get(16, 32, CV_8UC3);
+    kept = pict->GetMat();
+  }
+  ASSERT_EQ(size_t(0), pool->GetNbFreeBuffers());
+  auto pict = pool->Get(16, 32, CV_8UC3);
+  ASSERT_NE(kept.data, pict->GetMat().data);
+  //a picture can outlive its pool
+  pool.reset();
+  pict.reset();
+}
+
+TEST_F(PicturePoolTest, maxFreeBuffers)
+{
+  auto pool = std::make_shared<PicturePool>(2);
+  {
+    std::vector<std::shared_ptr<Picture>> picts;
+    for (int i = 0; i < 5; ++i)
+    {
+      picts.push_back(pool->Get(4, 4, CV_8UC3));
+    }
+  }
+  ASSERT_EQ(size_t(5), pool->GetNbAllocations());
+  ASSERT_EQ(size_t(2), pool->GetNbFreeBuffers());
+}
+
+TEST_F(PicturePoolTest, scratchArenaScopes)
+{
+  ScratchArena arena;
+  const unsigned char* outer = nullptr;
+  const unsigned char* inner = nullptr;
+  for (int frame = 0; frame < 5; ++frame)
+  {
+    ScratchArena::Scope scope(arena);
+    cv::Mat a = arena.GetMat(10, 10, CV_32FC3);
+    {
+      ScratchArena::Scope innerScope(arena);
+      cv::Mat b = arena.GetMat(10, 10, CV_32FC3);
+      cv::Mat c = arena.GetMat(5, 5, CV_8UC3);
+      ASSERT_NE(a.data, b.data);
+      inner = b.data;
+    }
+    //the matrices of the inner scope are reused
+    cv::Mat d = arena.GetMat(10, 10, CV_32FC3);
+    ASSERT_EQ(inner, d.data);
+    if (outer != nullptr)
+    {
+      ASSERT_EQ(outer, a.data);
+    }
+    outer = a.data;
+  }
+  ASSERT_EQ(size_t(3), arena.GetNbAllocations());
+}
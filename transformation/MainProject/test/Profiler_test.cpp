@@ -0,0 +1,132 @@
+#include <sstream>
+#include <thread>
+#include "gtest/gtest.h"
+#include "Profiler.hpp"
+
+using namespace IMT;
+
+class ProfilerTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    Profiler::GetDefault().Clear();
+    Profiler::GetDefault().SetEnabled(true);
+  }
+
+  virtual void TearDown()
+  {
+    Profiler::GetDefault().SetEnabled(false);
+    Profiler::GetDefault().Clear();
+  }
+};
+
+
+TEST_F(ProfilerTest, addAndTotal)
+{
+  Profiler profiler;
+  profiler.Add(Profiler::Kind::COUNTER, 0, "bytes", 10);
+  profiler.Add(Profiler::Kind::COUNTER, 0, "bytes", 5);
+  profiler.Add(Profiler::Kind::COUNTER, 1, "bytes", 20);
+  profiler.Add(Profiler::Kind::TIMER, 1, "decode", 0.5);
+  ASSERT_DOUBLE_EQ(35, profiler.GetTotal(Profiler::Kind::COUNTER, "bytes"));
+  ASSERT_DOUBLE_EQ(0.5, profiler.GetTotal(Profiler::Kind::TIMER, "decode"));
+  ASSERT_DOUBLE_EQ(0, profiler.GetTotal(Profiler::Kind::TIMER, "bytes"));
+  profiler.Clear();
+  ASSERT_DOUBLE_EQ(0, profiler.GetTotal(Profiler::Kind::COUNTER, "bytes"));
+}
+
+TEST_F(ProfilerTest, frameScope)
+{
+  //outside of a frame scope the measures are ignored
+  Profiler::AddCount("pixels", 1);
+  {
+    Profiler::FrameScope scope(3);
+    Profiler::AddCount("pixels", 10);
+    {
+      Profiler::FrameScope innerScope(4);
+      Profiler::AddCount("pixels", 100);
+    }
+    Profiler::AddCount("pixels", 1000);
+    //the frame scope is per thread
+    std::thread t([](){Profiler::AddCount("pixels", 10000);});
+    t.join();
+    ASSERT_EQ(42, Profiler::Time("timer", [](){return 42;}));
+  }
+  ASSERT_DOUBLE_EQ(1110, Profiler::GetDefault().GetTotal(Profiler::Kind::COUNTER, "pixels"));
+  ASSERT_GE(Profiler::GetDefault().GetTotal(Profiler::Kind::TIMER, "timer"), 0);
+
+  std::ostringstream frames, summary;
+  Profiler::GetDefault().WriteCSV(frames, summary);
+  ASSERT_NE(std::string::npos, frames.str().find("3 counter pixels 1010\n"));
+  ASSERT_NE(std::string::npos, frames.str().find("4 counter pixels 100\n"));
+  ASSERT_NE(std::string::npos, frames.str().find("3 timer timer "));
+}
+
+TEST_F(ProfilerTest, disabled)
+{
+  Profiler::GetDefault().SetEnabled(false);
+  Profiler::FrameScope scope(0);
+  Profiler::AddCount("pixels", 10);
+  Profiler::AddTime("decode", 1);
+  {
+    Profiler::ScopedTimer timer("encode");
+  }
+  ASSERT_DOUBLE_EQ(0, Profiler::GetDefault().GetTotal(Profiler::Kind::COUNTER, "pixels"));
+  ASSERT_DOUBLE_EQ(0, Profiler::GetDefault().GetTotal(Profiler::Kind::TIMER, "decode"));
+  ASSERT_DOUBLE_EQ(0, Profiler::GetDefault().GetTotal(Profiler::Kind::TIMER, "encode"));
+}
+
+TEST_F(ProfilerTest, profilerPerScope)
+{
+  //two jobs measuring the same frames in their own profilers
+  Profiler profiler1, profiler2;
+  profiler1.SetEnabled(true);
+  profiler2.SetEnabled(true);
+  std::thread t([&profiler2]()
+  {
+    Profiler::FrameScope scope(0, profiler2);
+    Profiler::AddCount("pixels", 2);
+  });
+  {
+    Profiler::FrameScope scope(0, profiler1);
+    Profiler::AddCount("pixels", 1);
+    {//the inner scope keeps the profiler of the outer scope
+      Profiler::FrameScope innerScope(1);
+      Profiler::AddCount("pixels", 10);
+    }
+  }
+  t.join();
+  Profiler::FrameScope defaultScope(0);
+  Profiler::AddCount("pixels", 100);
+  EXPECT_DOUBLE_EQ(11, profiler1.GetTotal(Profiler::Kind::COUNTER, "pixels"));
+  EXPECT_DOUBLE_EQ(2, profiler2.GetTotal(Profiler::Kind::COUNTER, "pixels"));
+  EXPECT_DOUBLE_EQ(100, Profiler::GetDefault().GetTotal(Profiler::Kind::COUNTER, "pixels"));
+  //a disabled profiler ignores the measures even if the default one is enabled
+  Profiler disabledProfiler;
+  {
+    Profiler::FrameScope scope(0, disabledProfiler);
+    Profiler::AddCount("pixels", 1000);
+  }
+  EXPECT_DOUBLE_EQ(0, disabledProfiler.GetTotal(Profiler::Kind::COUNTER, "pixels"));
+  EXPECT_DOUBLE_EQ(100, Profiler::GetDefault().GetTotal(Profiler::Kind::COUNTER, "pixels"));
+}
+
+TEST_F(ProfilerTest, aggregates)
+{
+  Profiler profiler;
+  for (int frameId = 0; frameId < 100; ++frameId)
+  {
+    profiler.Add(Profiler::Kind::TIMER, frameId, "decode", frameId+1);
+  }
+  std::ostringstream frames, summary;
+  profiler.WriteCSV(frames, summary);
+  const std::string expectedSummary = "kind name frames total mean min p50 p90 p99 max\ntimer decode 100 5050 50.5 1 ";
+  ASSERT_EQ(expectedSummary, summary.str().substr(0, expectedSummary.size()));
+
+  std::ostringstream json;
+  profiler.WriteJSON(json);
+  ASSERT_NE(std::string::npos, json.str().find("{\"frame\": 99, \"timers\": {\"decode\": 100}, \"counters\": {}}"));
+  ASSERT_NE(std::string::npos, json.str().find("\"decode\": {\"frames\": 100, \"total\": 5050, \"mean\": 50.5, \"min\": 1"));
+  ASSERT_NE(std::string::npos, json.str().find("\"max\": 100}"));
+}
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "QualityWindowAggregator.hpp"
+
+using namespace IMT;
+
+class QualityWindowAggregatorTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    pathToOutput = "/tmp/trans_QualityWindowAggregator_test_"+std::to_string(getpid())+".csv";
+  }
+
+  virtual void TearDown()
+  {
+    std::remove(pathToOutput.c_str());
+  }
+
+  std::string pathToOutput;
+};
+
+
+TEST_F(QualityWindowAggregatorTest, commaSeparatedOutput)
+{
+  {
+    QualityWindowAggregator aggregator(pathToOutput, {"PSNR", "SSIM"}, {0.5}, {2}, {50}, QualityWindowAggregator::OutputFormat::CSV);
+    aggregator.AddFrame(0, {30, 0.5});
+    aggregator.AddFrame(1, {40, 1});
+  }
+  std::ifstream output(pathToOutput);
+  std::string line;
+  ASSERT_TRUE(std::getline(output, line));
+  EXPECT_EQ("frame,window,metric,mean,min,max,p50", line);
+  ASSERT_TRUE(std::getline(output, line));
+  EXPECT_EQ("1,0.5,PSNR,35,30,40,35", line);
+  ASSERT_TRUE(std::getline(output, line));
+  EXPECT_EQ("1,0.5,SSIM,0.75,0.5,1,0.75", line);
+  EXPECT_FALSE(std::getline(output, line));
+}
+
+TEST_F(QualityWindowAggregatorTest, nonFiniteValueSkipped)
+{
+  {
+    QualityWindowAggregator aggregator(pathToOutput, {"PSNR"}, {0.5}, {2}, {50}, QualityWindowAggregator::OutputFormat::CSV);
+    aggregator.AddFrame(0, {30});
+    aggregator.AddFrame(1, {std::numeric_limits<double>::infinity()});
+    aggregator.AddFrame(2, {40});
+  }
+  std::ifstream output(pathToOutput);
+  std::string line;
+  ASSERT_TRUE(std::getline(output, line));
+  ASSERT_TRUE(std::getline(output, line));
+  EXPECT_EQ("2,0.5,PSNR,35,30,40,35", line);
+  EXPECT_FALSE(std::getline(output, line));
+}
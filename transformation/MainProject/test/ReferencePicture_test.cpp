@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include "ReferencePicture.hpp"
+#include "LayoutEquirectangular.hpp"
+
+using namespace IMT;
+
+class ReferencePictureTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    layoutRef = std::make_shared<LayoutEquirectangular>(200, 100, Quaternion(1), std::make_shared<VectorialTrans>());
+    layoutRef->Init();
+    layoutHalf = std::make_shared<LayoutEquirectangular>(100, 50, Quaternion(1), std::make_shared<VectorialTrans>());
+    layoutHalf->Init();
+    pictRef = GetPicture(200, 100, 0);
+  }
+
+  virtual void TearDown()
+  {}
+
+  /** Deterministic textured picture: the seed changes the texture */
+  static std::shared_ptr<Picture> GetPicture(int width, int height, int seed)
+  {
+    cv::Mat mat(height, width, CV_8UC3);
+    for (int j = 0; j < height; ++j)
+    {
+      for (int i = 0; i < width; ++i)
+      {
+        mat.at<Pixel>(j, i) = Pixel((7*i+3*j+seed) % 256, (i*j+5*seed) % 256, (11*i+13*j+7*seed) % 256);
+      }
+    }
+    return std::make_shared<Picture>(mat);
+  }
+
+  std::shared_ptr<Layout> layoutRef;
+  std::shared_ptr<Layout> layoutHalf;
+  std::shared_ptr<Picture> pictRef;
+};
+
+
+TEST_F(ReferencePictureTest, sameMeasuresAsPicture)
+{
+  ReferencePicture refPict(pictRef);
+  auto pict = GetPicture(200, 100, 1);
+  //twice: the second measures use the cached preprocessing of the reference
+  for (int k = 0; k < 2; ++k)
+  {
+    EXPECT_DOUBLE_EQ(pictRef->GetPSNR(*pict), refPict.GetPSNR(*pict));
+    EXPECT_DOUBLE_EQ(pictRef->GetSSIM(*pict), refPict.GetSSIM(*pict));
+    EXPECT_DOUBLE_EQ(pictRef->GetMSSSIM(*pict), refPict.GetMSSSIM(*pict));
+    EXPECT_DOUBLE_EQ(pictRef->GetWSPSNR(*pict, *layoutRef, *layoutRef), refPict.GetWSPSNR(*pict, *layoutRef, *layoutRef));
+    EXPECT_DOUBLE_EQ(pictRef->GetSPSNR(*pict, *layoutRef, *layoutRef, Picture::InterpolationTech::BICUBIC, 10000),
+                     refPict.GetSPSNR(*pict, *layoutRef, *layoutRef, Picture::InterpolationTech::BICUBIC, 10000));
+  }
+}
+
+TEST_F(ReferencePictureTest, sharedByFlows)
+{
+  ReferencePicture refPict(pictRef);
+  //flows with another final layout and another tested picture reuse the same reference samples
+  auto pictHalf = GetPicture(100, 50, 2);
+  auto pictFull = GetPicture(200, 100, 3);
+  EXPECT_DOUBLE_EQ(pictRef->GetSPSNR(*pictHalf, *layoutRef, *layoutHalf, Picture::InterpolationTech::BILINEAR, 10000),
+                   refPict.GetSPSNR(*pictHalf, *layoutRef, *layoutHalf, Picture::InterpolationTech::BILINEAR, 10000));
+  EXPECT_DOUBLE_EQ(pictRef->GetSPSNR(*pictFull, *layoutRef, *layoutRef, Picture::InterpolationTech::BILINEAR, 10000),
+                   refPict.GetSPSNR(*pictFull, *layoutRef, *layoutRef, Picture::InterpolationTech::BILINEAR, 10000));
+  EXPECT_DOUBLE_EQ(pictRef->GetPSNR(*pictFull), refPict.GetPSNR(*pictFull));
+  EXPECT_DOUBLE_EQ(pictRef->GetSSIM(*pictFull), refPict.GetSSIM(*pictFull));
+}
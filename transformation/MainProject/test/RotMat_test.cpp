@@ -0,0 +1,52 @@
+#include <limits.h>
+#include "gtest/gtest.h"
+#include "RotMat.hpp"
+#include "Common.hpp"
+
+using namespace IMT;
+
+class RotMatTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+};
+
+
+TEST_F(RotMatTest, fromQuaternion)
+{
+  auto q = Quaternion::QuaternionFromAngleAxis(PI()/3, VectorCartesian(1, 2, 3));
+  VectorCartesian v(1, 2, 3);
+  ASSERT_LT((RotMat::FromQuaternion(q)*v - q.Rotation(v)).Norm(), 1e-12);
+  VectorCartesian w(-0.5, 0.25, 2);
+  ASSERT_LT((RotMat::FromQuaternion(q)*w - q.Rotation(w)).Norm(), 1e-12);
+  //not normalized quaternion
+  ASSERT_LT((RotMat::FromQuaternion(q*2.0)*w - (q*2.0).Rotation(w)).Norm(), 1e-12);
+}
+
+TEST_F(RotMatTest, inverse)
+{
+  auto r = RotMat::FromQuaternion(Quaternion::QuaternionFromAngleAxis(PI()/5, VectorCartesian(0, 1, 1)));
+  VectorCartesian v(1, -2, 0.5);
+  ASSERT_LT((r.Transpose()*(r*v) - v).Norm(), 1e-12);
+  ASSERT_LT(((r.Inv()*r)*v - v).Norm(), 1e-12);
+}
+
+TEST_F(RotMatTest, constexprTable)
+{
+  static constexpr RotMat rightFace(0, -1, 0,   1, 0, 0,   0, 0, 1);
+  constexpr VectorCartesian v = rightFace*VectorCartesian(1, 0, 0);
+  ASSERT_EQ(VectorCartesian(0, 1, 0), v);
+}
+
+TEST_F(RotMatTest, float32)
+{
+  auto q = Quaternion::QuaternionFromAngleAxis(PI()/7, VectorCartesian(-1, 0.5, 2));
+  RotMatF32 rf(RotMat::FromQuaternion(q));
+  ASSERT_LT((VectorCartesian(rf*VectorCartesianF32(0.25f, -0.5f, 1.f)) - q.Rotation(VectorCartesian(0.25, -0.5, 1))).Norm(), 1e-6);
+  //Same matrix from the float32 quaternion
+  ASSERT_LT((VectorCartesian(RotMatF32::FromQuaternion(QuaternionF32(q))*VectorCartesianF32(1.f, 0.f, 0.f)) - q.Rotation(VectorCartesian(1, 0, 0))).Norm(), 1e-6);
+}
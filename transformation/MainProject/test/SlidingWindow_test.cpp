@@ -0,0 +1,92 @@
+#include <limits>
+#include "gtest/gtest.h"
+#include "SlidingWindow.hpp"
+
+using namespace IMT;
+
+class SlidingWindowTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+};
+
+
+TEST_F(SlidingWindowTest, partialWindow)
+{
+  SlidingWindow sw(4);
+  ASSERT_TRUE(sw.IsEmpty());
+  sw.Push(3);
+  sw.Push(1);
+  ASSERT_FALSE(sw.IsFull());
+  ASSERT_EQ(2u, sw.GetNbValues());
+  ASSERT_DOUBLE_EQ(2, sw.GetMean());
+  ASSERT_DOUBLE_EQ(1, sw.GetMin());
+  ASSERT_DOUBLE_EQ(3, sw.GetMax());
+  ASSERT_DOUBLE_EQ(2, sw.GetPercentile(50));
+}
+
+TEST_F(SlidingWindowTest, oldestValueRemoved)
+{
+  SlidingWindow sw(3);
+  for (auto v: {5.0, 1.0, 4.0, 2.0, 8.0})
+  {
+    sw.Push(v);
+  }
+  //window contains 4 2 8
+  ASSERT_TRUE(sw.IsFull());
+  ASSERT_EQ(3u, sw.GetNbValues());
+  ASSERT_DOUBLE_EQ(14.0/3, sw.GetMean());
+  ASSERT_DOUBLE_EQ(2, sw.GetMin());
+  ASSERT_DOUBLE_EQ(8, sw.GetMax());
+  ASSERT_DOUBLE_EQ(4, sw.GetPercentile(50));
+  ASSERT_DOUBLE_EQ(3, sw.GetPercentile(25));
+  ASSERT_DOUBLE_EQ(2, sw.GetPercentile(0));
+  ASSERT_DOUBLE_EQ(8, sw.GetPercentile(100));
+}
+
+TEST_F(SlidingWindowTest, duplicatedValues)
+{
+  SlidingWindow sw(2);
+  sw.Push(1);
+  sw.Push(1);
+  sw.Push(3);
+  ASSERT_DOUBLE_EQ(1, sw.GetMin());
+  ASSERT_DOUBLE_EQ(3, sw.GetMax());
+  ASSERT_DOUBLE_EQ(2, sw.GetMean());
+}
+
+TEST_F(SlidingWindowTest, nullSize)
+{
+  ASSERT_THROW(SlidingWindow(0), std::invalid_argument);
+}
+
+TEST_F(SlidingWindowTest, noSumDrift)
+{
+  SlidingWindow sw(2);
+  //the running sum cannot hold 1e17+1: without recomputation the mean of the last window would be 0.5
+  sw.Push(1e17);
+  sw.Push(1);
+  sw.Push(1);
+  sw.Push(1);
+  ASSERT_DOUBLE_EQ(1, sw.GetMean());
+}
+
+TEST_F(SlidingWindowTest, nonFiniteValuesSkipped)
+{
+  SlidingWindow sw(2);
+  ASSERT_TRUE(sw.Push(1));
+  ASSERT_FALSE(sw.Push(std::numeric_limits<double>::quiet_NaN()));
+  ASSERT_FALSE(sw.Push(std::numeric_limits<double>::infinity()));
+  ASSERT_FALSE(sw.Push(-std::numeric_limits<double>::infinity()));
+  ASSERT_EQ(1u, sw.GetNbValues());
+  ASSERT_TRUE(sw.Push(3));
+  ASSERT_TRUE(sw.Push(5));
+  //the oldest finite value is removed
+  ASSERT_DOUBLE_EQ(4, sw.GetMean());
+  ASSERT_DOUBLE_EQ(3, sw.GetMin());
+  ASSERT_DOUBLE_EQ(5, sw.GetMax());
+}
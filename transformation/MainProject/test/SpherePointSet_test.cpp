@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "SpherePointSet.hpp"
+
+using namespace IMT;
+
+class SpherePointSetTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+};
+
+
+TEST_F(SpherePointSetTest, uniformDistribution)
+{
+  auto pointSet = SpherePointSet::Get(10000);
+  ASSERT_EQ(10000u, pointSet->GetNbPoints());
+  Coord3dCart barycenter;
+  unsigned long nbNorth = 0;
+  for (unsigned long p = 0; p < pointSet->GetNbPoints(); ++p)
+  {
+    auto v = pointSet->GetPoint(p);
+    ASSERT_TRUE(inInterval(v.GetPhi(), 0, PI()));
+    ASSERT_TRUE(inInterval(v.GetTheta(), -PI(), PI()));
+    barycenter = barycenter + v;
+    nbNorth += v.GetPhi() < PI()/2 ? 1 : 0;
+  }
+  ASSERT_LT((barycenter/pointSet->GetNbPoints()).Norm(), 1e-3);
+  ASSERT_EQ(5000u, nbNorth);
+}
+
+TEST_F(SpherePointSetTest, sharedPointSet)
+{
+  ASSERT_EQ(SpherePointSet::Get(42), SpherePointSet::Get(42));
+  ASSERT_THROW(SpherePointSet(0), std::invalid_argument);
+}
@@ -0,0 +1,139 @@
+#include <set>
+#include <stdexcept>
+#include "gtest/gtest.h"
+#include "SyntheticSource.hpp"
+
+using namespace IMT;
+
+class SyntheticSourceTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+
+  static bool IsEqual(const Picture& p1, const Picture& p2)
+  {
+    if (p1.GetMat().rows != p2.GetMat().rows || p1.GetMat().cols != p2.GetMat().cols)
+    {
+      return false;
+    }
+    for (int j = 0; j < p1.GetMat().rows; ++j)
+    {
+      for (int i = 0; i < p1.GetMat().cols; ++i)
+      {
+        if (p1.GetPixel(CoordI(i, j)) != p2.GetPixel(CoordI(i, j)))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  static const unsigned int width = 256;
+  static const unsigned int height = 128;
+};
+const unsigned int SyntheticSourceTest::width;
+const unsigned int SyntheticSourceTest::height;
+
+
+TEST_F(SyntheticSourceTest, parseContent)
+{
+  EXPECT_EQ(SyntheticSource::Content::GRADIENT, SyntheticSource::ParseContent("gradient"));
+  EXPECT_EQ(SyntheticSource::Content::CHECKERBOARD, SyntheticSource::ParseContent("checkerboard"));
+  EXPECT_EQ(SyntheticSource::Content::NOISE, SyntheticSource::ParseContent("noise"));
+  EXPECT_THROW(SyntheticSource::ParseContent("sinus"), std::invalid_argument);
+  EXPECT_THROW(SyntheticSource::ParseContent(""), std::invalid_argument);
+}
+
+TEST_F(SyntheticSourceTest, emptyResolution)
+{
+  EXPECT_THROW(SyntheticSource(SyntheticSource::Content::GRADIENT, 0, height), std::invalid_argument);
+  EXPECT_THROW(SyntheticSource(SyntheticSource::Content::GRADIENT, width, 0), std::invalid_argument);
+}
+
+TEST_F(SyntheticSourceTest, deterministic)
+{
+  for (auto content: {SyntheticSource::Content::GRADIENT, SyntheticSource::Content::CHECKERBOARD, SyntheticSource::Content::NOISE})
+  {
+    SyntheticSource source1(content, width, height);
+    SyntheticSource source2(content, width, height);
+    EXPECT_EQ(width, source1.GetWidth());
+    EXPECT_EQ(height, source1.GetHeight());
+    for (int frameId: {0, 1, 7, 100})
+    {
+      auto frame = source1.GetFrame(frameId);
+      EXPECT_TRUE(IsEqual(*frame, *source1.GetFrame(frameId)));
+      EXPECT_TRUE(IsEqual(*frame, *source2.GetFrame(frameId)));
+    }
+  }
+}
+
+TEST_F(SyntheticSourceTest, gradient)
+{
+  SyntheticSource source(SyntheticSource::Content::GRADIENT, width, height);
+  auto frame = source.GetFrame(0);
+  for (unsigned int j = 0; j < height; j += 7)
+  {
+    for (unsigned int i = 0; i < width; i += 5)
+    {
+      ASSERT_EQ(Pixel(255*i/width, 255*j/height, 255-255*(i+j)/(width+height)), frame->GetPixel(CoordI(i, j)));
+    }
+  }
+}
+
+TEST_F(SyntheticSourceTest, checkerboard)
+{
+  SyntheticSource source(SyntheticSource::Content::CHECKERBOARD, width, height);
+  auto frame = source.GetFrame(0);
+  //64x64 squares, white in the top left corner
+  EXPECT_EQ(Pixel(255, 255, 255), frame->GetPixel(CoordI(0, 0)));
+  EXPECT_EQ(Pixel(255, 255, 255), frame->GetPixel(CoordI(63, 63)));
+  EXPECT_EQ(Pixel(0, 0, 0), frame->GetPixel(CoordI(64, 0)));
+  EXPECT_EQ(Pixel(0, 0, 0), frame->GetPixel(CoordI(0, 64)));
+  EXPECT_EQ(Pixel(255, 255, 255), frame->GetPixel(CoordI(64, 64)));
+  EXPECT_EQ(Pixel(0, 0, 0), frame->GetPixel(CoordI(255, 63)));
+  EXPECT_EQ(Pixel(255, 255, 255), frame->GetPixel(CoordI(255, 127)));
+}
+
+TEST_F(SyntheticSourceTest, noise)
+{
+  SyntheticSource source(SyntheticSource::Content::NOISE, width, height);
+  auto frame = source.GetFrame(0);
+  std::set<unsigned char> values;
+  for (unsigned int j = 0; j < height; ++j)
+  {
+    for (unsigned int i = 0; i < width; ++i)
+    {
+      auto p = frame->GetPixel(CoordI(i, j));
+      values.insert({p[0], p[1], p[2]});
+    }
+  }
+  //uniform noise: almost all the byte values are used
+  EXPECT_GT(values.size(), 250u);
+}
+
+TEST_F(SyntheticSourceTest, circularShift)
+{
+  SyntheticSource source(SyntheticSource::Content::GRADIENT, width, height);
+  auto frame0 = source.GetFrame(0);
+  auto frame1 = source.GetFrame(1);
+  //the pattern moves 8 columns to the right per frame, the last columns go to the left
+  for (unsigned int j = 0; j < height; j += 9)
+  {
+    for (unsigned int i = 0; i < width-8; ++i)
+    {
+      ASSERT_EQ(frame0->GetPixel(CoordI(i, j)), frame1->GetPixel(CoordI(i+8, j)));
+    }
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+      ASSERT_EQ(frame0->GetPixel(CoordI(width-8+i, j)), frame1->GetPixel(CoordI(i, j)));
+    }
+  }
+  EXPECT_FALSE(IsEqual(*frame0, *frame1));
+  //a full turn gives back the first frame
+  EXPECT_TRUE(IsEqual(*frame0, *source.GetFrame(width/8)));
+}
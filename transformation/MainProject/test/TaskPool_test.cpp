@@ -0,0 +1,113 @@
+#include <stdexcept>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include "gtest/gtest.h"
+#include "TaskPool.hpp"
+
+using namespace IMT;
+
+class TaskPoolTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {}
+
+  virtual void TearDown()
+  {}
+};
+
+
+TEST_F(TaskPoolTest, eachIndexOnce)
+{
+  TaskPool pool(4);
+  for (size_t grain: {1, 3, 64, 1000})
+  {
+    std::vector<std::atomic<int>> counts(1000);
+    for (auto& c: counts) {c = 0;}
+    pool.ParallelFor(0, counts.size(), grain, [&](size_t first, size_t last)
+    {
+      ASSERT_LE(last-first, grain);
+      for (size_t i = first; i < last; ++i) {++counts[i];}
+    });
+    for (auto& c: counts)
+    {
+      ASSERT_EQ(1, c);
+    }
+  }
+  //empty range
+  pool.ParallelFor(5, 5, 1, [](size_t, size_t) {FAIL();});
+}
+
+TEST_F(TaskPoolTest, nestedLoops)
+{
+  TaskPool pool(3);
+  std::atomic<long> sum(0);
+  pool.ParallelFor(0, 20, 1, [&](size_t first, size_t last)
+  {
+    for (size_t i = first; i < last; ++i)
+    {
+      pool.ParallelFor(0, 100, 7, [&](size_t f, size_t l) {sum += l-f;});
+    }
+  });
+  ASSERT_EQ(2000, sum);
+}
+
+TEST_F(TaskPoolTest, maxThreads)
+{
+  TaskPool pool(8);
+  std::atomic<int> running(0);
+  std::atomic<int> maxRunning(0);
+  pool.ParallelFor(0, 200, 1, [&](size_t, size_t)
+  {
+    int r = ++running;
+    int m = maxRunning;
+    while (r > m && !maxRunning.compare_exchange_weak(m, r)) {}
+    volatile double x = 0;
+    for (int k = 0; k < 20000; ++k) {x += k;}
+    --running;
+  }, 2);
+  ASSERT_LE(maxRunning, 2);
+}
+
+TEST_F(TaskPoolTest, exceptionPropagated)
+{
+  TaskPool pool(4);
+  ASSERT_THROW(pool.ParallelFor(0, 100, 1, [](size_t first, size_t)
+  {
+    if (first == 42) {throw std::runtime_error("error in a chunk");}
+  }), std::runtime_error);
+  //the pool is still usable
+  std::atomic<int> n(0);
+  pool.ParallelFor(0, 10, 1, [&](size_t, size_t) {++n;});
+  ASSERT_EQ(10, n);
+}
+
+TEST_F(TaskPoolTest, failedTaskCounted)
+{
+  TaskPool pool(2);
+  ASSERT_EQ(0u, pool.GetNbUnpinnedWorkers());
+  pool.Submit([]() {throw std::runtime_error("error in a task");});
+  for (int k = 0; k < 1000 && pool.GetNbFailedTasks() == 0; ++k)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1u, pool.GetNbFailedTasks());
+}
+
+TEST_F(TaskPoolTest, reduceInChunkOrder)
+{
+  TaskPool pool(4);
+  std::vector<double> values(10000);
+  for (size_t i = 0; i < values.size(); ++i) {values[i] = 1.0/(i+1);}
+  auto sumChunks = [&](size_t first, size_t last) {double s = 0; for (size_t i = first; i < last; ++i) {s += values[i];} return s;};
+  auto add = [](double a, double b) {return a+b;};
+  double expected = 0;
+  for (size_t first = 0; first < values.size(); first += 37) {expected += sumChunks(first, std::min(first+37, values.size()));}
+  for (int run = 0; run < 5; ++run)
+  {//bitwise identical from one run to the other
+    ASSERT_EQ(expected, pool.ParallelReduce(0, values.size(), 37, 0.0, sumChunks, add));
+  }
+  ASSERT_EQ(size_t(1), TaskPool::GetGrain(1000000));
+}
@@ -0,0 +1,159 @@
+#include <memory>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "TransJob.hpp"
+#include "PicturePool.hpp"
+
+using namespace IMT;
+
+class TransJobTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    config.put("Global.layoutFlow", "[[\"input.mp4\", \"Equirectangular\", \"Equirectangular\"], [\"input.mp4\", \"Equirectangular\", \"EquirectangularHalf\"]]");
+    config.put("Global.qualityToComputeList", "[\"PSNR\", \"SSIM\"]");
+    config.put("Global.videoOutputName", "");
+    config.put("Global.qualityOutputName", "");
+    config.put("Global.displayFinalPict", false);
+    config.put("Global.nbFrames", 2);
+    config.put("Global.startFrame", 0);
+    config.put("Global.videoOutputBitRate", 0);
+    config.put("Global.fps", 24);
+    config.put("Global.syntheticInput", "gradient");
+    config.put("Equirectangular.type", "equirectangular");
+    config.put("Equirectangular.refWidth", 200);
+    config.put("Equirectangular.refHeight", 100);
+    config.put("Equirectangular.relativeResolution", true);
+    config.put("Equirectangular.width", 1);
+    config.put("Equirectangular.height", 1);
+    config.put("EquirectangularHalf.type", "equirectangular");
+    config.put("EquirectangularHalf.relativeResolution", true);
+    config.put("EquirectangularHalf.width", 0.5);
+    config.put("EquirectangularHalf.height", 0.5);
+  }
+
+  virtual void TearDown()
+  {}
+
+  TransJob::Config config;
+};
+
+
+TEST_F(TransJobTest, pushFrames)
+{
+  TransJob job(config);
+  ASSERT_EQ(2u, job.GetNbFlows());
+  ASSERT_EQ(std::vector<std::string>({"SSIM", "PSNR"}), job.GetQualityNames());
+  ASSERT_EQ(100u, job.GetOutputLayout(1).GetWidth());
+
+  std::vector<int> measuredFrames;
+  job.SetQualityCallback([&](int frameId, unsigned int flowId, const std::vector<std::string>& qualityNames, const std::vector<double>& quality)
+  {
+    ASSERT_EQ(1u, flowId);
+    ASSERT_EQ(qualityNames.size(), quality.size());
+    measuredFrames.push_back(frameId);
+  });
+  auto input = PicturePool::GetDefault()->Get(job.GetInputLayout(0).GetHeight(), job.GetInputLayout(0).GetWidth(), CV_8UC3);
+  for (int frameId = 0; frameId < 3; ++frameId)
+  {
+    auto outputs = job.ProcessFrame(frameId, {input, input});
+    ASSERT_EQ(size_t(2), outputs.size());
+    ASSERT_EQ(200, outputs[0]->GetWidth());
+    ASSERT_EQ(50, outputs[1]->GetHeight());
+  }
+  ASSERT_EQ(std::vector<int>({0, 1, 2}), measuredFrames);
+  ASSERT_EQ(3, job.GetNbProcessedFrames());
+  //one input picture per flow
+  ASSERT_THROW(job.ProcessFrame(3, {input}), std::invalid_argument);
+}
+
+TEST_F(TransJobTest, runSynthetic)
+{
+  TransJob job(config);
+  int nbOutputFrames = 0;
+  job.SetOutputCallback([&](int, const FramePipeline::FramePictures& outputPicts)
+  {
+    ASSERT_EQ(size_t(2), outputPicts.size());
+    ++nbOutputFrames;
+  });
+  job.Run();
+  ASSERT_EQ(2, nbOutputFrames);
+}
+
+TEST_F(TransJobTest, computeShards)
+{
+  typedef std::vector<std::pair<unsigned int, unsigned int>> Shards;
+  //9 GOPs of 12 frames (the last one has 4 frames)
+  ASSERT_EQ(Shards({{0, 24}, {24, 24}, {48, 24}, {72, 28}}), TransJob::ComputeShards(0, 100, 1, 12, 4));
+  //one processed frame every 2 frames: 25 output frames in 5 GOPs
+  ASSERT_EQ(Shards({{10, 20}, {30, 30}}), TransJob::ComputeShards(10, 50, 2, 5, 2));
+  //not more shards than GOPs
+  ASSERT_EQ(Shards({{0, 10}}), TransJob::ComputeShards(0, 10, 1, 12, 8));
+  ASSERT_TRUE(TransJob::ComputeShards(0, 0, 1, 12, 4).empty());
+}
+
+TEST_F(TransJobTest, shardPath)
+{
+  ASSERT_EQ("out/video_shard1_.mp4", TransJob::GetShardPath("out/video.mp4", 0));
+  ASSERT_EQ("quality_shard3_", TransJob::GetShardPath("quality", 2));
+  //the dot of the directory is not an extension
+  ASSERT_EQ("out.d/quality_shard2_", TransJob::GetShardPath("out.d/quality", 1));
+  ASSERT_EQ("", TransJob::GetShardPath("", 0));
+}
+
+TEST_F(TransJobTest, concatenateFiles)
+{
+  const std::string prefix = "/tmp/trans_TransJob_test_"+std::to_string(getpid());
+  const std::vector<std::string> inputPaths = {prefix+"_shard1.txt", prefix+"_shard2.txt", prefix+"_missing.txt", prefix+"_shard3.txt"};
+  const std::string outputPath = prefix+"_output.txt";
+  std::ofstream(inputPaths[0]) << "PSNR SSIM" << std::endl << "0 40 0.9" << std::endl << "1 41 0.9" << std::endl;
+  std::ofstream(inputPaths[1]) << "PSNR SSIM" << std::endl << "2 42 0.9" << std::endl;
+  std::ofstream(inputPaths[3]) << "PSNR SSIM" << std::endl;
+  TransJob::ConcatenateFiles(inputPaths, outputPath, 1);
+  std::ifstream output(outputPath);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(output, line))
+  {
+    lines.push_back(line);
+  }
+  for (const auto& path: inputPaths)
+  {
+    std::remove(path.c_str());
+  }
+  std::remove(outputPath.c_str());
+  ASSERT_EQ(std::vector<std::string>({"PSNR SSIM", "0 40 0.9", "1 41 0.9", "2 42 0.9"}), lines);
+  ASSERT_THROW(TransJob::ConcatenateFiles(inputPaths, prefix+"_missing_dir/output.txt", 1), std::invalid_argument);
+}
+
+TEST_F(TransJobTest, shardsNotSupported)
+{//the synthetic input is processed by one job
+  config.put("Global.nbShards", 2);
+  config.put("Global.nbFrames", 48);
+  TransJob job(config);
+  int nbOutputFrames = 0;
+  job.SetOutputCallback([&](int, const FramePipeline::FramePictures&) {++nbOutputFrames;});
+  job.Run();
+  ASSERT_EQ(48, nbOutputFrames);
+}
+
+TEST_F(TransJobTest, invalidConfig)
+{
+  config.put("Global.layoutFlow", "[[\"input.mp4\", ");
+  ASSERT_THROW(TransJob job(config), std::invalid_argument);
+}
+
+TEST_F(TransJobTest, missingKey)
+{
+  config.get_child("Global").erase("fps");
+  ASSERT_THROW(TransJob job(config), std::invalid_argument);
+  config.put("Global.fps", "fast");
+  ASSERT_THROW(TransJob job(config), std::invalid_argument);
+  //missing key of a layout section
+  config.put("Global.fps", 24);
+  config.get_child("Equirectangular").erase("refWidth");
+  ASSERT_THROW(TransJob job(config), std::invalid_argument);
+}
@@ -2,6 +2,8 @@
 #include "gtest/gtest.h"
 #include "Vector.hpp"
 #include "Common.hpp"
+#include "VectorBatch.hpp"
+#include <cstring>
 
 using namespace IMT;
 
@@ -67,3 +69,36 @@ TEST_F(VectorTest, vectorialProduct)
 {
   ASSERT_EQ(VectorCartesian(-13,8,-1), VectorCartesian(1,2,3) ^ VectorCartesian(3,5,1));
 }
+
+TEST_F(VectorTest, plainValueType)
+{
+  ASSERT_TRUE(std::is_trivially_copyable<VectorCartesian>::value);
+  ASSERT_EQ(3*sizeof(SCALAR), sizeof(VectorCartesian));
+  VectorCartesian v[2] = {VectorCartesian(1,2,3), VectorCartesian()};
+  std::memcpy(&v[1], &v[0], sizeof(VectorCartesian));
+  ASSERT_EQ(v[0], v[1]);
+}
+
+TEST_F(VectorTest, batchRotation)
+{
+  auto q = Quaternion::QuaternionFromAngleAxis(PI()/3, VectorCartesian(1, -1, 2));
+  VectorBatch batch(3);
+  batch.Set(0, VectorCartesian(1, 0, 0));
+  batch.Set(1, VectorCartesian(0.5, 2, -1));
+  batch.Set(2, VectorCartesian(0, 0, 0));
+  Rotation(batch, RotMat::FromQuaternion(q));
+  ASSERT_LT((batch.Get(0) - q.Rotation(VectorCartesian(1, 0, 0))).Norm(), 1e-12);
+  ASSERT_LT((batch.Get(1) - q.Rotation(VectorCartesian(0.5, 2, -1))).Norm(), 1e-12);
+  Normalize(batch);
+  ASSERT_LT(std::abs(batch.Get(1).Norm() - 1), 1e-12);
+  ASSERT_EQ(VectorCartesian(0, 0, 0), batch.Get(2));
+}
+
+TEST_F(VectorTest, cartesianAngles)
+{
+  VectorCartesian v(42,-21,13);
+  VectorSpherical s(v);
+  ASSERT_LT(std::abs(s.GetTheta() - v.GetTheta()), 1e-12);
+  ASSERT_LT(std::abs(s.GetPhi() - v.GetPhi()), 1e-12);
+  ASSERT_LT(std::abs(s.GetPhi() - (2*v).GetPhi()), 1e-12);
+}
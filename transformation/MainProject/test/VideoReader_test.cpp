@@ -0,0 +1,64 @@
+#include <fstream>
+#include <string>
+#include "gtest/gtest.h"
+#include "VideoReader.hpp"
+
+using namespace IMT::LibAv;
+
+class VideoReaderTest: public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {//example video of the repository
+    const std::string testFile = __FILE__;
+    pathToVideo = testFile.substr(0, testFile.find_last_of("/"))+"/../../examples/input.mp4";
+  }
+
+  virtual void TearDown()
+  {}
+
+  /** The frames of the example video are read only if it is available */
+  bool HasVideo(void) const
+  {
+    return std::ifstream(pathToVideo).good();
+  }
+
+  std::string pathToVideo;
+};
+
+
+TEST_F(VideoReaderTest, seekNotInitialized)
+{
+  VideoReader reader(pathToVideo);
+  ASSERT_FALSE(reader.Seek(0));
+}
+
+TEST_F(VideoReaderTest, seekMatchesSequentialRead)
+{
+  if (!HasVideo())
+  {
+    return;
+  }
+  const unsigned int targetFrame = 10;
+  VideoReader sequentialReader(pathToVideo);
+  sequentialReader.Init(targetFrame+1);
+  std::vector<std::shared_ptr<cv::Mat>> sequentialPicts;
+  for (unsigned int frameId = 0; frameId <= targetFrame; ++frameId)
+  {
+    sequentialPicts.push_back(sequentialReader.GetNextPicture(0));
+    ASSERT_NE(nullptr, sequentialPicts.back());
+  }
+
+  VideoReader seekReader(pathToVideo);
+  seekReader.Init(targetFrame+1);
+  ASSERT_TRUE(seekReader.Seek(targetFrame));
+  auto pict = seekReader.GetNextPicture(0);
+  ASSERT_NE(nullptr, pict);
+  ASSERT_EQ(0, cv::norm(*sequentialPicts[targetFrame], *pict, cv::NORM_INF));
+
+  //seek backward to the first frame
+  ASSERT_TRUE(seekReader.Seek(0));
+  pict = seekReader.GetNextPicture(0);
+  ASSERT_NE(nullptr, pict);
+  ASSERT_EQ(0, cv::norm(*sequentialPicts[0], *pict, cv::NORM_INF));
+}